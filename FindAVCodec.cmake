@@ -0,0 +1,52 @@
+# Copyright (C) 2022  DIT638 Group 4
+#
+# You may redistribute this program and/or modify it under the terms of
+# the GNU General Public License as published by the Free Software Foundation,
+# either version 3 of the License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Finds libavcodec and libavutil from FFmpeg (libavcodec-dev on Ubuntu) and sets
+# AVCODEC_FOUND, AVCODEC_INCLUDE_DIR and AVCODEC_LIBRARIES.
+
+if(NOT AVCODEC_FOUND)
+
+    find_path(AVCODEC_INCLUDE_DIR
+        NAMES
+            libavcodec/avcodec.h
+        PATHS
+            ${AVCODECDIR}/include/
+            /usr/include/
+            /usr/local/include/
+    )
+
+    find_library(AVCODEC_LIBRARY avcodec
+        PATHS
+            ${AVCODECDIR}/lib/
+    )
+
+    find_library(AVUTIL_LIBRARY avutil
+        PATHS
+            ${AVCODECDIR}/lib/
+    )
+
+    if (AVCODEC_INCLUDE_DIR AND AVCODEC_LIBRARY AND AVUTIL_LIBRARY)
+        set (AVCODEC_FOUND TRUE)
+        set (AVCODEC_LIBRARIES ${AVCODEC_LIBRARY} ${AVUTIL_LIBRARY})
+    endif (AVCODEC_INCLUDE_DIR AND AVCODEC_LIBRARY AND AVUTIL_LIBRARY)
+
+    if (AVCODEC_FOUND)
+        message(STATUS "Found libavcodec: ${AVCODEC_INCLUDE_DIR}, ${AVCODEC_LIBRARIES}")
+    else (AVCODEC_FOUND)
+        if (AVCodec_FIND_REQUIRED)
+            message (FATAL_ERROR "Could not find libavcodec, try to setup AVCODECDIR accordingly")
+        endif (AVCodec_FIND_REQUIRED)
+    endif (AVCODEC_FOUND)
+
+endif (NOT AVCODEC_FOUND)
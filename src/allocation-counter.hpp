@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALLOCATION_COUNTER_HPP
+#define ALLOCATION_COUNTER_HPP
+
+#include <cstdint>
+
+// Number of heap allocations the calling thread has made so far.
+// Only available when the executable is built with -D WITH_ALLOCATION_COUNTER=ON, which links
+// allocation-counter.cpp and its replacements of the global operator new and (on glibc) malloc.
+uint64_t threadAllocations();
+
+#endif
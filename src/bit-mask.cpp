@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bit-mask.hpp"
+#include "cpu-dispatch.hpp"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+const uint64_t allBits = ~static_cast<uint64_t>(0);
+
+// Erosion keeps a pixel if all of its neighbors are set, dilation sets it if any of them is
+template <bool ERODE> inline uint64_t combine(uint64_t a, uint64_t b)
+{
+    return ERODE ? (a & b) : (a | b);
+}
+
+template <bool ERODE> void morphRowScalar(const uint64_t *above, const uint64_t *row, const uint64_t *below, int words, uint64_t *out)
+{
+    // Combine the three rows first; the horizontal neighbors of the result are then one bit to the left and right
+    uint64_t previous{combine<ERODE>(combine<ERODE>(above[-1], row[-1]), below[-1])};
+    uint64_t current{combine<ERODE>(combine<ERODE>(above[0], row[0]), below[0])};
+    for (int j = 0; j < words; j++)
+    {
+        const uint64_t next{combine<ERODE>(combine<ERODE>(above[j + 1], row[j + 1]), below[j + 1])};
+        const uint64_t left{(current << 1) | (previous >> 63)};
+        const uint64_t right{(current >> 1) | (next << 63)};
+        out[j] = combine<ERODE>(combine<ERODE>(current, left), right);
+        previous = current;
+        current = next;
+    }
+}
+
+// Sum of the indices of the set bits of a word: every bit of the index contributes its weight once per set bit
+// whose index has it
+inline uint64_t bitIndexSum(uint64_t word)
+{
+    return static_cast<uint64_t>(__builtin_popcountll(word & 0xaaaaaaaaaaaaaaaaull)) + 2 * static_cast<uint64_t>(__builtin_popcountll(word & 0xccccccccccccccccull)) +
+           4 * static_cast<uint64_t>(__builtin_popcountll(word & 0xf0f0f0f0f0f0f0f0ull)) + 8 * static_cast<uint64_t>(__builtin_popcountll(word & 0xff00ff00ff00ff00ull)) +
+           16 * static_cast<uint64_t>(__builtin_popcountll(word & 0xffff0000ffff0000ull)) + 32 * static_cast<uint64_t>(__builtin_popcountll(word & 0xffffffff00000000ull));
+}
+} // namespace
+
+void maskPackRowScalar(const uint8_t *bytes, int width, uint64_t *bits)
+{
+    for (int begin = 0; begin < width; begin += 64)
+    {
+        const int end{std::min(width, begin + 64)};
+        uint64_t word{0};
+        for (int x = begin; x < end; x++)
+        {
+            word |= static_cast<uint64_t>(bytes[x] != 0) << (x - begin);
+        }
+        bits[begin / 64] = word;
+    }
+}
+
+void maskErodeRowScalar(const uint64_t *above, const uint64_t *row, const uint64_t *below, int words, uint64_t *out)
+{
+    morphRowScalar<true>(above, row, below, words, out);
+}
+
+void maskDilateRowScalar(const uint64_t *above, const uint64_t *row, const uint64_t *below, int words, uint64_t *out)
+{
+    morphRowScalar<false>(above, row, below, words, out);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+namespace
+{
+template <bool ERODE> __attribute__((target("sse4.1"))) inline __m128i combine(__m128i a, __m128i b)
+{
+    return ERODE ? _mm_and_si128(a, b) : _mm_or_si128(a, b);
+}
+
+template <bool ERODE> __attribute__((target("sse4.1"))) inline __m128i combineRows(const uint64_t *above, const uint64_t *row, const uint64_t *below, int j)
+{
+    return combine<ERODE>(combine<ERODE>(_mm_loadu_si128(reinterpret_cast<const __m128i *>(above + j)), _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + j))),
+                          _mm_loadu_si128(reinterpret_cast<const __m128i *>(below + j)));
+}
+
+template <bool ERODE> __attribute__((target("sse4.1"))) void morphRowSse41(const uint64_t *above, const uint64_t *row, const uint64_t *below, int words, uint64_t *out)
+{
+    int j = 0;
+    for (; j + 2 <= words; j += 2)
+    {
+        // The words one to the left and one to the right supply the bits that are shifted in at the word edges
+        const __m128i current = combineRows<ERODE>(above, row, below, j);
+        const __m128i previous = combineRows<ERODE>(above, row, below, j - 1);
+        const __m128i next = combineRows<ERODE>(above, row, below, j + 1);
+        const __m128i left = _mm_or_si128(_mm_slli_epi64(current, 1), _mm_srli_epi64(previous, 63));
+        const __m128i right = _mm_or_si128(_mm_srli_epi64(current, 1), _mm_slli_epi64(next, 63));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + j), combine<ERODE>(combine<ERODE>(current, left), right));
+    }
+    morphRowScalar<ERODE>(above + j, row + j, below + j, words - j, out + j);
+}
+
+template <bool ERODE> __attribute__((target("avx2"))) inline __m256i combine(__m256i a, __m256i b)
+{
+    return ERODE ? _mm256_and_si256(a, b) : _mm256_or_si256(a, b);
+}
+
+template <bool ERODE> __attribute__((target("avx2"))) inline __m256i combineRows256(const uint64_t *above, const uint64_t *row, const uint64_t *below, int j)
+{
+    return combine<ERODE>(combine<ERODE>(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(above + j)), _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + j))),
+                          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(below + j)));
+}
+
+template <bool ERODE> __attribute__((target("avx2"))) void morphRowAvx2(const uint64_t *above, const uint64_t *row, const uint64_t *below, int words, uint64_t *out)
+{
+    int j = 0;
+    for (; j + 4 <= words; j += 4)
+    {
+        // The words one to the left and one to the right supply the bits that are shifted in at the word edges
+        const __m256i current = combineRows256<ERODE>(above, row, below, j);
+        const __m256i previous = combineRows256<ERODE>(above, row, below, j - 1);
+        const __m256i next = combineRows256<ERODE>(above, row, below, j + 1);
+        const __m256i left = _mm256_or_si256(_mm256_slli_epi64(current, 1), _mm256_srli_epi64(previous, 63));
+        const __m256i right = _mm256_or_si256(_mm256_srli_epi64(current, 1), _mm256_slli_epi64(next, 63));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + j), combine<ERODE>(combine<ERODE>(current, left), right));
+    }
+    morphRowScalar<ERODE>(above + j, row + j, below + j, words - j, out + j);
+}
+} // namespace
+
+__attribute__((target("sse4.1"))) void maskPackRowSse41(const uint8_t *bytes, int width, uint64_t *bits)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 64 <= width; x += 64)
+    {
+        // One bit per byte that is not zero, sixteen bytes at a time
+        uint64_t word{0};
+        for (int i = 0; i < 4; i++)
+        {
+            const __m128i isZero = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + x + 16 * i)), zero);
+            word |= static_cast<uint64_t>(~_mm_movemask_epi8(isZero) & 0xffff) << (16 * i);
+        }
+        bits[x / 64] = word;
+    }
+    maskPackRowScalar(bytes + x, width - x, bits + x / 64);
+}
+
+__attribute__((target("sse4.1"))) void maskErodeRowSse41(const uint64_t *above, const uint64_t *row, const uint64_t *below, int words, uint64_t *out)
+{
+    morphRowSse41<true>(above, row, below, words, out);
+}
+
+__attribute__((target("sse4.1"))) void maskDilateRowSse41(const uint64_t *above, const uint64_t *row, const uint64_t *below, int words, uint64_t *out)
+{
+    morphRowSse41<false>(above, row, below, words, out);
+}
+
+__attribute__((target("avx2"))) void maskPackRowAvx2(const uint8_t *bytes, int width, uint64_t *bits)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    int x = 0;
+    for (; x + 64 <= width; x += 64)
+    {
+        // One bit per byte that is not zero, 32 bytes at a time
+        const __m256i low = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + x)), zero);
+        const __m256i high = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + x + 32)), zero);
+        const uint64_t zeros{static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(low))) | (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(high))) << 32)};
+        bits[x / 64] = ~zeros;
+    }
+    maskPackRowScalar(bytes + x, width - x, bits + x / 64);
+}
+
+__attribute__((target("avx2"))) void maskErodeRowAvx2(const uint64_t *above, const uint64_t *row, const uint64_t *below, int words, uint64_t *out)
+{
+    morphRowAvx2<true>(above, row, below, words, out);
+}
+
+__attribute__((target("avx2"))) void maskDilateRowAvx2(const uint64_t *above, const uint64_t *row, const uint64_t *below, int words, uint64_t *out)
+{
+    morphRowAvx2<false>(above, row, below, words, out);
+}
+#endif
+
+BitMask::BitMask()
+    : m_width(0)
+    , m_height(0)
+    , m_words(0)
+    , m_stride(2)
+    , m_tail(allBits)
+    , m_bits(2 * m_stride, 0)
+{
+}
+
+void BitMask::resize(int width, int height)
+{
+    m_width = width;
+    m_height = height;
+    m_words = (width + 63) / 64;
+    m_stride = static_cast<size_t>(m_words) + 2;
+    m_tail = ((width % 64) == 0) ? allBits : (static_cast<uint64_t>(1) << (width % 64)) - 1;
+    // Shrinking keeps the capacity, so growing back up to the largest size so far does not allocate
+    m_bits.resize(static_cast<size_t>(height + 2) * m_stride);
+}
+
+void BitMask::fillBorder(bool set)
+{
+    const uint64_t value{set ? allBits : 0};
+    std::fill(m_bits.begin(), m_bits.begin() + static_cast<ptrdiff_t>(m_stride), value);
+    std::fill(m_bits.end() - static_cast<ptrdiff_t>(m_stride), m_bits.end(), value);
+    for (int y = 0; y < m_height; y++)
+    {
+        uint64_t *words = rowData(y);
+        words[-1] = value;
+        words[m_words] = value;
+        if (m_words > 0)
+        {
+            words[m_words - 1] = set ? (words[m_words - 1] | ~m_tail) : (words[m_words - 1] & m_tail);
+        }
+    }
+}
+
+void BitMask::pack(const cv::Mat &mask)
+{
+    CV_Assert(mask.type() == CV_8UC1);
+    resize(mask.cols, mask.rows);
+    const MaskPackRow kernel{visionKernels().maskPackRow};
+    for (int y = 0; y < m_height; y++)
+    {
+        kernel(mask.ptr<uint8_t>(y), m_width, rowData(y));
+    }
+    fillBorder(false);
+}
+
+void BitMask::unpack(cv::Mat &mask) const
+{
+    mask.create(m_height, m_width, CV_8UC1);
+    for (int y = 0; y < m_height; y++)
+    {
+        const uint64_t *words = row(y);
+        uint8_t *out = mask.ptr<uint8_t>(y);
+        for (int x = 0; x < m_width; x++)
+        {
+            out[x] = ((words[x / 64] >> (x % 64)) & 1) ? 255 : 0;
+        }
+    }
+}
+
+void BitMask::morph(MaskMorphRow kernel, BitMask &dst) const
+{
+    dst.resize(m_width, m_height);
+    for (int y = 0; y < m_height; y++)
+    {
+        kernel(row(y - 1), row(y), row(y + 1), m_words, dst.rowData(y));
+    }
+    dst.fillBorder(false);
+}
+
+void BitMask::erode(BitMask &dst)
+{
+    // Pixels outside of the mask count as set, so the border does not eat into the mask
+    fillBorder(true);
+    morph(visionKernels().maskErodeRow, dst);
+    fillBorder(false);
+}
+
+void BitMask::dilate(BitMask &dst)
+{
+    morph(visionKernels().maskDilateRow, dst);
+}
+
+void BitMask::open(BitMask &scratch)
+{
+    erode(scratch);
+    scratch.dilate(*this);
+}
+
+MaskMoments BitMask::moments() const
+{
+    uint64_t area{0}, sumX{0}, sumY{0};
+    for (int y = 0; y < m_height; y++)
+    {
+        const uint64_t *words = row(y);
+        uint64_t rowArea{0};
+        for (int j = 0; j < m_words; j++)
+        {
+            const uint64_t count{static_cast<uint64_t>(__builtin_popcountll(words[j]))};
+            rowArea += count;
+            sumX += 64 * static_cast<uint64_t>(j) * count + bitIndexSum(words[j]);
+        }
+        area += rowArea;
+        sumY += static_cast<uint64_t>(y) * rowArea;
+    }
+    if (area == 0)
+    {
+        return MaskMoments{0, cv::Point2f()};
+    }
+    return MaskMoments{area, cv::Point2f(static_cast<float>(static_cast<double>(sumX) / static_cast<double>(area)), static_cast<float>(static_cast<double>(sumY) / static_cast<double>(area)))};
+}
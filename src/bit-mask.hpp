@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BIT_MASK_HPP
+#define BIT_MASK_HPP
+
+#include <opencv2/core/core.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// Kernel that packs a row of a CV_8UC1 mask into bits; bit i of word j is pixel 64 * j + i, set for non-zero pixels
+typedef void (*MaskPackRow)(const uint8_t *bytes, int width, uint64_t *bits);
+// Kernel that erodes or dilates one row of packed bits with a 3x3 square. above, row and below point to the first
+// word of their rows; the word in front of and behind every row must be readable.
+typedef void (*MaskMorphRow)(const uint64_t *above, const uint64_t *row, const uint64_t *below, int words, uint64_t *out);
+
+// Portable reference kernels
+void maskPackRowScalar(const uint8_t *bytes, int width, uint64_t *bits);
+void maskErodeRowScalar(const uint64_t *above, const uint64_t *row, const uint64_t *below, int words, uint64_t *out);
+void maskDilateRowScalar(const uint64_t *above, const uint64_t *row, const uint64_t *below, int words, uint64_t *out);
+#if defined(__x86_64__) || defined(__i386__)
+// Kernels processing 16 (SSE4.1) or 32 (AVX2) mask bytes or 2 or 4 words per step; only call them when the CPU
+// supports the instruction set. BitMask picks one through visionKernels() in cpu-dispatch.hpp.
+void maskPackRowSse41(const uint8_t *bytes, int width, uint64_t *bits);
+void maskErodeRowSse41(const uint64_t *above, const uint64_t *row, const uint64_t *below, int words, uint64_t *out);
+void maskDilateRowSse41(const uint64_t *above, const uint64_t *row, const uint64_t *below, int words, uint64_t *out);
+void maskPackRowAvx2(const uint8_t *bytes, int width, uint64_t *bits);
+void maskErodeRowAvx2(const uint64_t *above, const uint64_t *row, const uint64_t *below, int words, uint64_t *out);
+void maskDilateRowAvx2(const uint64_t *above, const uint64_t *row, const uint64_t *below, int words, uint64_t *out);
+#endif
+
+// Number of set pixels of a mask and their mean position
+struct MaskMoments
+{
+    uint64_t area;
+    cv::Point2f centroid;
+};
+
+// Mask with one bit per pixel, an eighth of the memory of a CV_8UC1 mask. Every row is surrounded by a guard word on
+// both sides and the rows by a guard row above and below, so the morphology kernels need no special case at the
+// borders. The buffer only grows, so masks of changing sizes up to the largest one so far do not allocate.
+class BitMask
+{
+   public:
+    BitMask();
+
+    // Pack a CV_8UC1 mask (or a view of one)
+    void pack(const cv::Mat &mask);
+    // Unpack into a CV_8UC1 mask of 0 and 255 of the same size
+    void unpack(cv::Mat &mask) const;
+
+    // Erode or dilate into dst with a 3x3 square; like cv::erode and cv::dilate, the pixels outside of the mask
+    // neither erode nor dilate it. Erosion temporarily fills the guards of this mask.
+    void erode(BitMask &dst);
+    void dilate(BitMask &dst);
+    // Open in place (erode, then dilate) to remove specks and thin lines; the same as cv::morphologyEx(MORPH_OPEN)
+    // with a 3x3 square. scratch holds the eroded mask.
+    void open(BitMask &scratch);
+
+    // Area and centroid of the set pixels, counted a word at a time with popcount
+    MaskMoments moments() const;
+
+    int width() const
+    {
+        return m_width;
+    }
+
+    int height() const
+    {
+        return m_height;
+    }
+
+    int words() const
+    {
+        return m_words;
+    }
+
+    // Words of row y; the bits behind the width are always clear
+    const uint64_t *row(int y) const
+    {
+        return m_bits.data() + static_cast<size_t>(y + 1) * m_stride + 1;
+    }
+
+   private:
+    void resize(int width, int height);
+    // Set or clear the guard rows, the guard words and the bits behind the width
+    void fillBorder(bool set);
+    // Apply a morphology kernel to every row into dst and clear the bits behind the width
+    void morph(MaskMorphRow kernel, BitMask &dst) const;
+    uint64_t *rowData(int y)
+    {
+        return m_bits.data() + static_cast<size_t>(y + 1) * m_stride + 1;
+    }
+
+    int m_width;
+    int m_height;
+    int m_words;
+    size_t m_stride;
+    // Bits of the last word of a row that lie inside of the mask
+    uint64_t m_tail;
+    std::vector<uint64_t> m_bits;
+};
+
+#endif
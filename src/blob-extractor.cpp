@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "blob-extractor.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+// Index of the sentinel run that stands for the area around the image
+const int32_t outside = 0;
+// Marker in Run::leftGap for background runs
+const int32_t isGap = -2;
+
+inline uint64_t load64(const uint8_t *p)
+{
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+}
+} // namespace
+
+BlobExtractor::BlobExtractor()
+    : m_runs()
+    , m_parent()
+    , m_accumulators()
+    , m_blobs()
+{
+}
+
+int32_t BlobExtractor::find(int32_t run)
+{
+    // Path halving keeps the trees flat without recursion
+    while (m_parent[run] != run)
+    {
+        m_parent[run] = m_parent[m_parent[run]];
+        run = m_parent[run];
+    }
+    return run;
+}
+
+void BlobExtractor::unite(int32_t a, int32_t b)
+{
+    a = find(a);
+    b = find(b);
+    // The smaller index becomes the root, so the root of a component is always its first run in raster order
+    if (a < b)
+    {
+        m_parent[b] = a;
+    }
+    else if (b < a)
+    {
+        m_parent[a] = b;
+    }
+}
+
+void BlobExtractor::connect(int32_t previousBegin, int32_t previousEnd, int32_t currentBegin, int32_t currentEnd, int32_t reach)
+{
+    // Both rows are sorted by x, so one merge-like sweep visits every overlapping pair
+    int32_t i{previousBegin};
+    int32_t j{currentBegin};
+    while ((i < previousEnd) && (j < currentEnd))
+    {
+        const Run &previous = m_runs[static_cast<size_t>(i)];
+        const Run &current = m_runs[static_cast<size_t>(j)];
+        if ((previous.begin <= current.end + reach) && (current.begin <= previous.end + reach))
+        {
+            unite(i, j);
+        }
+        if (previous.end < current.end)
+        {
+            i++;
+        }
+        else
+        {
+            j++;
+        }
+    }
+}
+
+void BlobExtractor::reset()
+{
+    m_runs.clear();
+    m_parent.clear();
+    m_blobs.clear();
+    m_runs.push_back(Run{-1, 0, 0, isGap});
+    m_parent.push_back(outside);
+}
+
+void BlobExtractor::addRun(int32_t y, int32_t begin, int32_t end)
+{
+    m_parent.push_back(static_cast<int32_t>(m_runs.size()));
+    m_runs.push_back(Run{y, begin, end, -1});
+}
+
+void BlobExtractor::finishRow(int32_t y, int32_t width, int32_t height, int32_t runsBegin, RowSpans &previous)
+{
+    const int32_t runsEnd{static_cast<int32_t>(m_runs.size())};
+
+    // The gaps between the runs are the background; gaps touching the border belong to the outside
+    const int32_t gapsBegin{runsEnd};
+    int32_t x{0};
+    for (int32_t i = runsBegin; i <= runsEnd; i++)
+    {
+        const int32_t gapEnd{(i < runsEnd) ? m_runs[static_cast<size_t>(i)].begin - 1 : width - 1};
+        if (gapEnd >= x)
+        {
+            const int32_t gap{static_cast<int32_t>(m_runs.size())};
+            m_parent.push_back(gap);
+            m_runs.push_back(Run{y, x, gapEnd, isGap});
+            if ((y == 0) || (y == height - 1) || (x == 0) || (gapEnd == width - 1))
+            {
+                unite(gap, outside);
+            }
+            if (i < runsEnd)
+            {
+                m_runs[static_cast<size_t>(i)].leftGap = gap;
+            }
+        }
+        if (i < runsEnd)
+        {
+            x = m_runs[static_cast<size_t>(i)].end + 1;
+        }
+    }
+    const int32_t gapsEnd{static_cast<int32_t>(m_runs.size())};
+
+    // Foreground is 8-connected and background 4-connected, so the two never cross each other
+    connect(previous.runsBegin, previous.runsEnd, runsBegin, runsEnd, 1);
+    connect(previous.gapsBegin, previous.gapsEnd, gapsBegin, gapsEnd, 0);
+    previous = RowSpans{runsBegin, runsEnd, gapsBegin, gapsEnd};
+}
+
+const std::vector<Blob> &BlobExtractor::extract(const cv::Mat &mask, const cv::Point &offset)
+{
+    CV_Assert(mask.type() == CV_8UC1);
+
+    const int32_t width{mask.cols};
+    const int32_t height{mask.rows};
+    reset();
+    RowSpans previous{0, 0, 0, 0};
+    for (int32_t y = 0; y < height; y++)
+    {
+        const uint8_t *row = mask.ptr<uint8_t>(y);
+
+        // Encode the foreground of the row as runs, skipping eight background or foreground pixels at a time
+        const int32_t runsBegin{static_cast<int32_t>(m_runs.size())};
+        int32_t x{0};
+        while (x < width)
+        {
+            while ((x + 8 <= width) && (load64(row + x) == 0))
+            {
+                x += 8;
+            }
+            while ((x < width) && (row[x] == 0))
+            {
+                x++;
+            }
+            if (x >= width)
+            {
+                break;
+            }
+            const int32_t begin{x};
+            while ((x + 8 <= width) && (load64(row + x) == ~static_cast<uint64_t>(0)))
+            {
+                x += 8;
+            }
+            while ((x < width) && (row[x] != 0))
+            {
+                x++;
+            }
+            addRun(y, begin, x - 1);
+        }
+        finishRow(y, width, height, runsBegin, previous);
+    }
+    return emit(offset);
+}
+
+const std::vector<Blob> &BlobExtractor::extract(const BitMask &mask, const cv::Point &offset)
+{
+    const int32_t width{mask.width()};
+    const int32_t height{mask.height()};
+    reset();
+    RowSpans previous{0, 0, 0, 0};
+    for (int32_t y = 0; y < height; y++)
+    {
+        const uint64_t *words = mask.row(y);
+
+        // Every run starts at the lowest set and ends before the lowest clear bit after it, so count trailing zeros
+        // of the word or its complement to jump from one edge to the next; runs may continue into the next word
+        const int32_t runsBegin{static_cast<int32_t>(m_runs.size())};
+        int32_t begin{-1};
+        for (int32_t j = 0; j < mask.words(); j++)
+        {
+            const uint64_t word{words[j]};
+            int32_t bit{0};
+            while (bit < 64)
+            {
+                const uint64_t rest{((begin < 0) ? word : ~word) >> bit};
+                if (rest == 0)
+                {
+                    break;
+                }
+                bit += __builtin_ctzll(rest);
+                if (begin < 0)
+                {
+                    begin = 64 * j + bit;
+                }
+                else
+                {
+                    addRun(y, begin, 64 * j + bit - 1);
+                    begin = -1;
+                }
+            }
+        }
+        // The bits behind the width are clear, so only a run that reaches the last bit of the last word is still open
+        if (begin >= 0)
+        {
+            addRun(y, begin, width - 1);
+        }
+        finishRow(y, width, height, runsBegin, previous);
+    }
+    return emit(offset);
+}
+
+const std::vector<Blob> &BlobExtractor::emit(const cv::Point &offset)
+{
+    // Accumulate the statistics of every component in its root run
+    if (m_accumulators.size() < m_runs.size())
+    {
+        m_accumulators.resize(m_runs.size());
+    }
+    for (int32_t i = 1; i < static_cast<int32_t>(m_runs.size()); i++)
+    {
+        const Run &run = m_runs[static_cast<size_t>(i)];
+        if (run.leftGap == isGap)
+        {
+            continue;
+        }
+        const int32_t root{find(i)};
+        Accumulator &a = m_accumulators[static_cast<size_t>(root)];
+        const uint64_t length{static_cast<uint64_t>(run.end - run.begin + 1)};
+        const uint64_t sumX{(static_cast<uint64_t>(run.begin) + static_cast<uint64_t>(run.end)) * length / 2};
+        if (root == i)
+        {
+            a = Accumulator{run.begin, run.y, run.end, run.y, length, sumX, static_cast<uint64_t>(run.y) * length};
+        }
+        else
+        {
+            a.minX = std::min(a.minX, run.begin);
+            a.maxX = std::max(a.maxX, run.end);
+            a.maxY = run.y;
+            a.area += length;
+            a.sumX += sumX;
+            a.sumY += static_cast<uint64_t>(run.y) * length;
+        }
+    }
+
+    // Emit the components that are not inside a hole, last found first like cv::findContours
+    for (int32_t i = static_cast<int32_t>(m_runs.size()) - 1; i > 0; i--)
+    {
+        const Run &run = m_runs[static_cast<size_t>(i)];
+        if ((run.leftGap == isGap) || (find(i) != i))
+        {
+            continue;
+        }
+        // The pixel left of the first run lies in the background that surrounds the component
+        const bool external{(run.leftGap < 0) || (find(run.leftGap) == outside)};
+        if (external)
+        {
+            const Accumulator &a = m_accumulators[static_cast<size_t>(i)];
+            const cv::Rect boundingBox(a.minX + offset.x, a.minY + offset.y, a.maxX - a.minX + 1, a.maxY - a.minY + 1);
+            const cv::Point2f centroid(static_cast<float>(static_cast<double>(a.sumX) / static_cast<double>(a.area) + offset.x), static_cast<float>(static_cast<double>(a.sumY) / static_cast<double>(a.area) + offset.y));
+            m_blobs.push_back(Blob{boundingBox, static_cast<uint32_t>(a.area), centroid, cv::Point(run.begin + offset.x, run.y + offset.y)});
+        }
+    }
+    return m_blobs;
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLOB_EXTRACTOR_HPP
+#define BLOB_EXTRACTOR_HPP
+
+#include "bit-mask.hpp"
+
+#include <opencv2/core/core.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// Connected component of a mask
+struct Blob
+{
+    // Same rectangle as cv::boundingRect of the component's outer contour
+    cv::Rect boundingBox;
+    // Number of pixels of the component
+    uint32_t area;
+    // Mean position of the pixels of the component
+    cv::Point2f centroid;
+    // First pixel of the component in raster order, the leftmost pixel of its top row; a scan of the whole mask
+    // finds the component there
+    cv::Point first;
+};
+
+// Order of the blobs that cv::findContours returns: the blob whose first pixel comes later in raster order first.
+// Blobs found in several windows are sorted with it to come out like from one scan of the whole mask.
+inline bool foundLater(const Blob &a, const Blob &b)
+{
+    return (a.first.y != b.first.y) ? (a.first.y > b.first.y) : (a.first.x > b.first.x);
+}
+
+// Run-length encoded connected-component labeller that replaces cv::findContours(RETR_EXTERNAL) + cv::boundingRect.
+// Foreground pixels are 8-connected; components lying inside a hole of another component are skipped like
+// RETR_EXTERNAL does, and the blobs are returned in the order cv::findContours returns the contours (last found first).
+// The buffers are kept between calls, so extracting blobs from masks of the same size does not allocate.
+class BlobExtractor
+{
+   public:
+    BlobExtractor();
+
+    // Extract the blobs of all non-zero pixels of a CV_8UC1 mask in one scan; offset is added to their positions,
+    // so blobs of a window of a mask come out in the coordinates of the whole mask
+    const std::vector<Blob> &extract(const cv::Mat &mask, const cv::Point &offset = cv::Point());
+    // The same for the set bits of a packed mask, which are turned into runs a word at a time
+    const std::vector<Blob> &extract(const BitMask &mask, const cv::Point &offset = cv::Point());
+
+    const std::vector<Blob> &blobs() const
+    {
+        return m_blobs;
+    }
+
+   private:
+    // Horizontal run of pixels of the same value; gaps are the background runs between foreground runs
+    struct Run
+    {
+        int32_t y;
+        int32_t begin;
+        int32_t end;
+        // For foreground runs the gap to its left (-1 at the left border); -2 for gaps
+        int32_t leftGap;
+    };
+
+    // Bounding box, area and coordinate sums of the component rooted at a run
+    struct Accumulator
+    {
+        int32_t minX;
+        int32_t minY;
+        int32_t maxX;
+        int32_t maxY;
+        uint64_t area;
+        uint64_t sumX;
+        uint64_t sumY;
+    };
+
+    // First and one past the last foreground run and gap of a row
+    struct RowSpans
+    {
+        int32_t runsBegin;
+        int32_t runsEnd;
+        int32_t gapsBegin;
+        int32_t gapsEnd;
+    };
+
+    void reset();
+    void addRun(int32_t y, int32_t begin, int32_t end);
+    // Add the gaps between the runs of row y that start at runsBegin and connect them to the previous row
+    void finishRow(int32_t y, int32_t width, int32_t height, int32_t runsBegin, RowSpans &previous);
+    // Accumulate the components and return the external ones
+    const std::vector<Blob> &emit(const cv::Point &offset);
+    int32_t find(int32_t run);
+    void unite(int32_t a, int32_t b);
+    // Connect the runs of the current row to the overlapping runs of the previous row
+    void connect(int32_t previousBegin, int32_t previousEnd, int32_t currentBegin, int32_t currentEnd, int32_t reach);
+
+    std::vector<Run> m_runs;
+    std::vector<int32_t> m_parent;
+    std::vector<Accumulator> m_accumulators;
+    std::vector<Blob> m_blobs;
+};
+
+#endif
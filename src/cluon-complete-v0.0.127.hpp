@@ -6098,14 +6098,47 @@ class LIBCLUON_API TerminateHandler {
 //#include "cluon/cluon.hpp"
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
-#include <deque>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <utility>
 
 namespace cluon {
 
+/**
+ * What NotifyingPipeline::add does when the pipeline is full.
+ */
+enum class PipelineOverflowPolicy : uint8_t {
+    BLOCK       = 0, // wait until the delegate has processed an entry
+    DROP_OLDEST = 1, // discard the oldest waiting entry to make room
+    DROP_NEWEST = 2, // discard the entry to be added
+};
+
+/**
+ * Counters of a NotifyingPipeline.
+ */
+struct PipelineStatistics {
+    uint64_t added{0};    // entries that entered the pipeline
+    uint64_t dropped{0};  // entries discarded because the pipeline was full
+    uint64_t blocked{0};  // calls to add that had to wait for room
+    uint64_t peakSize{0}; // largest number of waiting entries
+};
+
+/**
+A NotifyingPipeline hands entries from one producer thread to a delegate that
+runs in its own thread. The entries are swapped through a bounded lock-free ring
+that is allocated once; its capacity is rounded up to a power of two. add()
+leaves the entry with what the delegate thread left behind in the cell, so a
+producer that keeps reusing one entry also reuses the buffers of the entries
+that the delegate did not take over. When the ring is full, add() blocks or
+drops the oldest or the newest entry according to the PipelineOverflowPolicy.
+add() must only be called from one thread at a time.
+*/
 template <class T>
 class LIBCLUON_API NotifyingPipeline {
    private:
@@ -6115,8 +6148,16 @@ class LIBCLUON_API NotifyingPipeline {
     NotifyingPipeline &operator=(NotifyingPipeline &&) = delete;
 
    public:
-    NotifyingPipeline(std::function<void(T &&)> delegate)
-        : m_delegate(delegate) {
+    NotifyingPipeline(std::function<void(T &&)> delegate,
+                      size_t capacity               = 4096,
+                      PipelineOverflowPolicy policy = PipelineOverflowPolicy::BLOCK)
+        : m_delegate(delegate)
+        , m_mask(roundUpToPowerOfTwo(capacity) - 1)
+        , m_policy(policy)
+        , m_cells(new Cell[m_mask + 1]) {
+        for (size_t i{0}; i <= m_mask; i++) {
+            m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+        }
         m_pipelineThread = std::thread(&NotifyingPipeline::processPipeline, this);
 
         // Let the operating system spawn the thread.
@@ -6128,7 +6169,7 @@ class LIBCLUON_API NotifyingPipeline {
         m_pipelineThreadRunning.store(false);
 
         // Wake any waiting threads.
-        m_pipelineCondition.notify_all();
+        notifyAll();
 
         // Joining the thread could fail.
         try {
@@ -6139,65 +6180,182 @@ class LIBCLUON_API NotifyingPipeline {
     }
 
    public:
+    /**
+     * This method moves an entry into the pipeline; call notifyAll() to let the delegate process it.
+     *
+     * @param entry Entry to be processed; afterwards it holds an entry that was processed before or a default one.
+     */
     inline void add(T &&entry) noexcept {
-        std::unique_lock<std::mutex> lck(m_pipelineMutex);
-        m_pipeline.emplace_back(entry);
+        uint32_t rounds{0};
+        while (!tryPush(entry)) {
+            if (PipelineOverflowPolicy::DROP_NEWEST == m_policy) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            if (PipelineOverflowPolicy::DROP_OLDEST == m_policy) {
+                // Nothing was popped when the delegate has just taken the oldest entry itself; then its cell is free soon.
+                T oldest{};
+                if (tryPop(oldest)) {
+                    m_dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+                continue;
+            }
+            if (!m_pipelineThreadRunning.load()) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            if (0 == rounds++) {
+                m_blocked.fetch_add(1, std::memory_order_relaxed);
+                // The delegate may still be waiting for the entries added since the last notification.
+                notifyAll();
+            }
+            if (rounds < 64) {
+                std::this_thread::yield();
+            } else {
+                using namespace std::literals::chrono_literals; // NOLINT
+                std::this_thread::sleep_for(50us);
+            }
+        }
+        m_added.fetch_add(1, std::memory_order_relaxed);
     }
 
-    inline void notifyAll() noexcept { m_pipelineCondition.notify_all(); }
+    inline void notifyAll() noexcept {
+        // Entries are added without the mutex. The delegate thread announces that it is about to sleep before it
+        // looks at the ring a last time, so either it sees the entries or this thread sees the announcement; only
+        // then the mutex is taken to wait until the delegate thread sleeps and can be woken up.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_parked.load(std::memory_order_relaxed)) {
+            try {
+                std::lock_guard<std::mutex> lck(m_pipelineMutex);
+            } catch (...) {} // LCOV_EXCL_LINE
+            m_pipelineCondition.notify_all();
+        }
+    }
 
     inline bool isRunning() noexcept { return m_pipelineThreadRunning.load(); }
 
+    /**
+     * @return Maximum number of waiting entries.
+     */
+    inline size_t capacity() const noexcept { return m_mask + 1; }
+
+    /**
+     * @return Counters since this pipeline was created.
+     */
+    inline PipelineStatistics statistics() const noexcept {
+        PipelineStatistics retVal;
+        retVal.added    = m_added.load(std::memory_order_relaxed);
+        retVal.dropped  = m_dropped.load(std::memory_order_relaxed);
+        retVal.blocked  = m_blocked.load(std::memory_order_relaxed);
+        retVal.peakSize = m_peakSize.load(std::memory_order_relaxed);
+        return retVal;
+    }
+
    private:
+    // A cell of the ring is free for the entry with index i when its sequence equals i and holds that entry when
+    // its sequence equals i + 1 (bounded queue after Dmitry Vyukov). The single producer owns m_tail; the delegate
+    // thread and, for DROP_OLDEST, the producer claim entries by advancing m_head.
+    struct Cell {
+        std::atomic<size_t> m_sequence{0};
+        T m_entry{};
+    };
+
+    static size_t roundUpToPowerOfTwo(size_t capacity) noexcept {
+        size_t power{1};
+        while (power < capacity) { power <<= 1; }
+        return power;
+    }
+
+    inline bool tryPush(T &entry) noexcept {
+        const size_t tail{m_tail.load(std::memory_order_relaxed)};
+        Cell &cell = m_cells[tail & m_mask];
+        if (cell.m_sequence.load(std::memory_order_acquire) != tail) {
+            return false;
+        }
+        using std::swap;
+        swap(cell.m_entry, entry);
+        cell.m_sequence.store(tail + 1, std::memory_order_release);
+        m_tail.store(tail + 1, std::memory_order_relaxed);
+
+        const uint64_t size{static_cast<uint64_t>(tail + 1 - m_head.load(std::memory_order_relaxed))};
+        if (size > m_peakSize.load(std::memory_order_relaxed)) {
+            m_peakSize.store(size, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    inline bool tryPop(T &entry) noexcept {
+        size_t head{m_head.load(std::memory_order_relaxed)};
+        while (true) {
+            Cell &cell = m_cells[head & m_mask];
+            const size_t sequence{cell.m_sequence.load(std::memory_order_acquire)};
+            if (sequence != head + 1) {
+                // The cell is still empty, or another thread has taken it and head is stale.
+                const size_t current{m_head.load(std::memory_order_relaxed)};
+                if (current == head) {
+                    return false;
+                }
+                head = current;
+            } else if (m_head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed)) {
+                // The previous entry of the caller goes into the cell, from where add() hands it back to the producer.
+                using std::swap;
+                swap(entry, cell.m_entry);
+                cell.m_sequence.store(head + m_mask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+    }
+
     inline void processPipeline() noexcept {
         // Indicate to caller that we are ready.
         m_pipelineThreadRunning.store(true);
 
+        T entry;
         while (m_pipelineThreadRunning.load()) {
-            std::unique_lock<std::mutex> lck(m_pipelineMutex);
-            // Wait until the thread should stop or data is available.
-            m_pipelineCondition.wait(lck, [this] { return (!this->m_pipelineThreadRunning.load() || !this->m_pipeline.empty()); });
-
-            // The condition will automatically lock the mutex after waking up.
-            // As we are locking per entry, we need to unlock the mutex first.
-            lck.unlock();
-
-            uint32_t entries{0};
             {
-                lck.lock();
-                entries = static_cast<uint32_t>(m_pipeline.size());
-                lck.unlock();
+                std::unique_lock<std::mutex> lck(m_pipelineMutex);
+                m_parked.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                // Wait until the thread should stop or data is available.
+                m_pipelineCondition.wait(lck, [this] {
+                    return (!this->m_pipelineThreadRunning.load()
+                            || (this->m_head.load(std::memory_order_relaxed) != this->m_tail.load(std::memory_order_acquire)));
+                });
+                m_parked.store(false, std::memory_order_relaxed);
             }
-            for (uint32_t i{0}; i < entries; i++) {
-                T entry;
-                {
-                    lck.lock();
-                    entry = m_pipeline.front();
-                    lck.unlock();
-                }
 
+            while (tryPop(entry)) {
                 if (nullptr != m_delegate) {
                     m_delegate(std::move(entry));
                 }
-
-                {
-                    lck.lock();
-                    m_pipeline.pop_front();
-                    lck.unlock();
-                }
             }
         }
     }
 
    private:
     std::function<void(T &&)> m_delegate;
+    const size_t m_mask;
+    const PipelineOverflowPolicy m_policy;
+    std::unique_ptr<Cell[]> m_cells;
 
     std::atomic<bool> m_pipelineThreadRunning{false};
     std::thread m_pipelineThread{};
     std::mutex m_pipelineMutex{};
     std::condition_variable m_pipelineCondition{};
-
-    std::deque<T> m_pipeline{};
+    // Set by the delegate thread while it waits for entries.
+    std::atomic<bool> m_parked{false};
+
+    // Producer and delegate indices live on their own cache lines.
+    char m_headPadding[64]{};
+    std::atomic<size_t> m_head{0};
+    char m_tailPadding[64 - sizeof(std::atomic<size_t>)]{};
+    std::atomic<size_t> m_tail{0};
+    char m_countersPadding[64 - sizeof(std::atomic<size_t>)]{};
+
+    std::atomic<uint64_t> m_added{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<uint64_t> m_blocked{0};
+    std::atomic<uint64_t> m_peakSize{0};
 };
 } // namespace cluon
 
@@ -6413,6 +6571,13 @@ activated and concurrently waiting for data in a separate thread. To check
 whether the instance was created successfully and running, the method
 `isRunning()` should be called.
 
+On Linux, a batch size larger than 1 makes the receiving thread pull up to
+that many datagrams with a single `recvmmsg` system call into a slab of
+buffers that is allocated once. A batch timeout larger than zero lets it wait
+that long for a partially filled batch to fill up; by default, a batch is
+handed over as soon as the socket has no more datagrams queued. The method
+`statistics()` reports how many datagrams arrived per system call.
+
 A complete example is available
 [here](https://github.com/chrberger/libcluon/blob/master/libcluon/examples/cluon-UDPReceiver.cpp).
 */
@@ -6431,11 +6596,19 @@ class LIBCLUON_API UDPReceiver {
      * @param receiveFromPort Port to receive UDP packets from.
      * @param delegate Functional (noexcept) to handle received bytes; parameters are received data, sender, timestamp.
      * @param localSendFromPort Port that an application is using to send data. This port (> 0) is ignored when data is received.
+     * @param batchSize Maximum number of datagrams to receive with one system call; values > 1 are only supported on Linux.
+     * @param batchTimeout Time to wait for a partially filled batch to fill up before handing it over.
+     * @param pipelineCapacity Maximum number of received datagrams waiting for the delegate.
+     * @param overflowPolicy What to do with a datagram that arrives while pipelineCapacity datagrams are waiting.
      */
     UDPReceiver(const std::string &receiveFromAddress,
                 uint16_t receiveFromPort,
                 std::function<void(std::string &&, std::string &&, std::chrono::system_clock::time_point &&)> delegate,
-                uint16_t localSendFromPort = 0) noexcept;
+                uint16_t localSendFromPort             = 0,
+                uint16_t batchSize                     = 1,
+                std::chrono::microseconds batchTimeout = std::chrono::microseconds{0},
+                size_t pipelineCapacity                = 4096,
+                PipelineOverflowPolicy overflowPolicy  = PipelineOverflowPolicy::BLOCK) noexcept;
     ~UDPReceiver() noexcept;
 
     /**
@@ -6443,6 +6616,22 @@ class LIBCLUON_API UDPReceiver {
      */
     bool isRunning() const noexcept;
 
+    /**
+     * Counters of the receiving thread; packets / receiveCalls is the number of datagrams per system call.
+     */
+    struct Statistics {
+        uint64_t receiveCalls{0}; // recvfrom or recvmmsg calls, including those that found no datagram
+        uint64_t packets{0};      // datagrams received
+        uint64_t batches{0};      // batches handed over to the pipeline
+        uint64_t fullBatches{0};  // batches that reached the batch size
+        PipelineStatistics pipeline{};
+    };
+
+    /**
+     * @return Counters since this UDPReceiver was created.
+     */
+    Statistics statistics() const noexcept;
+
    private:
     /**
      * This method closes the socket.
@@ -6452,12 +6641,26 @@ class LIBCLUON_API UDPReceiver {
     void closeSocket(int errorCode) noexcept;
 
     void readFromSocket() noexcept;
+#ifdef __linux__
+    void readBatchesFromSocket() noexcept;
+#endif
+
+    /**
+     * This method hands a received datagram over to the pipeline unless we sent it ourselves.
+     *
+     * @return true if the datagram was added to the pipeline.
+     */
+    bool addToPipeline(const char *data, size_t length, const struct sockaddr_storage &remote, std::chrono::system_clock::time_point timestamp) noexcept;
 
    private:
     int32_t m_socket{-1};
     bool m_isBlockingSocket{true};
     std::set<unsigned long> m_listOfLocalIPAddresses{};
     uint16_t m_localSendFromPort;
+    uint16_t m_batchSize;
+    std::chrono::microseconds m_batchTimeout;
+    size_t m_pipelineCapacity;
+    PipelineOverflowPolicy m_overflowPolicy;
     struct sockaddr_in m_receiveFromAddress {};
     struct ip_mreq m_mreq {};
     bool m_isMulticast{false};
@@ -6465,6 +6668,11 @@ class LIBCLUON_API UDPReceiver {
     std::atomic<bool> m_readFromSocketThreadRunning{false};
     std::thread m_readFromSocketThread{};
 
+    std::atomic<uint64_t> m_receiveCalls{0};
+    std::atomic<uint64_t> m_packets{0};
+    std::atomic<uint64_t> m_batches{0};
+    std::atomic<uint64_t> m_fullBatches{0};
+
    private:
     std::function<void(std::string &&, std::string &&, std::chrono::system_clock::time_point)> m_delegate{};
 
@@ -6477,6 +6685,13 @@ class LIBCLUON_API UDPReceiver {
     };
 
     std::shared_ptr<cluon::NotifyingPipeline<PipelineEntry>> m_pipeline{};
+
+    // Entry that the receiving thread fills for every datagram; the pipeline hands back the buffers of processed entries.
+    PipelineEntry m_entry{};
+    // Sender of the last datagram and its formatted address.
+    unsigned long m_lastRemoteIP{0};
+    uint16_t m_lastRemotePort{0};
+    std::string m_lastRemoteAddress{};
 };
 } // namespace cluon
 
@@ -6956,9 +7171,8 @@ class LIBCLUON_API FromProtoVisitor {
         (void)name;
 
         if (m_callToDecodeFromWithDirectVisit) {
-            std::stringstream sstr{std::move(std::string(m_stringValue.data(), static_cast<std::size_t>(m_value)))};
             cluon::FromProtoVisitor nestedProtoDecoder;
-            nestedProtoDecoder.decodeFrom(sstr, v);
+            nestedProtoDecoder.decodeFrom(m_stringData, static_cast<std::size_t>(m_value), v);
         }
         else if (0 < m_mapOfKeyValues.count(id)) {
             try {
@@ -7017,6 +7231,7 @@ class LIBCLUON_API FromProtoVisitor {
                             m_stringValue.reserve(BYTES_TO_READ_FROM_STREAM);
                         }
                         readBytesFromStream(in, BYTES_TO_READ_FROM_STREAM, m_stringValue.data());
+                        m_stringData = m_stringValue.data();
                         v.accept(m_fieldId, *this);
                     }
                     break;
@@ -7026,6 +7241,19 @@ class LIBCLUON_API FromProtoVisitor {
         m_callToDecodeFromWithDirectVisit = false;
     }
 
+    /**
+     * This method decodes the given Proto-encoded bytes into corresponding
+     * fields of v. Strings and nested messages are read in place from data;
+     * fields that are not contained in data keep their values in v.
+     *
+     * @param data Proto-encoded bytes to decode.
+     * @param length Number of bytes.
+     * @param v Data structure to receive the decoded values.
+     * @return true if all bytes were decoded.
+     */
+    template<typename T>
+    bool decodeFrom(const char *data, std::size_t length, T &v) noexcept;
+
    private:
     int8_t fromZigZag8(uint8_t v) noexcept;
     int16_t fromZigZag16(uint16_t v) noexcept;
@@ -7062,6 +7290,8 @@ class LIBCLUON_API FromProtoVisitor {
 
     // Buffer for strings.
     std::vector<char> m_stringValue;
+    // Bytes of the current length-delimited field when decoding directly.
+    const char *m_stringData{nullptr};
 
     uint64_t m_keyFieldType{0};
     ProtoConstants m_protoType{ProtoConstants::VARINT};
@@ -8134,6 +8364,198 @@ inline T extractMessage(cluon::data::Envelope &&envelope) noexcept {
     return msg;
 }
 
+/**
+ * Fields of an Envelope besides its payload.
+ */
+struct EnvelopeMeta {
+    int32_t dataType{0};
+    uint32_t senderStamp{0};
+    cluon::data::TimeStamp sent{};
+    cluon::data::TimeStamp received{};
+    cluon::data::TimeStamp sampleTimeStamp{};
+};
+
+/**
+ * This method reads a Proto VarInt from the given bytes and advances pos behind it.
+ *
+ * @return true if a complete VarInt was found before end.
+ */
+inline bool readProtoVarInt(const char *&pos, const char *end, uint64_t &value) noexcept {
+    value = 0;
+    for (uint32_t shift{0}; (pos < end) && (shift < 64); shift += 7) {
+        const uint64_t C{static_cast<uint8_t>(*pos++)};
+        value |= (C & 0x7f) << shift;
+        if (!(C & 0x80)) { // NOLINT
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * This method moves pos to the next field of a Proto-encoded message and
+ * returns its identifier and type. VarInt values are stored in value; for
+ * length-delimited fields, value is the length and pos points to the bytes.
+ *
+ * @return true if the field lies completely before end.
+ */
+inline bool readProtoField(const char *&pos, const char *end, uint32_t &fieldId, uint8_t &protoType, uint64_t &value) noexcept {
+    uint64_t keyFieldType{0};
+    if (!readProtoVarInt(pos, end, keyFieldType)) {
+        return false;
+    }
+    fieldId   = static_cast<uint32_t>(keyFieldType >> 3);
+    protoType = static_cast<uint8_t>(keyFieldType & 0x7);
+    switch (static_cast<ProtoConstants>(protoType)) {
+        case ProtoConstants::VARINT: return readProtoVarInt(pos, end, value);
+        case ProtoConstants::EIGHT_BYTES: value = sizeof(double); break;
+        case ProtoConstants::FOUR_BYTES: value = sizeof(float); break;
+        case ProtoConstants::LENGTH_DELIMITED:
+            if (!readProtoVarInt(pos, end, value)) {
+                return false;
+            }
+            break;
+        default: return false;
+    }
+    return (value <= static_cast<uint64_t>(end - pos));
+}
+
+/**
+ * This method checks the OD4 header (0x0D 0xA4 LEN0 LEN1 LEN2) in front of a
+ * Proto-encoded Envelope and returns the bounds of the Envelope.
+ *
+ * @return true if the given bytes hold a complete Envelope.
+ */
+inline bool extractEnvelopeBounds(const char *data, std::size_t length, const char *&begin, const char *&end) noexcept {
+    constexpr uint8_t OD4_HEADER_SIZE{5};
+    if ((nullptr == data) || (length < OD4_HEADER_SIZE) || (0x0D != static_cast<uint8_t>(data[0])) || (0xA4 != static_cast<uint8_t>(data[1]))) {
+        return false;
+    }
+    const std::size_t LENGTH{static_cast<std::size_t>(static_cast<uint8_t>(data[2])) | (static_cast<std::size_t>(static_cast<uint8_t>(data[3])) << 8)
+                             | (static_cast<std::size_t>(static_cast<uint8_t>(data[4])) << 16)};
+    if (LENGTH > length - OD4_HEADER_SIZE) {
+        return false;
+    }
+    begin = data + OD4_HEADER_SIZE;
+    end   = begin + LENGTH;
+    return true;
+}
+
+/**
+ * This method reads only the data type and sender stamp of an Envelope in
+ * the byte format described at extractEnvelope; the payload is skipped without
+ * being copied, so messages nobody subscribed to can be rejected cheaply.
+ *
+ * @param data Bytes of the Envelope including the OD4 header.
+ * @param length Number of bytes.
+ * @param dataType Data type of the payload.
+ * @param senderStamp Sender stamp of the Envelope.
+ * @return true if the given bytes hold a complete Envelope.
+ */
+inline bool extractEnvelopeHeader(const char *data, std::size_t length, int32_t &dataType, uint32_t &senderStamp) noexcept {
+    const char *pos{nullptr};
+    const char *end{nullptr};
+    if (!extractEnvelopeBounds(data, length, pos, end)) {
+        return false;
+    }
+    dataType    = 0;
+    senderStamp = 0;
+    uint32_t fieldId{0};
+    uint8_t protoType{0};
+    uint64_t value{0};
+    while (pos < end) {
+        if (!readProtoField(pos, end, fieldId, protoType, value)) {
+            return false;
+        }
+        if (static_cast<uint8_t>(ProtoConstants::VARINT) == protoType) {
+            if (1 == fieldId) {
+                dataType = static_cast<int32_t>((static_cast<uint32_t>(value) >> 1) ^ -(static_cast<uint32_t>(value) & 1));
+            } else if (6 == fieldId) {
+                senderStamp = static_cast<uint32_t>(value);
+            }
+        } else {
+            pos += value;
+        }
+    }
+    return true;
+}
+
+/**
+ * This method decodes a Proto-encoded TimeStamp from the given bytes.
+ */
+inline void extractTimeStamp(const char *pos, const char *end, cluon::data::TimeStamp &timeStamp) noexcept {
+    timeStamp = cluon::data::TimeStamp();
+    uint32_t fieldId{0};
+    uint8_t protoType{0};
+    uint64_t value{0};
+    while ((pos < end) && readProtoField(pos, end, fieldId, protoType, value)) {
+        if (static_cast<uint8_t>(ProtoConstants::VARINT) == protoType) {
+            const int32_t v{static_cast<int32_t>((static_cast<uint32_t>(value) >> 1) ^ -(static_cast<uint32_t>(value) & 1))};
+            if (1 == fieldId) {
+                timeStamp.seconds(v);
+            } else if (2 == fieldId) {
+                timeStamp.microseconds(v);
+            }
+        } else {
+            pos += value;
+        }
+    }
+}
+
+/**
+ * This method decodes all fields of an Envelope in the byte format described
+ * at extractEnvelope except for its payload, which is returned as a pointer
+ * into the given bytes; nothing is allocated or copied.
+ *
+ * @param data Bytes of the Envelope including the OD4 header.
+ * @param length Number of bytes.
+ * @param meta Fields of the Envelope.
+ * @param payload Start of the Proto-encoded payload inside data.
+ * @param payloadLength Length of the payload.
+ * @return true if the given bytes hold a complete Envelope.
+ */
+inline bool extractEnvelopeView(const char *data, std::size_t length, EnvelopeMeta &meta, const char *&payload, std::size_t &payloadLength) noexcept {
+    const char *pos{nullptr};
+    const char *end{nullptr};
+    if (!extractEnvelopeBounds(data, length, pos, end)) {
+        return false;
+    }
+    meta          = EnvelopeMeta();
+    payload       = pos;
+    payloadLength = 0;
+    uint32_t fieldId{0};
+    uint8_t protoType{0};
+    uint64_t value{0};
+    while (pos < end) {
+        if (!readProtoField(pos, end, fieldId, protoType, value)) {
+            return false;
+        }
+        if (static_cast<uint8_t>(ProtoConstants::VARINT) == protoType) {
+            if (1 == fieldId) {
+                meta.dataType = static_cast<int32_t>((static_cast<uint32_t>(value) >> 1) ^ -(static_cast<uint32_t>(value) & 1));
+            } else if (6 == fieldId) {
+                meta.senderStamp = static_cast<uint32_t>(value);
+            }
+            continue;
+        }
+        if (static_cast<uint8_t>(ProtoConstants::LENGTH_DELIMITED) == protoType) {
+            const char *fieldEnd{pos + value};
+            if (2 == fieldId) {
+                payload       = pos;
+                payloadLength = static_cast<std::size_t>(value);
+            } else if (3 == fieldId) {
+                extractTimeStamp(pos, fieldEnd, meta.sent);
+            } else if (4 == fieldId) {
+                extractTimeStamp(pos, fieldEnd, meta.received);
+            } else if (5 == fieldId) {
+                extractTimeStamp(pos, fieldEnd, meta.sampleTimeStamp);
+            }
+        }
+        pos += value;
+    }
+    return true;
+}
+
 } // namespace cluon
 
 #endif
@@ -8856,6 +9278,8 @@ class LIBCLUON_API LCMToGenericMessage {
 #ifndef CLUON_OD4SESSION_HPP
 #define CLUON_OD4SESSION_HPP
 
+//#include "cluon/Envelope.hpp"
+//#include "cluon/FromProtoVisitor.hpp"
 //#include "cluon/Time.hpp"
 //#include "cluon/ToProtoVisitor.hpp"
 //#include "cluon/UDPReceiver.hpp"
@@ -8863,6 +9287,7 @@ class LIBCLUON_API LCMToGenericMessage {
 //#include "cluon/cluon.hpp"
 //#include "cluon/cluonDataStructures.hpp"
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <functional>
@@ -8871,6 +9296,7 @@ class LIBCLUON_API LCMToGenericMessage {
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace cluon {
 /**
@@ -8906,6 +9332,15 @@ MyMessage msg;
 od4.send(msg);
 \endcode
 
+Variant B can also decode the messages of interest directly, which avoids
+copying their payload into an Envelope:
+
+\code{.cpp}
+cluon::OD4Session od4{111};
+
+od4.dataTrigger<MyMessage>([](const MyMessage &msg, const cluon::EnvelopeMeta &meta){ std::cout << "Received MyMessage" << std::endl;});
+\endcode
+
 Next to receive Envelopes, OD4Session can call a user-supplied lambda in a time-triggered
 way. The lambda is executed as long as it does not return false or throws an exception
 that is then caught in the method timeTrigger and the method is exited:
@@ -8936,8 +9371,18 @@ class LIBCLUON_API OD4Session {
      *        if a nullptr is passed, the method dataTrigger can be used to set
      *        message specific delegates. Please note that it is NOT possible
      *        to have both: a delegate for "catch-all" and the data-triggered ones.
+     * @param receiveBatchSize Maximum number of datagrams to receive with one system call (see UDPReceiver).
+     * @param receiveBatchTimeout Time to wait for a partially filled receive batch to fill up (see UDPReceiver).
+     * @param receiveQueueCapacity Maximum number of received datagrams waiting to be dispatched.
+     * @param overflowPolicy What to do with a datagram that arrives while the receive queue is full.
      */
-    OD4Session(uint16_t CID, std::function<void(cluon::data::Envelope &&envelope)> delegate = nullptr) noexcept;
+    OD4Session(uint16_t CID,
+               std::function<void(cluon::data::Envelope &&envelope)> delegate = nullptr,
+               uint16_t receiveBatchSize                                      = 1,
+               std::chrono::microseconds receiveBatchTimeout                  = std::chrono::microseconds{0},
+               size_t receiveQueueCapacity                                    = 4096,
+               PipelineOverflowPolicy overflowPolicy                          = PipelineOverflowPolicy::BLOCK) noexcept;
+    ~OD4Session() noexcept;
 
     /**
      * This method will send a given Envelope to this OpenDaVINCI v4 session.
@@ -8956,6 +9401,40 @@ class LIBCLUON_API OD4Session {
      */
     bool dataTrigger(int32_t messageIdentifier, std::function<void(cluon::data::Envelope &&envelope)> delegate) noexcept;
 
+    /**
+     * This method sets a delegate to be called data-triggered on arrival
+     * of a new message of type T. The payload is decoded once, directly
+     * from the received bytes into an instance of T that belongs to this
+     * delegate and is reused for all of its messages; thus, the message
+     * passed to the delegate is only valid until the delegate returns.
+     * A dispatch that arrives while another thread decodes for the same
+     * delegate decodes into an instance of its own.
+     *
+     * @param delegate Function to call on newly arriving messages; setting it to nullptr will erase it.
+     * @return true if the given delegate could be successfully set or unset.
+     */
+    template <typename T>
+    bool dataTrigger(std::function<void(const T &message, const EnvelopeMeta &meta)> delegate) noexcept {
+        DecodingDelegate decodingDelegate{nullptr};
+        if (nullptr != delegate) {
+            try {
+                std::shared_ptr<DecodingState<T>> state{std::make_shared<DecodingState<T>>()};
+                decodingDelegate = [delegate, state](const EnvelopeMeta &meta, const char *payload, std::size_t payloadLength) {
+                    std::unique_lock<std::mutex> lck(state->mutex, std::try_to_lock);
+                    if (lck.owns_lock()) {
+                        decodeAndCall(*state, delegate, meta, payload, payloadLength);
+                    } else {
+                        DecodingState<T> concurrentState;
+                        decodeAndCall(concurrentState, delegate, meta, payload, payloadLength);
+                    }
+                };
+            } catch (...) { // LCOV_EXCL_LINE
+                return false; // LCOV_EXCL_LINE
+            }
+        }
+        return setDataTriggeredDelegate(static_cast<int32_t>(T::ID()), std::move(decodingDelegate));
+    }
+
     /**
      * This method sets a delegate to be called time-triggered using the
      * specified frequency until the delegate returns false. This method
@@ -8998,8 +9477,53 @@ class LIBCLUON_API OD4Session {
    public:
     bool isRunning() noexcept;
 
+    /**
+     * @return Counters of the receiving thread.
+     */
+    UDPReceiver::Statistics receiverStatistics() const noexcept;
+
+    /**
+     * This method passes the given bytes to the delegates as if they had
+     * been received, for instance to replay recorded datagrams or to
+     * measure the dispatching. It can be called from any thread.
+     *
+     * @param data Bytes of an Envelope including the OD4 header.
+     * @param timepoint Time point when the bytes were received.
+     */
+    void dispatch(const std::string &data, const std::chrono::system_clock::time_point &timepoint) noexcept;
+
+   private:
+    // Delegates receive the fields of an Envelope and its payload, which points into the received bytes.
+    using DecodingDelegate = std::function<void(const EnvelopeMeta &meta, const char *payload, std::size_t payloadLength)>;
+    // Published tables are never changed; the delegates are shared between a table and its successors.
+    using DelegateTable = std::unordered_map<int32_t, std::shared_ptr<const DecodingDelegate>, UseUInt32ValueAsHashKey>;
+
+    // Reused message of a typed delegate; the defaults reset it before decoding. The mutex is held while decoding.
+    template <typename T>
+    struct DecodingState {
+        T message{};
+        const T defaults{};
+        cluon::FromProtoVisitor decoder{};
+        std::mutex mutex{};
+    };
+
+    template <typename T>
+    static void decodeAndCall(DecodingState<T> &state,
+                              const std::function<void(const T &message, const EnvelopeMeta &meta)> &delegate,
+                              const EnvelopeMeta &meta,
+                              const char *payload,
+                              std::size_t payloadLength) {
+        // Fields that are missing in the payload must not keep the values of the previous message.
+        state.message = state.defaults;
+        if (state.decoder.decodeFrom(payload, payloadLength, state.message)) {
+            delegate(state.message, meta);
+        }
+    }
+
    private:
     void callback(std::string &&data, std::string &&from, std::chrono::system_clock::time_point &&timepoint) noexcept;
+    bool setDataTriggeredDelegate(int32_t messageIdentifier, DecodingDelegate &&delegate) noexcept;
+    cluon::data::Envelope toEnvelope(const EnvelopeMeta &meta, const char *payload, std::size_t payloadLength) noexcept;
     void sendInternal(std::string &&dataToSend) noexcept;
 
    private:
@@ -9010,8 +9534,16 @@ class LIBCLUON_API OD4Session {
 
     std::function<void(cluon::data::Envelope &&envelope)> m_delegate{nullptr};
 
+    // Setting a delegate copies the published table, changes the copy and publishes it in place of the
+    // old one; dispatching only reads the table that is published when it starts and never locks.
     std::mutex m_mapOfDataTriggeredDelegatesMutex{};
-    std::unordered_map<int32_t, std::function<void(cluon::data::Envelope &&envelope)>, UseUInt32ValueAsHashKey> m_mapOfDataTriggeredDelegates{};
+    std::atomic<const DelegateTable *> m_mapOfDataTriggeredDelegates{nullptr};
+    // Number of running dispatches, which might still read a replaced table.
+    std::atomic<uint32_t> m_activeDispatches{0};
+    // Replaced tables; they are deleted as soon as a delegate is set or the last running dispatch returns while no
+    // dispatch is running.
+    std::vector<std::unique_ptr<const DelegateTable>> m_retiredDelegateTables{};
+    std::atomic<bool> m_hasRetiredDelegateTables{false};
 };
 
 } // namespace cluon
@@ -9253,6 +9785,7 @@ class LIBCLUON_API Player {
 #include <cstddef>
 #include <cstdint>
 #include <atomic>
+#include <chrono>
 #include <string>
 #include <utility>
 
@@ -9297,6 +9830,15 @@ class LIBCLUON_API SharedMemory {
      */
     void wait() noexcept;
 
+    /**
+     * This method waits for being notified from the shared condition
+     * for at most the given duration.
+     *
+     * @param timeout Maximum duration to wait.
+     * @return true if woken up before the timeout expired.
+     */
+    bool waitFor(const std::chrono::microseconds &timeout) noexcept;
+
     /**
      * This method notifies all threads waiting on the shared condition.
      */
@@ -9351,6 +9893,7 @@ class LIBCLUON_API SharedMemory {
     void lockWIN32() noexcept;
     void unlockWIN32() noexcept;
     void waitWIN32() noexcept;
+    bool waitForWIN32(const std::chrono::microseconds &timeout) noexcept;
     void notifyAllWIN32() noexcept;
 #else
    private:
@@ -9359,6 +9902,7 @@ class LIBCLUON_API SharedMemory {
     void lockPOSIX() noexcept;
     void unlockPOSIX() noexcept;
     void waitPOSIX() noexcept;
+    bool waitForPOSIX(const std::chrono::microseconds &timeout) noexcept;
     void notifyAllPOSIX() noexcept;
     bool validPOSIX() noexcept;
 
@@ -9367,6 +9911,7 @@ class LIBCLUON_API SharedMemory {
     void lockSysV() noexcept;
     void unlockSysV() noexcept;
     void waitSysV() noexcept;
+    bool waitForSysV(const std::chrono::microseconds &timeout) noexcept;
     void notifyAllSysV() noexcept;
     bool validSysV() noexcept;
 #endif
@@ -10207,8 +10752,20 @@ namespace cluon {
 inline UDPReceiver::UDPReceiver(const std::string &receiveFromAddress,
                          uint16_t receiveFromPort,
                          std::function<void(std::string &&, std::string &&, std::chrono::system_clock::time_point &&)> delegate,
-                         uint16_t localSendFromPort) noexcept
+                         uint16_t localSendFromPort,
+                         uint16_t batchSize,
+                         std::chrono::microseconds batchTimeout,
+                         size_t pipelineCapacity,
+                         PipelineOverflowPolicy overflowPolicy) noexcept
     : m_localSendFromPort(localSendFromPort)
+#ifdef __linux__
+    , m_batchSize((0 < batchSize) ? batchSize : static_cast<uint16_t>(1))
+#else
+    , m_batchSize(1)
+#endif
+    , m_batchTimeout((batchTimeout.count() > 0) ? batchTimeout : std::chrono::microseconds{0})
+    , m_pipelineCapacity(pipelineCapacity)
+    , m_overflowPolicy(overflowPolicy)
     , m_receiveFromAddress()
     , m_mreq()
     , m_readFromSocketThread()
@@ -10387,19 +10944,13 @@ inline UDPReceiver::UDPReceiver(const std::string &receiveFromAddress,
 #endif
         }
 
+        // The pipeline must exist before the receiving thread hands datagrams over to it.
         if (!(m_socket < 0)) {
-            // Constructing the receiving thread could fail.
-            try {
-                m_readFromSocketThread = std::thread(&UDPReceiver::readFromSocket, this);
-
-                // Let the operating system spawn the thread.
-                using namespace std::literals::chrono_literals; // NOLINT
-                do { std::this_thread::sleep_for(1ms); } while (!m_readFromSocketThreadRunning.load());
-            } catch (...) { closeSocket(ECHILD); } // LCOV_EXCL_LINE
-
             try {
                 m_pipeline = std::make_shared<cluon::NotifyingPipeline<PipelineEntry>>(
-                    [this](PipelineEntry &&entry) { this->m_delegate(std::move(entry.m_data), std::move(entry.m_from), std::move(entry.m_sampleTime)); });
+                    [this](PipelineEntry &&entry) { this->m_delegate(std::move(entry.m_data), std::move(entry.m_from), std::move(entry.m_sampleTime)); },
+                    m_pipelineCapacity,
+                    m_overflowPolicy);
                 if (m_pipeline) {
                     // Let the operating system spawn the thread.
                     using namespace std::literals::chrono_literals; // NOLINT
@@ -10407,6 +10958,17 @@ inline UDPReceiver::UDPReceiver(const std::string &receiveFromAddress,
                 }
             } catch (...) { closeSocket(ECHILD); } // LCOV_EXCL_LINE
         }
+
+        if (!(m_socket < 0)) {
+            // Constructing the receiving thread could fail.
+            try {
+                m_readFromSocketThread = std::thread(&UDPReceiver::readFromSocket, this);
+
+                // Let the operating system spawn the thread.
+                using namespace std::literals::chrono_literals; // NOLINT
+                do { std::this_thread::sleep_for(1ms); } while (!m_readFromSocketThreadRunning.load());
+            } catch (...) { closeSocket(ECHILD); } // LCOV_EXCL_LINE
+        }
     }
 }
 
@@ -10463,7 +11025,69 @@ inline bool UDPReceiver::isRunning() const noexcept {
     return (m_readFromSocketThreadRunning.load() && !TerminateHandler::instance().isTerminated.load());
 }
 
+inline UDPReceiver::Statistics UDPReceiver::statistics() const noexcept {
+    Statistics retVal;
+    retVal.receiveCalls = m_receiveCalls.load(std::memory_order_relaxed);
+    retVal.packets      = m_packets.load(std::memory_order_relaxed);
+    retVal.batches      = m_batches.load(std::memory_order_relaxed);
+    retVal.fullBatches  = m_fullBatches.load(std::memory_order_relaxed);
+    if (m_pipeline) {
+        retVal.pipeline = m_pipeline->statistics();
+    }
+    return retVal;
+}
+
+inline bool UDPReceiver::addToPipeline(const char *data,
+                                       size_t length,
+                                       const struct sockaddr_storage &remote,
+                                       std::chrono::system_clock::time_point timestamp) noexcept {
+    const struct sockaddr_in *remoteIPv4 = reinterpret_cast<const struct sockaddr_in *>(&remote); // NOLINT
+    const unsigned long RECVFROM_IP{remoteIPv4->sin_addr.s_addr};
+    const uint16_t RECVFROM_PORT{ntohs(remoteIPv4->sin_port)};
+
+    // Check if the bytes actually came from us.
+    bool sentFromUs{false};
+    {
+        auto pos                   = m_listOfLocalIPAddresses.find(RECVFROM_IP);
+        const bool sentFromLocalIP = (pos != m_listOfLocalIPAddresses.end() && (*pos == RECVFROM_IP));
+        sentFromUs                 = sentFromLocalIP && (m_localSendFromPort == RECVFROM_PORT);
+    }
+
+    // Create a pipeline entry to be processed concurrently.
+    bool retVal{false};
+    if (!sentFromUs && m_pipeline) {
+        try {
+            // Format the sender address only when the sender changes.
+            if (m_lastRemoteAddress.empty() || (m_lastRemoteIP != RECVFROM_IP) || (m_lastRemotePort != RECVFROM_PORT)) {
+                // Transform sender address to C-string.
+                std::array<char, INET_ADDRSTRLEN> remoteAddress{};
+                ::inet_ntop(remote.ss_family, &(remoteIPv4->sin_addr), remoteAddress.data(), remoteAddress.max_size());
+                m_lastRemoteAddress = std::string(remoteAddress.data()) + ':' + std::to_string(RECVFROM_PORT);
+                m_lastRemoteIP      = RECVFROM_IP;
+                m_lastRemotePort    = RECVFROM_PORT;
+            }
+
+            // The entry holds the buffers of an entry that was processed before, so assigning rarely allocates.
+            m_entry.m_data.assign(data, length);
+            m_entry.m_from.assign(m_lastRemoteAddress);
+            m_entry.m_sampleTime = timestamp;
+
+            // Store entry in queue.
+            m_pipeline->add(std::move(m_entry));
+            retVal = true;
+        } catch (...) {} // LCOV_EXCL_LINE
+    }
+    return retVal;
+}
+
 inline void UDPReceiver::readFromSocket() noexcept {
+#ifdef __linux__
+    if (1 < m_batchSize) {
+        readBatchesFromSocket();
+        return;
+    }
+#endif
+
     // Create buffer to store data from socket.
     constexpr uint16_t MAX_LENGTH = static_cast<uint16_t>(UDPPacketSizeConstraints::MAX_SIZE_UDP_PACKET)
                                     - static_cast<uint16_t>(UDPPacketSizeConstraints::SIZE_IPv4_HEADER)
@@ -10476,9 +11100,6 @@ inline void UDPReceiver::readFromSocket() noexcept {
     fd_set setOfFiledescriptorsToReadFrom{};
 
     // Sender address and port.
-    constexpr uint16_t MAX_ADDR_SIZE{1024};
-    std::array<char, MAX_ADDR_SIZE> remoteAddress{};
-
     struct sockaddr_storage remote {};
     socklen_t addrLength{sizeof(remote)};
 
@@ -10506,8 +11127,10 @@ inline void UDPReceiver::readFromSocket() noexcept {
                                        0,
                                        reinterpret_cast<struct sockaddr *>(&remote), // NOLINT
                                        reinterpret_cast<socklen_t *>(&addrLength));  // NOLINT
+                m_receiveCalls.fetch_add(1, std::memory_order_relaxed);
 
                 if ((0 < bytesRead) && (nullptr != m_delegate)) {
+                    m_packets.fetch_add(1, std::memory_order_relaxed);
 #ifdef __linux__
                     std::chrono::system_clock::time_point timestamp;
                     struct timeval receivedTimeStamp {};
@@ -10524,46 +11147,153 @@ inline void UDPReceiver::readFromSocket() noexcept {
                     std::chrono::system_clock::time_point timestamp = std::chrono::system_clock::now();
 #endif
 
-                    // Transform sender address to C-string.
-                    ::inet_ntop(remote.ss_family,
-                                &((reinterpret_cast<struct sockaddr_in *>(&remote))->sin_addr), // NOLINT
-                                remoteAddress.data(),
-                                remoteAddress.max_size());
-                    const unsigned long RECVFROM_IP{reinterpret_cast<struct sockaddr_in *>(&remote)->sin_addr.s_addr}; // NOLINT
-                    const uint16_t RECVFROM_PORT{ntohs(reinterpret_cast<struct sockaddr_in *>(&remote)->sin_port)};    // NOLINT
-
-                    // Check if the bytes actually came from us.
-                    bool sentFromUs{false};
-                    {
-                        auto pos                   = m_listOfLocalIPAddresses.find(RECVFROM_IP);
-                        const bool sentFromLocalIP = (pos != m_listOfLocalIPAddresses.end() && (*pos == RECVFROM_IP));
-                        sentFromUs                 = sentFromLocalIP && (m_localSendFromPort == RECVFROM_PORT);
-                    }
-
-                    // Create a pipeline entry to be processed concurrently.
-                    if (!sentFromUs) {
-                        PipelineEntry pe;
-                        pe.m_data       = std::string(buffer.data(), static_cast<size_t>(bytesRead));
-                        pe.m_from       = std::string(remoteAddress.data()) + ':' + std::to_string(RECVFROM_PORT);
-                        pe.m_sampleTime = timestamp;
-
-                        // Store entry in queue.
-                        if (m_pipeline) {
-                            m_pipeline->add(std::move(pe));
-                        }
-                    }
+                    addToPipeline(buffer.data(), static_cast<size_t>(bytesRead), remote, timestamp);
                     totalBytesRead += bytesRead;
                 }
             } while (!m_isBlockingSocket && (bytesRead > 0));
         }
 
         if (static_cast<int32_t>(totalBytesRead) > 0) {
+            m_batches.fetch_add(1, std::memory_order_relaxed);
             if (m_pipeline) {
                 m_pipeline->notifyAll();
             }
         }
     }
 }
+
+#ifdef __linux__
+inline void UDPReceiver::readBatchesFromSocket() noexcept {
+    constexpr uint16_t MAX_LENGTH = static_cast<uint16_t>(UDPPacketSizeConstraints::MAX_SIZE_UDP_PACKET)
+                                    - static_cast<uint16_t>(UDPPacketSizeConstraints::SIZE_IPv4_HEADER)
+                                    - static_cast<uint16_t>(UDPPacketSizeConstraints::SIZE_UDP_HEADER);
+    constexpr size_t CONTROL_LENGTH{CMSG_SPACE(sizeof(struct timeval))};
+    const size_t BATCH_SIZE{m_batchSize};
+
+    // Allocate the slab of buffers and the message headers pointing into it once for the lifetime of the thread.
+    std::vector<char> slab;
+    std::vector<char> control;
+    std::vector<struct iovec> iovecs;
+    std::vector<struct sockaddr_storage> remotes;
+    std::vector<struct mmsghdr> messages;
+    try {
+        slab.resize(BATCH_SIZE * MAX_LENGTH);
+        control.resize(BATCH_SIZE * CONTROL_LENGTH);
+        iovecs.resize(BATCH_SIZE);
+        remotes.resize(BATCH_SIZE);
+        messages.resize(BATCH_SIZE);
+    } catch (...) { // LCOV_EXCL_LINE
+        std::cerr << "[cluon::UDPReceiver] Failed to allocate buffers for " << BATCH_SIZE << " datagrams per batch, receiving one datagram per call" << std::endl; // LCOV_EXCL_LINE
+        std::vector<char>().swap(slab);    // LCOV_EXCL_LINE
+        std::vector<char>().swap(control); // LCOV_EXCL_LINE
+        // Fall back to recvfrom, which indicates to the main thread when it is ready.
+        m_readFromSocketThreadRunning.store(false); // LCOV_EXCL_LINE
+        m_batchSize = 1;                            // LCOV_EXCL_LINE
+        readFromSocket();                           // LCOV_EXCL_LINE
+        return;                                     // LCOV_EXCL_LINE
+    }
+    for (size_t i{0}; i < BATCH_SIZE; i++) {
+        iovecs[i].iov_base = &slab[i * MAX_LENGTH];
+        iovecs[i].iov_len  = MAX_LENGTH;
+    }
+
+    // SIOCGSTAMP only reports the last datagram of a batch; let the kernel attach the time stamp to every datagram instead.
+    int YES{1};
+    const bool hasTimeStamps{0 == ::setsockopt(m_socket, SOL_SOCKET, SO_TIMESTAMP, &YES, sizeof(YES))};
+
+    struct timeval timeout {};
+    fd_set setOfFiledescriptorsToReadFrom{};
+
+    // Indicate to main thread that we are ready.
+    m_readFromSocketThreadRunning.store(true);
+
+    while (m_readFromSocketThreadRunning.load()) {
+        timeout.tv_sec  = 0;
+        timeout.tv_usec = 20 * 1000; // Check for new data with 50Hz.
+
+        FD_ZERO(&setOfFiledescriptorsToReadFrom);          // NOLINT
+        FD_SET(m_socket, &setOfFiledescriptorsToReadFrom); // NOLINT
+        ::select(m_socket + 1, &setOfFiledescriptorsToReadFrom, nullptr, nullptr, &timeout);
+        if (!FD_ISSET(m_socket, &setOfFiledescriptorsToReadFrom)) { // NOLINT
+            continue;
+        }
+
+        // Hand over full batches until the socket is drained.
+        bool full{true};
+        while (full && m_readFromSocketThreadRunning.load()) {
+            size_t filled{0};
+            const auto deadline{std::chrono::steady_clock::now() + m_batchTimeout};
+            while (filled < BATCH_SIZE) {
+                // The kernel overwrites the lengths of the address and the control data, so reset them for every call.
+                for (size_t i{filled}; i < BATCH_SIZE; i++) {
+                    std::memset(&messages[i], 0, sizeof(messages[i]));
+                    messages[i].msg_hdr.msg_name       = &remotes[i];
+                    messages[i].msg_hdr.msg_namelen    = sizeof(remotes[i]);
+                    messages[i].msg_hdr.msg_iov        = &iovecs[i];
+                    messages[i].msg_hdr.msg_iovlen     = 1;
+                    messages[i].msg_hdr.msg_control    = &control[i * CONTROL_LENGTH];
+                    messages[i].msg_hdr.msg_controllen = CONTROL_LENGTH;
+                }
+                const int received{::recvmmsg(m_socket, &messages[filled], static_cast<unsigned int>(BATCH_SIZE - filled), MSG_DONTWAIT, nullptr)};
+                m_receiveCalls.fetch_add(1, std::memory_order_relaxed);
+                if (0 < received) {
+                    filled += static_cast<size_t>(received);
+                }
+                if ((BATCH_SIZE == filled) || (0 == m_batchTimeout.count())) {
+                    break;
+                }
+
+                // Wait for the rest of the batch until the deadline.
+                const auto remaining{std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now())};
+                if (0 >= remaining.count()) {
+                    break;
+                }
+                timeout.tv_sec  = static_cast<time_t>(remaining.count() / 1000000);
+                timeout.tv_usec = static_cast<suseconds_t>(remaining.count() % 1000000);
+                FD_ZERO(&setOfFiledescriptorsToReadFrom);          // NOLINT
+                FD_SET(m_socket, &setOfFiledescriptorsToReadFrom); // NOLINT
+                if (0 >= ::select(m_socket + 1, &setOfFiledescriptorsToReadFrom, nullptr, nullptr, &timeout)) {
+                    break;
+                }
+            }
+            full = (BATCH_SIZE == filled);
+            if (0 == filled) {
+                break;
+            }
+
+            m_packets.fetch_add(filled, std::memory_order_relaxed);
+            m_batches.fetch_add(1, std::memory_order_relaxed);
+            if (full) {
+                m_fullBatches.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            bool added{false};
+            if (nullptr != m_delegate) {
+                const std::chrono::system_clock::time_point now{std::chrono::system_clock::now()};
+                for (size_t i{0}; i < filled; i++) {
+                    std::chrono::system_clock::time_point timestamp{now};
+                    if (hasTimeStamps) {
+                        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&messages[i].msg_hdr); nullptr != cmsg; cmsg = CMSG_NXTHDR(&messages[i].msg_hdr, cmsg)) {
+                            if ((SOL_SOCKET == cmsg->cmsg_level) && (SCM_TIMESTAMP == cmsg->cmsg_type)) {
+                                struct timeval receivedTimeStamp {};
+                                std::memcpy(&receivedTimeStamp, CMSG_DATA(cmsg), sizeof(receivedTimeStamp)); // NOLINT
+                                // Transform struct timeval to C++ chrono.
+                                std::chrono::time_point<std::chrono::system_clock, std::chrono::microseconds> transformedTimePoint(
+                                    std::chrono::microseconds(receivedTimeStamp.tv_sec * 1000000L + receivedTimeStamp.tv_usec));
+                                timestamp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(transformedTimePoint);
+                            }
+                        }
+                    }
+                    added = addToPipeline(&slab[i * MAX_LENGTH], messages[i].msg_len, remotes[i], timestamp) || added;
+                }
+            }
+            if (added) {
+                m_pipeline->notifyAll();
+            }
+        }
+    }
+}
+#endif
 } // namespace cluon
 /*
  * Copyright (C) 2017-2018  Christian Berger
@@ -11268,6 +11998,7 @@ inline std::size_t ToProtoVisitor::toVarInt(std::ostream &out, uint64_t v) noexc
  */
 
 //#include "cluon/FromProtoVisitor.hpp"
+//#include "cluon/Envelope.hpp"
 
 #include <cstddef>
 #include <cstring>
@@ -11340,6 +12071,58 @@ inline void FromProtoVisitor::decodeFrom(std::istream &in) noexcept {
     }
 }
 
+template<typename T>
+inline bool FromProtoVisitor::decodeFrom(const char *data, std::size_t length, T &v) noexcept {
+    if ((nullptr == data) && (0 < length)) {
+        return false;
+    }
+    const char *pos{data};
+    const char *end{data + length};
+    uint8_t protoType{0};
+    bool retVal{true};
+    m_callToDecodeFromWithDirectVisit = true;
+    while (pos < end) {
+        if (!readProtoField(pos, end, m_fieldId, protoType, m_value)) {
+            retVal = false;
+            break;
+        }
+        m_protoType = static_cast<ProtoConstants>(protoType);
+        switch (m_protoType) {
+            case ProtoConstants::VARINT:
+            {
+                v.accept(m_fieldId, *this);
+            }
+            break;
+            case ProtoConstants::EIGHT_BYTES:
+            {
+                std::memcpy(m_doubleValue.buffer.data(), pos, sizeof(double));
+                m_doubleValue.uint64Value = le64toh(m_doubleValue.uint64Value);
+                pos += sizeof(double);
+                v.accept(m_fieldId, *this);
+            }
+            break;
+            case ProtoConstants::FOUR_BYTES:
+            {
+                std::memcpy(m_floatValue.buffer.data(), pos, sizeof(float));
+                m_floatValue.uint32Value = le32toh(m_floatValue.uint32Value);
+                pos += sizeof(float);
+                v.accept(m_fieldId, *this);
+            }
+            break;
+            case ProtoConstants::LENGTH_DELIMITED:
+            {
+                m_stringData = pos;
+                pos += m_value;
+                v.accept(m_fieldId, *this);
+            }
+            break;
+        }
+    }
+    m_stringData                      = nullptr;
+    m_callToDecodeFromWithDirectVisit = false;
+    return retVal;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 inline FromProtoVisitor &FromProtoVisitor::operator=(const FromProtoVisitor &other) noexcept {
@@ -11537,7 +12320,7 @@ inline void FromProtoVisitor::visit(uint32_t id, std::string &&typeName, std::st
     (void)typeName;
     (void)name;
     if (m_callToDecodeFromWithDirectVisit) {
-        v = std::string(m_stringValue.data(), static_cast<std::size_t>(m_value));
+        v.assign(m_stringData, static_cast<std::size_t>(m_value));
     }
     else if (m_mapOfKeyValues.count(id) > 0) {
         try {
@@ -13940,19 +14723,36 @@ inline void ToMsgPackVisitor::visit(uint32_t id, std::string &&typeName, std::st
 
 namespace cluon {
 
-inline OD4Session::OD4Session(uint16_t CID, std::function<void(cluon::data::Envelope &&envelope)> delegate) noexcept
+inline OD4Session::OD4Session(uint16_t CID,
+                              std::function<void(cluon::data::Envelope &&envelope)> delegate,
+                              uint16_t receiveBatchSize,
+                              std::chrono::microseconds receiveBatchTimeout,
+                              size_t receiveQueueCapacity,
+                              PipelineOverflowPolicy overflowPolicy) noexcept
     : m_receiver{nullptr}
     , m_sender{"225.0.0." + std::to_string(CID), 12175}
     , m_delegate(std::move(delegate))
     , m_mapOfDataTriggeredDelegatesMutex{}
-    , m_mapOfDataTriggeredDelegates{} {
+    , m_mapOfDataTriggeredDelegates{nullptr}
+    , m_activeDispatches{0}
+    , m_retiredDelegateTables{} {
     m_receiver = std::make_unique<cluon::UDPReceiver>(
         "225.0.0." + std::to_string(CID),
         12175,
         [this](std::string &&data, std::string &&from, std::chrono::system_clock::time_point &&timepoint) {
             this->callback(std::move(data), std::move(from), std::move(timepoint));
         },
-        m_sender.getSendFromPort() /* passing our local send from port to the UDPReceiver to filter out our own bytes */);
+        m_sender.getSendFromPort() /* passing our local send from port to the UDPReceiver to filter out our own bytes */,
+        receiveBatchSize,
+        receiveBatchTimeout,
+        receiveQueueCapacity,
+        overflowPolicy);
+}
+
+inline OD4Session::~OD4Session() noexcept {
+    // Stop receiving before the delegates go away.
+    m_receiver.reset();
+    delete m_mapOfDataTriggeredDelegates.exchange(nullptr);
 }
 
 inline void OD4Session::timeTrigger(float freq, std::function<bool()> delegate) noexcept {
@@ -13985,55 +14785,105 @@ inline void OD4Session::timeTrigger(float freq, std::function<bool()> delegate)
 }
 
 inline bool OD4Session::dataTrigger(int32_t messageIdentifier, std::function<void(cluon::data::Envelope &&envelope)> delegate) noexcept {
+    DecodingDelegate decodingDelegate{nullptr};
+    if (nullptr != delegate) {
+        try {
+            decodingDelegate = [this, delegate](const EnvelopeMeta &meta, const char *payload, std::size_t payloadLength) {
+                delegate(toEnvelope(meta, payload, payloadLength));
+            };
+        } catch (...) { // LCOV_EXCL_LINE
+            return false; // LCOV_EXCL_LINE
+        }
+    }
+    return setDataTriggeredDelegate(messageIdentifier, std::move(decodingDelegate));
+}
+
+inline bool OD4Session::setDataTriggeredDelegate(int32_t messageIdentifier, DecodingDelegate &&delegate) noexcept {
     bool retVal{false};
     if (nullptr == m_delegate) {
         try {
             std::lock_guard<std::mutex> lck{m_mapOfDataTriggeredDelegatesMutex};
-            if ((nullptr == delegate) && (m_mapOfDataTriggeredDelegates.count(messageIdentifier) > 0)) {
-                auto element = m_mapOfDataTriggeredDelegates.find(messageIdentifier);
-                if (element != m_mapOfDataTriggeredDelegates.end()) {
-                    m_mapOfDataTriggeredDelegates.erase(element);
-                }
+            const DelegateTable *current{m_mapOfDataTriggeredDelegates.load()};
+            std::unique_ptr<DelegateTable> next{(nullptr != current) ? new DelegateTable(*current) : new DelegateTable()};
+            if (nullptr == delegate) {
+                next->erase(messageIdentifier);
             } else {
-                m_mapOfDataTriggeredDelegates[messageIdentifier] = delegate;
+                (*next)[messageIdentifier] = std::make_shared<const DecodingDelegate>(std::move(delegate));
+            }
+            m_retiredDelegateTables.reserve(m_retiredDelegateTables.size() + 1);
+
+            // Dispatches that start from now on only see the new table.
+            m_retiredDelegateTables.emplace_back(m_mapOfDataTriggeredDelegates.exchange(next.release()));
+            if (0 == m_activeDispatches.load()) {
+                m_retiredDelegateTables.clear();
             }
+            m_hasRetiredDelegateTables.store(!m_retiredDelegateTables.empty());
             retVal = true;
         } catch (...) {} // LCOV_EXCL_LINE
     }
     return retVal;
 }
 
+inline cluon::data::Envelope OD4Session::toEnvelope(const EnvelopeMeta &meta, const char *payload, std::size_t payloadLength) noexcept {
+    cluon::data::Envelope env;
+    try {
+        // The scratch string keeps its capacity, so only the Envelope's own copy of the payload allocates.
+        thread_local std::string scratch;
+        scratch.assign(payload, payloadLength);
+        env.serializedData(scratch);
+    } catch (...) {} // LCOV_EXCL_LINE
+    env.dataType(meta.dataType).sent(meta.sent).received(meta.received).sampleTimeStamp(meta.sampleTimeStamp).senderStamp(meta.senderStamp);
+    return env;
+}
+
 inline void OD4Session::callback(std::string &&data, std::string && /*from*/, std::chrono::system_clock::time_point &&timepoint) noexcept {
-    size_t numberOfDataTriggeredDelegates{0};
-    {
-        try {
-            std::lock_guard<std::mutex> lck{m_mapOfDataTriggeredDelegatesMutex};
-            numberOfDataTriggeredDelegates = m_mapOfDataTriggeredDelegates.size();
-        } catch (...) {} // LCOV_EXCL_LINE
-    }
-    // Only unpack the envelope when it needs to be post-processed.
-    if ((nullptr != m_delegate) || (0 < numberOfDataTriggeredDelegates)) {
-        std::stringstream sstr(data);
-        auto retVal = extractEnvelope(sstr);
+    dispatch(data, timepoint);
+}
 
-        if (retVal.first) {
-            cluon::data::Envelope env{retVal.second};
-            env.received(cluon::time::convert(timepoint));
+inline void OD4Session::dispatch(const std::string &data, const std::chrono::system_clock::time_point &timepoint) noexcept {
+    EnvelopeMeta meta;
+    const char *payload{nullptr};
+    std::size_t payloadLength{0};
 
-            // "Catch all"-delegate.
-            if (nullptr != m_delegate) {
-                m_delegate(std::move(env));
-            } else {
-                try {
-                    // Data triggered-delegates.
-                    std::lock_guard<std::mutex> lck{m_mapOfDataTriggeredDelegatesMutex};
-                    if (m_mapOfDataTriggeredDelegates.count(env.dataType()) > 0) {
-                        m_mapOfDataTriggeredDelegates[env.dataType()](std::move(env));
-                    }
-                } catch (...) {} // LCOV_EXCL_LINE
-            }
+    // "Catch all"-delegate.
+    if (nullptr != m_delegate) {
+        if (extractEnvelopeView(data.data(), data.size(), meta, payload, payloadLength)) {
+            meta.received = cluon::time::convert(timepoint);
+            m_delegate(toEnvelope(meta, payload, payloadLength));
+        }
+        return;
+    }
+
+    // Data triggered-delegates: read only the header first and drop data types without delegate before decoding anything.
+    int32_t dataType{0};
+    uint32_t senderStamp{0};
+    if (!extractEnvelopeHeader(data.data(), data.size(), dataType, senderStamp)) {
+        return;
+    }
+    // The table cannot be deleted before the counter is decremented again, as replaced tables are only deleted
+    // under the mutex by a thread that sees no running dispatch after the new table was published.
+    m_activeDispatches.fetch_add(1);
+    const DelegateTable *table{m_mapOfDataTriggeredDelegates.load()};
+    if (nullptr != table) {
+        auto element = table->find(dataType);
+        if ((element != table->end()) && extractEnvelopeView(data.data(), data.size(), meta, payload, payloadLength)) {
+            meta.received = cluon::time::convert(timepoint);
+            try {
+                (*element->second)(meta, payload, payloadLength);
+            } catch (...) {} // LCOV_EXCL_LINE
         }
     }
+    if ((1 == m_activeDispatches.fetch_sub(1)) && m_hasRetiredDelegateTables.load()) {
+        // The last running dispatch deletes the tables that were replaced while it ran, unless a delegate is being
+        // set right now; that thread deletes them itself or leaves them to the next dispatch.
+        try {
+            std::unique_lock<std::mutex> lck{m_mapOfDataTriggeredDelegatesMutex, std::try_to_lock};
+            if (lck.owns_lock() && (0 == m_activeDispatches.load())) {
+                m_retiredDelegateTables.clear();
+                m_hasRetiredDelegateTables.store(false);
+            }
+        } catch (...) {} // LCOV_EXCL_LINE
+    }
 }
 
 inline void OD4Session::send(cluon::data::Envelope &&envelope) noexcept {
@@ -14048,6 +14898,10 @@ inline bool OD4Session::isRunning() noexcept {
     return m_receiver->isRunning();
 }
 
+inline UDPReceiver::Statistics OD4Session::receiverStatistics() const noexcept {
+    return m_receiver->statistics();
+}
+
 } // namespace cluon
 /*
  * Copyright (C) 2017-2018  Christian Berger
@@ -14805,6 +15659,7 @@ inline float Player::checkRefillingCache(const uint32_t &numberOfEntries, float
     #include <sys/stat.h>
     #include <sys/time.h>
     #include <sys/types.h>
+    #include <time.h>
     #include <unistd.h>
 #endif
 // clang-format on
@@ -14813,6 +15668,7 @@ inline float Player::checkRefillingCache(const uint32_t &numberOfEntries, float
 #include <cstring>
 #include <iostream>
 #include <fstream>
+#include <thread>
 
 #if !defined(__APPLE__) && !defined(__OpenBSD__) && (defined(_SEM_SEMUN_UNDEFINED) || !defined(__FreeBSD__))
 union semun {
@@ -14939,6 +15795,14 @@ inline void SharedMemory::wait() noexcept {
 #endif
 }
 
+inline bool SharedMemory::waitFor(const std::chrono::microseconds &timeout) noexcept {
+#ifdef WIN32
+    return waitForWIN32(timeout);
+#else
+    return (m_usePOSIX ? waitForPOSIX(timeout) : waitForSysV(timeout));
+#endif
+}
+
 inline void SharedMemory::notifyAll() noexcept {
 #ifdef WIN32
     notifyAllWIN32();
@@ -15224,6 +16088,18 @@ inline void SharedMemory::waitWIN32() noexcept {
     }
 }
 
+inline bool SharedMemory::waitForWIN32(const std::chrono::microseconds &timeout) noexcept {
+    bool retVal{false};
+    if (nullptr != __conditionEvent) {
+        const DWORD result{WaitForSingleObject(__conditionEvent, static_cast<DWORD>((timeout.count() + 999) / 1000))};
+        retVal = (WAIT_OBJECT_0 == result);
+        if ((WAIT_OBJECT_0 != result) && (WAIT_TIMEOUT != result)) {
+            m_broken.store(true);
+        }
+    }
+    return retVal;
+}
+
 inline void SharedMemory::notifyAllWIN32() noexcept {
     if (nullptr != __conditionEvent) {
         if (/* Testing for equality with 0 is correct according to MSDN reference. */ 0 == SetEvent(__conditionEvent)) {
@@ -15449,6 +16325,33 @@ inline void SharedMemory::waitPOSIX() noexcept {
 #endif
 }
 
+inline bool SharedMemory::waitForPOSIX(const std::chrono::microseconds &timeout) noexcept {
+    bool retVal{false};
+#if !defined(__NetBSD__) && !defined(__OpenBSD__)
+    if (nullptr != m_sharedMemoryHeader) {
+        // The deadline is absolute and measured with the clock of the shared condition.
+        struct timespec deadline {};
+#ifdef __APPLE__
+        ::clock_gettime(CLOCK_REALTIME, &deadline);
+#else
+        ::clock_gettime(CLOCK_MONOTONIC, &deadline);
+#endif
+        const int64_t NANOSECONDS{static_cast<int64_t>(deadline.tv_nsec) + (timeout.count() % 1000000) * 1000};
+        deadline.tv_sec += static_cast<time_t>(timeout.count() / 1000000 + NANOSECONDS / 1000000000);
+        deadline.tv_nsec = static_cast<long>(NANOSECONDS % 1000000000);
+
+        lock();
+        const int result{::pthread_cond_timedwait(&(m_sharedMemoryHeader->__condition), &(m_sharedMemoryHeader->__mutex), &deadline)};
+        retVal = (0 == result);
+        if ((0 != result) && (ETIMEDOUT != result)) {
+            m_broken.store(true); // LCOV_EXCL_LINE
+        }
+        unlock();
+    }
+#endif
+    return retVal;
+}
+
 inline void SharedMemory::notifyAllPOSIX() noexcept {
 #if !defined(__NetBSD__) && !defined(__OpenBSD__)
     if (nullptr != m_sharedMemoryHeader) {
@@ -15801,6 +16704,48 @@ inline void SharedMemory::waitSysV() noexcept {
     }
 }
 
+inline bool SharedMemory::waitForSysV(const std::chrono::microseconds &timeout) noexcept {
+    bool retVal{false};
+    if (-1 != m_conditionIDSysV) {
+        constexpr int NUMBER_OF_SEMAPHORE_TO_CONTROL{0};
+        constexpr int VALUE{0}; // Wait for this semaphore to become 0.
+
+        struct sembuf tmp;
+        tmp.sem_num = NUMBER_OF_SEMAPHORE_TO_CONTROL;
+        tmp.sem_op  = VALUE;
+#ifdef __linux__
+        tmp.sem_flg = 0;
+        struct timespec relative {};
+        relative.tv_sec  = static_cast<time_t>(timeout.count() / 1000000);
+        relative.tv_nsec = static_cast<long>((timeout.count() % 1000000) * 1000);
+        retVal           = (0 == ::semtimedop(m_conditionIDSysV, &tmp, 1, &relative));
+        if (!retVal && (EAGAIN != errno) && (EINTR != errno)) {
+            std::cerr << "[cluon::SharedMemory (SysV)] Failed to wait on semaphore (0x" << std::hex << m_conditionKeySysV << std::dec
+                      << "): " << ::strerror(errno) << " (" << errno << ")" << std::endl;
+            m_broken.store(true);
+        }
+#else
+        // Without semtimedop, poll the semaphore until the timeout expires.
+        tmp.sem_flg = IPC_NOWAIT;
+        const std::chrono::steady_clock::time_point DEADLINE{std::chrono::steady_clock::now() + timeout};
+        do {
+            if (0 == ::semop(m_conditionIDSysV, &tmp, 1)) {
+                retVal = true;
+                break;
+            }
+            if (EAGAIN != errno) {
+                std::cerr << "[cluon::SharedMemory (SysV)] Failed to wait on semaphore (0x" << std::hex << m_conditionKeySysV << std::dec
+                          << "): " << ::strerror(errno) << " (" << errno << ")" << std::endl;
+                m_broken.store(true);
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        } while (std::chrono::steady_clock::now() < DEADLINE);
+#endif
+    }
+    return retVal;
+}
+
 inline void SharedMemory::notifyAllSysV() noexcept {
     if (-1 != m_conditionIDSysV) {
         {
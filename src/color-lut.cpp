@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "color-lut.hpp"
+#include "cpu-dispatch.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace
+{
+// Bits of a table entry
+const uint8_t firstClass = 1;
+const uint8_t secondClass = 2;
+} // namespace
+
+// std::min and std::max take their arguments by reference, which needs the constants defined
+const int ColorLut::MIN_BITS;
+const int ColorLut::MAX_BITS;
+
+ColorLut::ColorLut(const HsvRange &first, const HsvRange &second, int bitsPerChannel)
+    : m_bits(std::min(std::max(bitsPerChannel, MIN_BITS), MAX_BITS))
+    , m_table(static_cast<size_t>(1) << (3 * m_bits), 0)
+{
+    const int shift{8 - m_bits};
+    const int bins{1 << m_bits};
+    const uint32_t colorsPerBin{1u << (3 * shift)};
+    const HsvThresholdRow kernel{visionKernels().hsvThresholdRow};
+
+    // Classify every color exactly, one red bin at a time so that the votes only need a plane of counters
+    std::vector<uint16_t> firstVotes(static_cast<size_t>(bins) * bins);
+    std::vector<uint16_t> secondVotes(static_cast<size_t>(bins) * bins);
+    std::array<uint8_t, 4 * 256> row;
+    std::array<uint8_t, 256> firstMask;
+    std::array<uint8_t, 256> secondMask;
+    for (int rBin = 0; rBin < bins; rBin++)
+    {
+        std::fill(firstVotes.begin(), firstVotes.end(), 0);
+        std::fill(secondVotes.begin(), secondVotes.end(), 0);
+        for (int r = rBin << shift; r < ((rBin + 1) << shift); r++)
+        {
+            for (int g = 0; g < 256; g++)
+            {
+                for (int b = 0; b < 256; b++)
+                {
+                    row[4 * b + 0] = static_cast<uint8_t>(b);
+                    row[4 * b + 1] = static_cast<uint8_t>(g);
+                    row[4 * b + 2] = static_cast<uint8_t>(r);
+                    row[4 * b + 3] = 255;
+                }
+                kernel(row.data(), 256, first, second, firstMask.data(), secondMask.data());
+                for (int b = 0; b < 256; b++)
+                {
+                    const size_t bin{static_cast<size_t>(((g >> shift) << m_bits) | (b >> shift))};
+                    firstVotes[bin] = static_cast<uint16_t>(firstVotes[bin] + (firstMask[b] != 0 ? 1 : 0));
+                    secondVotes[bin] = static_cast<uint16_t>(secondVotes[bin] + (secondMask[b] != 0 ? 1 : 0));
+                }
+            }
+        }
+        // A bin belongs to a range when the strict majority of its colors do
+        uint8_t *plane = m_table.data() + (static_cast<size_t>(rBin) << (2 * m_bits));
+        for (size_t bin = 0; bin < firstVotes.size(); bin++)
+        {
+            plane[bin] = static_cast<uint8_t>(((2u * firstVotes[bin] > colorsPerBin) ? firstClass : 0) | ((2u * secondVotes[bin] > colorsPerBin) ? secondClass : 0));
+        }
+    }
+}
+
+void ColorLut::classify(const cv::Mat &bgra, cv::Mat &firstMask, cv::Mat &secondMask) const
+{
+    CV_Assert(bgra.type() == CV_8UC4);
+    CV_Assert(firstMask.type() == CV_8UC1 && firstMask.size() == bgra.size());
+    CV_Assert(secondMask.type() == CV_8UC1 && secondMask.size() == bgra.size());
+
+    for (int y = 0; y < bgra.rows; y++)
+    {
+        classifyRow(bgra.ptr<uint8_t>(y), bgra.cols, firstMask.ptr<uint8_t>(y), secondMask.ptr<uint8_t>(y));
+    }
+}
+
+void ColorLut::classifyRow(const uint8_t *bgra, int width, uint8_t *firstMask, uint8_t *secondMask) const
+{
+    const int shift{8 - m_bits};
+    const uint8_t *table = m_table.data();
+    for (int x = 0; x < width; x++, bgra += 4)
+    {
+        const uint8_t c{table[((bgra[2] >> shift) << (2 * m_bits)) | ((bgra[1] >> shift) << m_bits) | (bgra[0] >> shift)]};
+        // Turn the class bits into 0x00 or 0xff without branches
+        firstMask[x] = static_cast<uint8_t>(-(c & firstClass));
+        secondMask[x] = static_cast<uint8_t>(-((c & secondClass) >> 1));
+    }
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COLOR_LUT_HPP
+#define COLOR_LUT_HPP
+
+#include "hsv-threshold.hpp"
+
+#include <opencv2/core/core.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// Lookup table that maps a quantized BGR color to its membership in two HSV ranges.
+// Every bin holds the majority vote of the exact HSV classification of all colors that fall into it,
+// so with 8 bits per channel the masks are identical to hsvThreshold().
+class ColorLut
+{
+   public:
+    static const int MIN_BITS = 4;
+    static const int MAX_BITS = 8;
+
+    ColorLut(const HsvRange &first, const HsvRange &second, int bitsPerChannel);
+
+    // Classify a BGRA image; both masks must be preallocated as CV_8UC1 with the size of the image
+    void classify(const cv::Mat &bgra, cv::Mat &firstMask, cv::Mat &secondMask) const;
+    // Classify one row of width BGRA pixels
+    void classifyRow(const uint8_t *bgra, int width, uint8_t *firstMask, uint8_t *secondMask) const;
+
+    int bitsPerChannel() const
+    {
+        return m_bits;
+    }
+
+    size_t size() const
+    {
+        return m_table.size();
+    }
+
+   private:
+    int m_bits;
+    std::vector<uint8_t> m_table;
+};
+
+#endif
@@ -0,0 +1,681 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cone-detection.hpp"
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+// Constants for color and direction
+const char blue = 'B';
+const char yellow = 'Y';
+const char right = 'R';
+const char left = 'L';
+// Constant storing the number that is used to calculate the steering wheel angle
+const double magicNumber = 0.145540;
+// Range for the angle calculation
+const double threshold = 0.08;
+const double threshold2 = 0.9;
+
+SteeringController::SteeringController()
+    : blueCones()
+    , yellowCones()
+    , lastBlueCone()
+    , lastYellowCone()
+    , isBlue(false)
+    , isYellow(false)
+    , bLeft(false)
+    , yLeft(false)
+    , fBlue(false)
+    , fYellow(false)
+    , isMirrored(true)
+    , steeringWheelAngle(0.0)
+    , variable(0)
+    , blueTrack()
+    , yellowTrack()
+{
+}
+
+void SteeringController::calculatePerformance(double groundSteering)
+{
+    // If original steering angle is 0, check if we are in range +/- 0.05
+    if (groundSteering == 0)
+    {
+        if (steeringWheelAngle < 0.05 && steeringWheelAngle > -0.05)
+        {
+            variable++;
+        }
+    }
+    // If original steering angle is greater than 0, check if we are within 50%
+    else if (groundSteering > 0)
+    {
+        if (groundSteering * 0.5 < steeringWheelAngle && steeringWheelAngle < groundSteering * 1.5)
+        {
+            variable++;
+        }
+    }
+    // If original steering angle is less than 0, check if we are within 50%
+    else
+    {
+        if (groundSteering * 0.5 > steeringWheelAngle && steeringWheelAngle > groundSteering * 1.5)
+        {
+            variable++;
+        }
+    }
+}
+
+// High and low global variable values for blue and yellow colors
+cv::Scalar blueLow = cv::Scalar(100, 50, 30);
+cv::Scalar blueHigh = cv::Scalar(120, 255, 255);
+cv::Scalar yellowLow = cv::Scalar(17, 60, 70);
+cv::Scalar yellowHigh = cv::Scalar(40, 200, 200);
+
+// Create a point for the center of the car
+cv::Point car = cv::Point(320, 0);
+
+// Region of the frame that contains the cones
+const cv::Rect roi = cv::Rect(0, 240, 640, 100);
+// Number of rows the 7x7 blur kernel reads above and below the region
+const int blurMargin = SeparableBlur::RADIUS;
+
+namespace
+{
+// Blobs of a color that is not searched in a frame
+const std::vector<Blob> noBlobs;
+
+// Bounding box areas of a cone at full resolution
+const int minConeArea = 200;
+const int maxConeArea = 1500;
+// Slack for the areas of coarse blobs; their boxes are rounded to whole coarse pixels
+const int coarseSlack = 2;
+
+// Check that a bounding box isn't too big or too small to be a cone, to eliminate noise
+bool isConeSize(const cv::Rect &boundRect)
+{
+    return (boundRect.area() > minConeArea) && boundRect.area() < maxConeArea;
+}
+
+// Check whether a blob of the region downsampled by scale may be a cone at full resolution; the thresholds shrink by
+// the square of the scale
+bool mayBeCone(const cv::Rect &coarseRect, int scale)
+{
+    const int area{coarseRect.area() * scale * scale};
+    return (area * coarseSlack > minConeArea) && (area < maxConeArea * coarseSlack);
+}
+
+// The blob getCones() takes as the cone of its color: the last one of cone size
+const cv::Rect *chosenCone(const std::vector<Blob> &blobs)
+{
+    for (size_t i = blobs.size(); i > 0; i--)
+    {
+        if (isConeSize(blobs[i - 1].boundingBox))
+        {
+            return &blobs[i - 1].boundingBox;
+        }
+    }
+    return nullptr;
+}
+
+// Smallest rectangle that contains both; an empty rectangle does not count
+cv::Rect boundingUnion(const cv::Rect &a, const cv::Rect &b)
+{
+    if (a.area() == 0)
+    {
+        return b;
+    }
+    if (b.area() == 0)
+    {
+        return a;
+    }
+    const int x0{std::min(a.x, b.x)};
+    const int y0{std::min(a.y, b.y)};
+    return cv::Rect(x0, y0, std::max(a.x + a.width, b.x + b.width) - x0, std::max(a.y + a.height, b.y + b.height) - y0);
+}
+// Blur a part of the region of interest unless it was blurred while it was copied or is blurred while it is segmented
+void blurRegion(const VisionSettings &settings, FrameWorkspace &workspace, const cv::Rect &region)
+{
+    if (!settings.inplace && !settings.fusedBlur)
+    {
+        // Blur the image to reduce noise; the margin rows around the view give the same result as blurring the full frame
+        cv::Mat view = workspace.img(region);
+        workspace.blur.apply(view, view);
+    }
+}
+
+// Create the blue and yellow masks of a part of the region of interest
+void classifyRegion(const VisionSettings &settings, FrameWorkspace &workspace, const cv::Rect &region)
+{
+    const cv::Mat view = workspace.img(region);
+    cv::Mat blueMask = workspace.blueMask(region);
+    cv::Mat yellowMask = workspace.yellowMask(region);
+    if (settings.fusedBlur)
+    {
+        // Blur the view a row at a time and segment every row right after it has been blurred
+        workspace.segmenter.apply(view, settings.blueRange, settings.yellowRange, settings.lut, blueMask, yellowMask);
+    }
+    else if (settings.lut != nullptr)
+    {
+        // Look up the blue and yellow masks for every pixel
+        settings.lut->classify(view, blueMask, yellowMask);
+    }
+    else
+    {
+        // Convert the image to the hsv color space and create the blue and yellow masks in a single pass
+        hsvThreshold(view, settings.blueRange, settings.yellowRange, blueMask, yellowMask);
+    }
+}
+
+// Add a window around every coarse blob that may be a cone, merged with the windows it overlaps or lies closer
+// to than the blur radius, so that no pixel is blurred twice
+void addRefineWindows(const std::vector<Blob> &coarseBlobs, int scale, const cv::Rect &bounds, bool blue, std::vector<RefineWindow> &windows)
+{
+    // A coarse pixel stands for scale full resolution pixels, and the blur widens the blobs a little
+    const int margin{scale + SeparableBlur::RADIUS};
+    for (const Blob &blob : coarseBlobs)
+    {
+        if (!mayBeCone(blob.boundingBox, scale))
+        {
+            continue;
+        }
+        const cv::Rect &box = blob.boundingBox;
+        RefineWindow window{cv::Rect(box.x * scale - margin, box.y * scale - margin, box.width * scale + 2 * margin, box.height * scale + 2 * margin) & bounds, blue, !blue};
+        bool merged{true};
+        while (merged)
+        {
+            merged = false;
+            const cv::Rect grown(window.rect.x - SeparableBlur::RADIUS, window.rect.y - SeparableBlur::RADIUS, window.rect.width + 2 * SeparableBlur::RADIUS, window.rect.height + 2 * SeparableBlur::RADIUS);
+            for (size_t i = 0; i < windows.size(); i++)
+            {
+                if ((grown & windows[i].rect).area() > 0)
+                {
+                    window = RefineWindow{boundingUnion(window.rect, windows[i].rect), window.blue || windows[i].blue, window.yellow || windows[i].yellow};
+                    windows[i] = windows.back();
+                    windows.pop_back();
+                    merged = true;
+                    break;
+                }
+            }
+        }
+        windows.push_back(window);
+    }
+}
+
+// Blobs from several windows in the order one scan of the whole mask returns them: last found first
+void sortLikeFullScan(std::vector<Blob> &blobs)
+{
+    std::sort(blobs.begin(), blobs.end(), foundLater);
+}
+
+// Find the blobs of both colors at a fraction of the cost of the full resolution: segment the downsampled region, then
+// blur, segment and label only windows around the coarse blobs at full resolution. The blobs come out in full
+// resolution coordinates, so getCones() uses the original thresholds and car position on them.
+void findBlobsCoarseToFine(const VisionSettings &settings, FrameWorkspace &workspace, StageClock &clock)
+{
+    const int scale{settings.coarseScale};
+    const cv::Rect bounds(0, 0, workspace.img.cols, workspace.img.rows);
+    const cv::Size coarseSize(bounds.width / scale, bounds.height / scale);
+    workspace.coarse.create(coarseSize, CV_8UC4);
+    workspace.coarseBlueMask.create(coarseSize, CV_8UC1);
+    workspace.coarseYellowMask.create(coarseSize, CV_8UC1);
+    // Averaging the blocks of pixels filters the noise like the blur does at full resolution
+    cv::resize(workspace.img(cv::Rect(0, 0, coarseSize.width * scale, coarseSize.height * scale)), workspace.coarse, coarseSize, 0, 0, cv::INTER_AREA);
+    if (settings.lut != nullptr)
+    {
+        settings.lut->classify(workspace.coarse, workspace.coarseBlueMask, workspace.coarseYellowMask);
+    }
+    else
+    {
+        hsvThreshold(workspace.coarse, settings.blueRange, settings.yellowRange, workspace.coarseBlueMask, workspace.coarseYellowMask);
+    }
+
+    workspace.refineWindows.clear();
+    addRefineWindows(workspace.coarseBlueBlobs.extract(workspace.coarseBlueMask), scale, bounds, true, workspace.refineWindows);
+    addRefineWindows(workspace.coarseYellowBlobs.extract(workspace.coarseYellowMask), scale, bounds, false, workspace.refineWindows);
+    workspace.segmentedPixels = static_cast<uint64_t>(coarseSize.area());
+    for (const RefineWindow &window : workspace.refineWindows)
+    {
+        blurRegion(settings, workspace, window.rect);
+        workspace.segmentedPixels += static_cast<uint64_t>(window.rect.area());
+    }
+    // The blur stage includes the whole coarse pass
+    clock.lap(STAGE_BLUR);
+    for (const RefineWindow &window : workspace.refineWindows)
+    {
+        classifyRegion(settings, workspace, window.rect);
+    }
+    clock.lap(STAGE_COLOR);
+
+    workspace.refinedBlue.clear();
+    workspace.refinedYellow.clear();
+    for (const RefineWindow &window : workspace.refineWindows)
+    {
+        if (window.blue)
+        {
+            const std::vector<Blob> &blobs = workspace.blueBlobs.extract(workspace.blueMask(window.rect), window.rect.tl());
+            workspace.refinedBlue.insert(workspace.refinedBlue.end(), blobs.begin(), blobs.end());
+        }
+        if (window.yellow)
+        {
+            const std::vector<Blob> &blobs = workspace.yellowBlobs.extract(workspace.yellowMask(window.rect), window.rect.tl());
+            workspace.refinedYellow.insert(workspace.refinedYellow.end(), blobs.begin(), blobs.end());
+        }
+    }
+    sortLikeFullScan(workspace.refinedBlue);
+    sortLikeFullScan(workspace.refinedYellow);
+}
+// Pack the part of a mask in a window into bits and open it
+void openMask(const cv::Mat &mask, const cv::Rect &window, BitMask &bits, BitMask &scratch)
+{
+    if (window.area() > 0)
+    {
+        bits.pack(mask(window));
+        bits.open(scratch);
+    }
+}
+
+// Label the blobs of a window of a mask, or of its opened packed copy, or find them from the projections of the mask
+const std::vector<Blob> &findBlobs(const VisionSettings &settings, const cv::Mat &mask, const cv::Rect &window, const BitMask &bits, BlobExtractor &extractor, ProjectionDetector &projection)
+{
+    if (settings.projection)
+    {
+        return projection.detect(mask(window), window.tl());
+    }
+    if (!settings.openMasks)
+    {
+        return extractor.extract(mask(window), window.tl());
+    }
+    // The opening often leaves nothing of a color that is not in sight
+    if (bits.moments().area == 0)
+    {
+        return noBlobs;
+    }
+    return extractor.extract(bits, window.tl());
+}
+} // namespace
+
+void detectFrame(const VisionSettings &settings, FrameWorkspace &workspace, SteeringController &steering)
+{
+    StageClock clock(settings.profiler);
+    cv::Mat img = workspace.img;
+    const cv::Rect bounds(0, 0, img.cols, img.rows);
+    // Parts of the region of interest to search for each color; all of it unless the cones are tracked
+    cv::Rect blueWindow = bounds;
+    cv::Rect yellowWindow = bounds;
+    const std::vector<Blob> *blueBlobs = &noBlobs;
+    const std::vector<Blob> *yellowBlobs = &noBlobs;
+    if (settings.coarseScale > 1)
+    {
+        findBlobsCoarseToFine(settings, workspace, clock);
+        blueBlobs = &workspace.refinedBlue;
+        yellowBlobs = &workspace.refinedYellow;
+    }
+    else
+    {
+        if (settings.tracking)
+        {
+            blueWindow = steering.blueTrack.window(bounds, settings.trackRescan);
+            yellowWindow = steering.yellowTrack.window(bounds, settings.trackRescan);
+        }
+        // Windows that overlap or lie closer than the blur radius are processed as one, so no pixel is blurred twice
+        // and no window reads pixels of another one that have already been blurred
+        cv::Rect regions[2] = {blueWindow, yellowWindow};
+        const cv::Rect grown(blueWindow.x - SeparableBlur::RADIUS, blueWindow.y - SeparableBlur::RADIUS, blueWindow.width + 2 * SeparableBlur::RADIUS, blueWindow.height + 2 * SeparableBlur::RADIUS);
+        if ((blueWindow.area() == 0) || (yellowWindow.area() == 0) || ((grown & yellowWindow).area() > 0))
+        {
+            regions[0] = boundingUnion(blueWindow, yellowWindow);
+            regions[1] = cv::Rect();
+        }
+        workspace.segmentedPixels = static_cast<uint64_t>(regions[0].area() + regions[1].area());
+        if (!settings.openMasks)
+        {
+            for (const cv::Rect &region : regions)
+            {
+                if (region.area() > 0)
+                {
+                    blurRegion(settings, workspace, region);
+                }
+            }
+            if (!settings.inplace && !settings.fusedBlur)
+            {
+                clock.lap(STAGE_BLUR);
+            }
+        }
+        for (const cv::Rect &region : regions)
+        {
+            if (region.area() > 0)
+            {
+                classifyRegion(settings, workspace, region);
+            }
+        }
+        clock.lap(STAGE_COLOR);
+        if (settings.openMasks)
+        {
+            // Remove the specks the blur would have smoothed away from packed copies of the masks; this is timed as the blur stage
+            openMask(workspace.blueMask, blueWindow, workspace.blueBits, workspace.openScratch);
+            openMask(workspace.yellowMask, yellowWindow, workspace.yellowBits, workspace.openScratch);
+            clock.lap(STAGE_BLUR);
+        }
+    }
+    // Reset the cone variables every frame
+    steering.isBlue = false;
+    steering.isYellow = false;
+    steering.isMirrored = true;
+    // Only draw the cones when the image is displayed
+    cv::Mat canvas = settings.draw ? img : cv::Mat();
+    // Call the getCones function for blue
+    if ((settings.coarseScale <= 1) && (blueWindow.area() > 0))
+    {
+        blueBlobs = &findBlobs(settings, workspace.blueMask, blueWindow, workspace.blueBits, workspace.blueBlobs, workspace.blueProjection);
+    }
+    steering.getCones(*blueBlobs, canvas, blue);
+    clock.lap(STAGE_CONES_BLUE);
+    // Call the getCones function for yellow
+    if ((settings.coarseScale <= 1) && (yellowWindow.area() > 0))
+    {
+        yellowBlobs = &findBlobs(settings, workspace.yellowMask, yellowWindow, workspace.yellowBits, workspace.yellowBlobs, workspace.yellowProjection);
+    }
+    steering.getCones(*yellowBlobs, canvas, yellow);
+    clock.lap(STAGE_CONES_YELLOW);
+    if (settings.tracking && (settings.coarseScale <= 1))
+    {
+        // Predict where the cones the steering is computed from will be in the next frame
+        steering.blueTrack.update(chosenCone(*blueBlobs), blueWindow, bounds);
+        steering.yellowTrack.update(chosenCone(*yellowBlobs), yellowWindow, bounds);
+    }
+    // Call the getDistance function
+    steering.getDistance();
+    clock.lap(STAGE_DISTANCE);
+}
+
+ConeDetector::ConeDetector(const VisionSettings &settings)
+    : m_settings(settings)
+    , m_workspace(settings.region, settings.ingestRegion)
+    , m_steering()
+{
+}
+
+FrameWorkspace &ConeDetector::workspace()
+{
+    return m_workspace;
+}
+
+SteeringController &ConeDetector::steering()
+{
+    return m_steering;
+}
+
+double ConeDetector::detect()
+{
+    detectFrame(m_settings, m_workspace, m_steering);
+    return m_steering.steeringWheelAngle;
+}
+
+void SteeringController::getCones(const std::vector<Blob> &blobs, cv::Mat img, char color)
+{
+    // Create a rectangle to store the previous position of the cone
+    cv::Rect lastRect(0, 0, 0, 0);
+    // Check if the color is blue
+    if (color == blue)
+    {
+        // Go through all the blobs
+        for (size_t i = 0; i < blobs.size(); ++i)
+        {
+            // Get the rectangle around the current blob
+            cv::Rect boundRect = blobs[i].boundingBox;
+            // Check that the rectangle isn't too big or too small to eliminate noise
+            if (isConeSize(boundRect))
+            {
+                // A blue cone has been found
+                isBlue = true;
+                // Check if the current cone is in the same position as the previous one
+                if (boundRect.y > lastRect.y && !img.empty())
+                {
+                    // Draw the rectangle on the source image
+                    // boundRect.tl() is the top left of the rectangle; boundRect.br() is the bottom right corner
+                    cv::rectangle(img, boundRect.tl(), boundRect.br(), cvScalar(0, 255, 0), 3);
+                }
+                // Update the last rectangle
+                lastRect = boundRect;
+            }
+        }
+        // Save the closest rectangle to the blue cone variable
+        blueCones = cv::Point(lastRect.x + lastRect.width / 2, lastRect.y + lastRect.height / 2);
+        // Update the lastBlueCone variable with the new position
+        if (!fBlue)
+        {
+            fBlue = true;
+            lastBlueCone = blueCones;
+            // Check if the blue cone is on the left or right side of the image
+        }
+        if (blueCones.x < car.x && isMirrored)
+        {
+            bLeft = true;
+            yLeft = false;
+            isMirrored = false;
+        }
+    }
+    // Check if the color is yellow
+    else if (color == yellow)
+    {
+        // Go through all the blobs
+        for (size_t i = 0; i < blobs.size(); ++i)
+        {
+            // Get the rectangle around the current blob
+            cv::Rect boundRect = blobs[i].boundingBox;
+            // Check that the rectangle isn't too big or too small to eliminate noise
+            if (isConeSize(boundRect))
+            {
+                // change the isYellow variable to true
+                isYellow = true;
+                // Check if the current cone is in the same position as the previous one
+                if (boundRect.y > lastRect.y && !img.empty())
+                {
+                    // Draw the rectangle on the source image
+                    // boundRect.tl() is the top left of the rectangle; boundRect.br() is the bottom right corner
+                    cv::rectangle(img, boundRect.tl(), boundRect.br(), cvScalar(0, 255, 0), 3);
+                }
+                // Update the last rectangle
+                lastRect = boundRect;
+            }
+        }
+        // Save the closest rectangle to the yellow cone variable
+        yellowCones = cv::Point(lastRect.x + lastRect.width / 2, lastRect.y + lastRect.height / 2);
+        // Update the lastYellowCone variable with the new position
+        if (!fYellow)
+        {
+            fYellow = true;
+            lastYellowCone = yellowCones;
+        }
+        // Check if the yellow cone is on the left or right side of the image
+        if (yellowCones.x < car.x && isMirrored)
+        {
+            bLeft = false;
+            yLeft = true;
+            isMirrored = false;
+        }
+    }
+}
+
+void SteeringController::getDistance()
+{
+    // If both blue and yellow cones are found
+    if (isBlue && isYellow)
+    {
+        // Set the steering wheel angle to 0
+        steeringWheelAngle = 0.049;
+    }
+    else
+    {
+        // Initialize variable to store the differance between the cones and the car
+        double difference = 0.0;
+        // Check if the blue cone is on the left side of the image
+        if (bLeft)
+        {
+            // Check if we have a blue cone in frame
+            if (isBlue)
+            {
+                // Set the differance to the difference between the car and the blue cone
+                difference = static_cast<double>(blueCones.x) / static_cast<double>(car.x);
+                // Check that the calculation is in the correct range
+                if (std::abs(difference) < threshold || std::abs(difference) > threshold2)
+                {
+                    steeringWheelAngle = -0.049;
+                }
+                else
+                {
+                    // Check if the current blue cone is the same as the last blue cone
+                    if (blueCones.x > lastBlueCone.x)
+                    {
+                        // Call the steer function with the direction and the differance to calculate the steering wheel angle
+                        calculate(right, difference || std::abs(difference) > threshold2);
+                    }
+                    else
+                    {
+                        steeringWheelAngle = -0.049;
+                    }
+                }
+            }
+            // Check if we have a yellow cone in frame
+            else if (isYellow)
+            {
+                // Set the differance to the difference between the car and the yellow cone
+                difference = static_cast<double>(car.x) / static_cast<double>(yellowCones.x);
+                // Check that the calculation is in the correct range
+                if (std::abs(difference) < threshold || std::abs(difference) > threshold2)
+                {
+                    steeringWheelAngle = 0.049;
+                }
+                else
+                {
+                    // Check if the current yellow cone is the same as the last yellow cone
+                    if (yellowCones.y == lastYellowCone.y)
+                    {
+                        steeringWheelAngle = 0.049;
+                    }
+                    else if (yellowCones.y > lastYellowCone.y)
+                    {
+                        calculate(left, difference);
+                    }
+                }
+            }
+            // Set the differance to 0
+            difference = 0.0;
+        }
+        // Check if the yellow cone is on the left side of the image
+        else if (yLeft)
+        {
+            // Check if we have a yellow cone in frame
+            if (isYellow)
+            {
+                // Set the differance to the difference between the car and the yellow cone
+                difference = static_cast<double>(yellowCones.x) / static_cast<double>(car.x);
+                // Check that the calculation is in the correct range
+                if (std::abs(difference) < threshold || std::abs(difference) > threshold2)
+                {
+                    steeringWheelAngle = -0.049;
+                }
+                else
+                {
+                    // Check if the current yellow cone is the same as the last yellow cone
+                    if (yellowCones.x > lastYellowCone.x)
+                    {
+                        calculate(right, difference);
+                    }
+                    else
+                    {
+                        steeringWheelAngle = -0.049;
+                    }
+                }
+            }
+            // Check if we have a blue cone in frame
+            else if (isBlue)
+            {
+                // Set the differance to the difference between the car and the blue cone
+                difference = static_cast<double>(car.x) / static_cast<double>(blueCones.x);
+                // Check that the calculation is in the correct range
+                if (std::abs(difference) < threshold || std::abs(difference) > threshold2)
+                {
+                    steeringWheelAngle = 0.049;
+                }
+                else
+                {
+                    if (blueCones.y == lastBlueCone.y)
+                    {
+                        steeringWheelAngle = 0.049;
+                    }
+                    else if (blueCones.y > lastBlueCone.y)
+                    {
+                        calculate(left, difference);
+                    }
+                }
+            }
+            // Set the differance to 0
+            difference = 0.0;
+        }
+        else
+        {
+            steeringWheelAngle = 0.049;
+        }
+    }
+    // Set the last blue cone to the current blue cone
+    lastBlueCone = blueCones;
+    // Set the last yellow cone to the current yellow cone
+    lastYellowCone = yellowCones;
+}
+
+void SteeringController::calculate(char direction, double difference)
+{
+    int negative = 1;
+    // Check if the direction is right
+    if (direction == right)
+    {
+        // Check if the steering wheel angle more then 0
+        if (steeringWheelAngle > 0.49)
+        {
+            // Set the steering wheel angle to 0
+            steeringWheelAngle = 0.49;
+        }
+        negative = -1;
+    }
+    // Check if the direction is left
+    else if (direction == left)
+    {
+        // Check if the steering wheel angle less then 0
+        if (steeringWheelAngle < -0.49)
+        {
+            // Set the steering wheel angle to 0
+            steeringWheelAngle = -0.49;
+        }
+        negative = 1;
+    }
+    // based if the differance, create a value that is between -0.29 and 0.29
+    steeringWheelAngle = 0.09 * (1 + difference) * negative;
+    // check if the steering wheel angle is more then 0.29
+    if (steeringWheelAngle > magicNumber)
+    {
+        // Set the steering wheel angle to 0.29
+        steeringWheelAngle = magicNumber;
+    } // check if the steering wheel angle is less then -0.29
+    else if (steeringWheelAngle < -(magicNumber))
+    {
+        // Set the steering wheel angle to -0.29
+        steeringWheelAngle = -(magicNumber);
+    }
+}
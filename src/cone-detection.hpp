@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONE_DETECTION_HPP
+#define CONE_DETECTION_HPP
+
+#include "blob-extractor.hpp"
+#include "color-lut.hpp"
+#include "cone-tracker.hpp"
+#include "frame-workspace.hpp"
+#include "hsv-threshold.hpp"
+#include "stage-profiler.hpp"
+
+#include <opencv2/core/core.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// Constants for color and direction
+extern const char blue;
+extern const char yellow;
+extern const char right;
+extern const char left;
+
+extern cv::Scalar blueLow;
+extern cv::Scalar blueHigh;
+extern cv::Scalar yellowLow;
+extern cv::Scalar yellowHigh;
+extern cv::Point car;
+
+// Region of the frame that contains the cones
+extern const cv::Rect roi;
+// Number of rows the 7x7 blur kernel reads above and below the region
+extern const int blurMargin;
+
+// Settings that decide how a frame is turned into a steering wheel angle; they are fixed after startup
+struct VisionSettings
+{
+    uint32_t width;
+    uint32_t height;
+    // Region of interest and the region that is copied out of the shared memory for it
+    cv::Rect region;
+    cv::Rect ingestRegion;
+    // Blur straight out of the shared memory instead of copying first
+    bool inplace;
+    // Take the frame in the shared memory right away when it is newer than the last one instead of waiting for the next notification
+    bool latestFrameWins;
+    HsvRange blueRange;
+    HsvRange yellowRange;
+    // Lookup table that replaces the HSV conversion, or nullptr
+    const ColorLut *lut;
+    // Draw the cones into the image
+    bool draw;
+    // Histograms of the time spent in each stage, or nullptr
+    StageProfiler *profiler;
+    // Only search windows around the tracked cones and the whole region every trackRescan frames
+    bool tracking;
+    uint32_t trackRescan;
+    // Search for cones in the region of interest downsampled by this factor (1, 2 or 4) first and then only around
+    // what was found there at full resolution; overrides tracking
+    int coarseScale;
+    // Skip the blur and remove the noise from bit-packed masks with a 3x3 opening instead
+    bool openMasks;
+    // Find the cones from the hits per column and row of the masks instead of from their connected components
+    bool projection;
+    // Blur each row of the region right before it is segmented instead of blurring the whole region first; the blur
+    // is then timed as part of the color stage
+    bool fusedBlur;
+};
+
+// Turns the blobs of a frame into a steering wheel angle. All cone positions and steering state that carry over from
+// frame to frame live in an instance, so every stream or recording has its own controller. The state keeps the names
+// of the global variables it replaced.
+class SteeringController
+{
+   public:
+    SteeringController();
+
+    // Function to find the cones and draw them on the image unless it is empty
+    void getCones(const std::vector<Blob> &blobs, cv::Mat img, char color);
+
+    // Create a function to calculate the difference between cones and the car
+    void getDistance();
+
+    // Create a funciton calculate the car direction
+    void calculate(char direction, double difference);
+
+    // Function to calculate the number of frames that meet the performance requirement
+    void calculatePerformance(double groundSteering);
+
+    // Create two points to store the coordinates of the cones
+    cv::Point blueCones;
+    cv::Point yellowCones;
+    // Create variables to store the coordinates of the previous cones
+    cv::Point lastBlueCone;
+    cv::Point lastYellowCone;
+    // Bools for cone detection
+    bool isBlue;
+    bool isYellow;
+    bool bLeft;
+    bool yLeft;
+    bool fBlue;
+    bool fYellow;
+    bool isMirrored;
+    // Variable for storing the direction of the car
+    double steeringWheelAngle;
+    // Variable to keep count of the corect frames
+    double variable;
+    // Predicted positions of the cones for the tracking mode
+    ConeTracker blueTrack;
+    ConeTracker yellowTrack;
+};
+
+// Function to find the cones in an ingested frame and update the steering wheel angle
+void detectFrame(const VisionSettings &settings, FrameWorkspace &workspace, SteeringController &steering);
+
+// Everything one camera stream needs to turn frames into steering wheel angles: its buffers and its steering state.
+// Instances share nothing but the read-only lookup table of the settings, so different streams can be processed on
+// different threads at the same time.
+class ConeDetector
+{
+   public:
+    explicit ConeDetector(const VisionSettings &settings);
+
+    // Buffers the next frame is ingested into
+    FrameWorkspace &workspace();
+    SteeringController &steering();
+
+    // Find the cones in the ingested frame and return the new steering wheel angle
+    double detect();
+
+   private:
+    const VisionSettings m_settings;
+    FrameWorkspace m_workspace;
+    SteeringController m_steering;
+};
+
+#endif
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cone-tracker.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+// Gains of the alpha-beta filter for the position and the velocity
+const float alpha = 0.75f;
+const float beta = 0.3f;
+// Pixels around the predicted bounding box that are searched as well, plus twice the speed of the cone
+const float margin = 16.0f;
+// A cone that is found farther than this many of its own sizes from the prediction is a different cone
+const float jump = 1.5f;
+const uint32_t rescanNow = std::numeric_limits<uint32_t>::max();
+} // namespace
+
+ConeTracker::ConeTracker()
+    : m_tracking(false)
+    , m_position()
+    , m_velocity()
+    , m_size()
+    , m_framesSinceScan(rescanNow)
+{
+}
+
+cv::Rect ConeTracker::window(const cv::Rect &bounds, uint32_t rescanInterval) const
+{
+    if (m_framesSinceScan >= rescanInterval)
+    {
+        return bounds;
+    }
+    if (!m_tracking)
+    {
+        return cv::Rect();
+    }
+    const float predictedX{m_position.x + m_velocity.x};
+    const float predictedY{m_position.y + m_velocity.y};
+    const float marginX{margin + 2.0f * std::fabs(m_velocity.x)};
+    const float marginY{margin + 2.0f * std::fabs(m_velocity.y)};
+    const int x0{static_cast<int>(std::floor(predictedX - 0.5f * static_cast<float>(m_size.width) - marginX))};
+    const int y0{static_cast<int>(std::floor(predictedY - 0.5f * static_cast<float>(m_size.height) - marginY))};
+    const int x1{static_cast<int>(std::ceil(predictedX + 0.5f * static_cast<float>(m_size.width) + marginX))};
+    const int y1{static_cast<int>(std::ceil(predictedY + 0.5f * static_cast<float>(m_size.height) + marginY))};
+    return cv::Rect(x0, y0, x1 - x0, y1 - y0) & bounds;
+}
+
+void ConeTracker::update(const cv::Rect *cone, const cv::Rect &searched, const cv::Rect &bounds)
+{
+    const bool fullScan{searched == bounds};
+    if (fullScan)
+    {
+        m_framesSinceScan = 0;
+    }
+    else if (m_framesSinceScan != rescanNow)
+    {
+        m_framesSinceScan++;
+    }
+
+    if (nullptr == cone)
+    {
+        // A cone that left its window may have moved faster than predicted, so look at the whole region next
+        if (m_tracking && !fullScan)
+        {
+            m_framesSinceScan = rescanNow;
+        }
+        m_tracking = false;
+        return;
+    }
+
+    const cv::Point2f measured(static_cast<float>(cone->x) + 0.5f * static_cast<float>(cone->width), static_cast<float>(cone->y) + 0.5f * static_cast<float>(cone->height));
+    const cv::Point2f residual(measured.x - (m_position.x + m_velocity.x), measured.y - (m_position.y + m_velocity.y));
+    const float size{static_cast<float>(std::max(cone->width, cone->height))};
+    if (!m_tracking || (std::fabs(residual.x) > jump * size) || (std::fabs(residual.y) > jump * size))
+    {
+        // Start over at the new cone
+        m_position = measured;
+        m_velocity = cv::Point2f();
+    }
+    else
+    {
+        m_position = cv::Point2f(m_position.x + m_velocity.x + alpha * residual.x, m_position.y + m_velocity.y + alpha * residual.y);
+        m_velocity = cv::Point2f(m_velocity.x + beta * residual.x, m_velocity.y + beta * residual.y);
+    }
+    m_size = cone->size();
+    m_tracking = true;
+}
+
+bool ConeTracker::tracking() const
+{
+    return m_tracking;
+}
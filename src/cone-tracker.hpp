@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONE_TRACKER_HPP
+#define CONE_TRACKER_HPP
+
+#include <opencv2/core/core.hpp>
+
+#include <cstdint>
+
+// Follows the cone of one color that the steering is computed from. An alpha-beta filter predicts where the cone
+// is in the next frame, so that only a window around the prediction has to be searched. The whole region of
+// interest is searched every rescanInterval frames, and in the frame after the cone was not found in its window.
+// While no cone of the color is in sight, the color is only looked for in those full scans.
+class ConeTracker
+{
+   public:
+    ConeTracker();
+
+    // Part of bounds to search in the next frame: a window around the predicted cone, bounds itself when a full scan
+    // is due, or an empty rectangle when the color is not in sight and can be skipped
+    cv::Rect window(const cv::Rect &bounds, uint32_t rescanInterval) const;
+
+    // Feed the result of searching the window returned by window(): the bounding box of the cone that was found,
+    // or nullptr
+    void update(const cv::Rect *cone, const cv::Rect &searched, const cv::Rect &bounds);
+
+    bool tracking() const;
+
+   private:
+    bool m_tracking;
+    // Center of the cone and its movement per frame
+    cv::Point2f m_position;
+    cv::Point2f m_velocity;
+    cv::Size m_size;
+    // Frames since the whole region was searched; saturates
+    uint32_t m_framesSinceScan;
+};
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cpu-dispatch.hpp"
+
+namespace
+{
+VisionKernels &boundKernels()
+{
+    static VisionKernels kernels{kernelsFor(bestKernelSet())};
+    return kernels;
+}
+} // namespace
+
+KernelSet bestKernelSet()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return KERNELS_AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1"))
+    {
+        return KERNELS_SSE41;
+    }
+#endif
+    return KERNELS_SCALAR;
+}
+
+bool kernelSetSupported(KernelSet set)
+{
+    // The sets are ordered, so every set below the best one is supported as well
+    return set <= bestKernelSet();
+}
+
+const char *kernelSetName(KernelSet set)
+{
+    switch (set)
+    {
+    case KERNELS_AVX2:
+        return "avx2";
+    case KERNELS_SSE41:
+        return "sse4.1";
+    case KERNELS_SCALAR:
+    default:
+        return "scalar";
+    }
+}
+
+bool parseKernelSet(const std::string &name, KernelSet &set)
+{
+    if ("auto" == name)
+    {
+        set = bestKernelSet();
+        return true;
+    }
+    for (KernelSet candidate : {KERNELS_SCALAR, KERNELS_SSE41, KERNELS_AVX2})
+    {
+        if (kernelSetName(candidate) == name)
+        {
+            set = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+VisionKernels kernelsFor(KernelSet set)
+{
+    VisionKernels kernels{KERNELS_SCALAR, hsvThresholdRowScalar, blurRowHorizontalScalar, blurRowVerticalScalar, maskPackRowScalar, maskErodeRowScalar, maskDilateRowScalar, maskProjectRowScalar, bgrBlurRowHorizontalScalar, bgrBlurRowVerticalScalar, bgrToBgraRowScalar};
+#if defined(__x86_64__) || defined(__i386__)
+    if (KERNELS_AVX2 == set)
+    {
+        kernels = {KERNELS_AVX2, hsvThresholdRowAvx2, blurRowHorizontalAvx2, blurRowVerticalAvx2, maskPackRowAvx2, maskErodeRowAvx2, maskDilateRowAvx2, maskProjectRowAvx2, bgrBlurRowHorizontalAvx2, bgrBlurRowVerticalAvx2, bgrToBgraRowSse41};
+    }
+    else if (KERNELS_SSE41 == set)
+    {
+        kernels = {KERNELS_SSE41, hsvThresholdRowSse41, blurRowHorizontalSse41, blurRowVerticalSse41, maskPackRowSse41, maskErodeRowSse41, maskDilateRowSse41, maskProjectRowSse41, bgrBlurRowHorizontalSse41, bgrBlurRowVerticalSse41, bgrToBgraRowSse41};
+    }
+#endif
+    return kernels;
+}
+
+const VisionKernels &visionKernels()
+{
+    return boundKernels();
+}
+
+void selectKernels(KernelSet set)
+{
+    boundKernels() = kernelsFor(set);
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CPU_DISPATCH_HPP
+#define CPU_DISPATCH_HPP
+
+#include "bit-mask.hpp"
+#include "fused-segmentation.hpp"
+#include "hsv-threshold.hpp"
+#include "projection-detector.hpp"
+#include "separable-blur.hpp"
+
+#include <string>
+
+// Instruction sets that the hand-written kernels of the frame loop are compiled for
+enum KernelSet
+{
+    KERNELS_SCALAR,
+    KERNELS_SSE41,
+    KERNELS_AVX2
+};
+
+// Best kernel set that the running CPU supports
+KernelSet bestKernelSet();
+bool kernelSetSupported(KernelSet set);
+const char *kernelSetName(KernelSet set);
+// Parse auto, scalar, sse4.1 or avx2; auto resolves to bestKernelSet()
+bool parseKernelSet(const std::string &name, KernelSet &set);
+
+// Function pointers to the implementations of every kernel that has instruction set specific variants.
+// Kernels without a variant for a set fall back to the next lower one.
+struct VisionKernels
+{
+    KernelSet set;
+    HsvThresholdRow hsvThresholdRow;
+    BlurRowHorizontal blurRowHorizontal;
+    BlurRowVertical blurRowVertical;
+    MaskPackRow maskPackRow;
+    MaskMorphRow maskErodeRow;
+    MaskMorphRow maskDilateRow;
+    MaskProjectRow maskProjectRow;
+    BgrBlurRowHorizontal bgrBlurRowHorizontal;
+    BgrBlurRowVertical bgrBlurRowVertical;
+    BgrToBgraRow bgrToBgraRow;
+};
+
+VisionKernels kernelsFor(KernelSet set);
+
+// Kernels used by the frame loop; bound to bestKernelSet() the first time they are needed
+const VisionKernels &visionKernels();
+// Rebind the kernels of the frame loop; only call it at startup before any frame is processed
+void selectKernels(KernelSet set);
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame-ingest.hpp"
+
+#include <opencv2/core/core.hpp>
+
+#include <chrono>
+#include <utility>
+
+namespace
+{
+// Longest time the latest-frame-wins schedule waits before it looks at the timestamp in the shared memory again
+const std::chrono::microseconds frameRecheckInterval(2000);
+} // namespace
+
+int64_t ingestFrame(cluon::SharedMemory &sharedMemory, const VisionSettings &settings, int64_t lastTimestamp, FrameWorkspace &workspace)
+{
+    StageClock clock(settings.profiler);
+    if (settings.latestFrameWins)
+    {
+        // A frame that arrived while we were busy is newer than anything we would get by waiting, so only wait when it has been processed already.
+        // A notification between unlock() and the wait would be lost, so the wait is bounded and the timestamp checked again.
+        sharedMemory.lock();
+        while (cluon::time::toMicroseconds(sharedMemory.getTimeStamp().second) == lastTimestamp)
+        {
+            sharedMemory.unlock();
+            sharedMemory.waitFor(frameRecheckInterval);
+            sharedMemory.lock();
+        }
+        clock.lap(STAGE_WAIT);
+    }
+    else
+    {
+        // Wait for a notification of a new frame.
+        sharedMemory.wait();
+        clock.lap(STAGE_WAIT);
+        // Lock the shared memory.
+        sharedMemory.lock();
+    }
+    copyRegion(sharedMemory, settings, workspace);
+    // Get the time for each image
+    std::pair<bool, cluon::data::TimeStamp> imageTime = sharedMemory.getTimeStamp();
+    // Unlock the shared memory
+    sharedMemory.unlock();
+    // In place this includes the blur
+    clock.lap(STAGE_LOCK_COPY);
+    // Convert the time to microseconds
+    return cluon::time::toMicroseconds(imageTime.second);
+}
+
+void copyRegion(cluon::SharedMemory &sharedMemory, const VisionSettings &settings, FrameWorkspace &workspace)
+{
+    // Wrap the pixels in the shared memory without copying them.
+    cv::Mat wrapped(settings.height, settings.width, CV_8UC4, sharedMemory.data());
+    if (settings.inplace)
+    {
+        // Blur the region straight out of the shared memory into our buffer; the kernel reads the neighbouring rows from the frame itself
+        workspace.blur.apply(wrapped(settings.region), workspace.img);
+    }
+    else
+    {
+        // Copy only the region of interest and its blur margin into the preallocated buffer
+        wrapped(settings.ingestRegion).copyTo(workspace.ingest);
+    }
+}
+
+bool pollFrame(cluon::SharedMemory &sharedMemory, const VisionSettings &settings, int64_t lastTimestamp, FrameWorkspace &workspace, int64_t &timestamp)
+{
+    sharedMemory.lock();
+    timestamp = cluon::time::toMicroseconds(sharedMemory.getTimeStamp().second);
+    const bool newer{timestamp != lastTimestamp};
+    if (newer)
+    {
+        copyRegion(sharedMemory, settings, workspace);
+    }
+    sharedMemory.unlock();
+    return newer;
+}
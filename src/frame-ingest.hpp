@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAME_INGEST_HPP
+#define FRAME_INGEST_HPP
+
+#include "cluon-complete.hpp"
+#include "cone-detection.hpp"
+#include "frame-workspace.hpp"
+
+#include <cstdint>
+
+// Function to copy (or blur in place) the region of interest out of the locked shared memory
+void copyRegion(cluon::SharedMemory &sharedMemory, const VisionSettings &settings, FrameWorkspace &workspace);
+
+// Function to copy the region of interest only if the frame in the shared memory is newer than lastTimestamp, without waiting
+bool pollFrame(cluon::SharedMemory &sharedMemory, const VisionSettings &settings, int64_t lastTimestamp, FrameWorkspace &workspace, int64_t &timestamp);
+
+// Function to wait for a frame newer than lastTimestamp, copy its region of interest into the workspace and return its timestamp in microseconds
+int64_t ingestFrame(cluon::SharedMemory &sharedMemory, const VisionSettings &settings, int64_t lastTimestamp, FrameWorkspace &workspace);
+
+#endif
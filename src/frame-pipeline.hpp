@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAME_PIPELINE_HPP
+#define FRAME_PIPELINE_HPP
+
+#include "spsc-ring.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Three-stage pipeline (ingest, detect, output) over a fixed set of preallocated frame slots.
+// The stages run on their own threads and hand slot indices to each other through SPSC rings,
+// so frame N can be detected while frame N + 1 is ingested and frame N - 1 is printed.
+// Frames leave the output stage in the order in which they were ingested.
+template <typename Slot> class FramePipeline
+{
+   public:
+    // Create count slots, each constructed from args
+    template <typename... Args>
+    explicit FramePipeline(size_t count, const Args &...args)
+        : m_slots()
+        , m_free(count)
+        , m_detect(count)
+        , m_output(count)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            m_slots.emplace_back(new Slot(args...));
+            m_free.push(static_cast<uint32_t>(i));
+        }
+    }
+
+    FramePipeline(const FramePipeline &) = delete;
+    FramePipeline &operator=(const FramePipeline &) = delete;
+
+    // Run ingest on the calling thread until it returns false, then drain the other stages and return
+    void run(const std::function<bool(Slot &)> &ingest, const std::function<void(Slot &)> &detect, const std::function<void(Slot &)> &output)
+    {
+        std::atomic<bool> ingesting{true};
+        std::atomic<bool> detecting{true};
+
+        std::thread detector([this, &detect, &ingesting, &detecting]() {
+            forward(m_detect, m_output, detect, ingesting);
+            detecting.store(false, std::memory_order_release);
+        });
+        std::thread outputter([this, &output, &detecting]() { forward(m_output, m_free, output, detecting); });
+
+        Backoff backoff;
+        uint32_t index;
+        while (true)
+        {
+            // Wait until the output stage returns a slot
+            while (!m_free.pop(index))
+            {
+                backoff.pause();
+            }
+            backoff.reset();
+            if (!ingest(*m_slots[index]))
+            {
+                m_free.push(index);
+                break;
+            }
+            m_detect.push(index);
+        }
+        ingesting.store(false, std::memory_order_release);
+
+        detector.join();
+        outputter.join();
+    }
+
+   private:
+    // Process the slots arriving in from and pass them on to to until the previous stage has stopped and from is drained
+    void forward(SpscRing<uint32_t> &from, SpscRing<uint32_t> &to, const std::function<void(Slot &)> &stage, const std::atomic<bool> &previousRunning)
+    {
+        Backoff backoff;
+        uint32_t index;
+        while (true)
+        {
+            if (from.pop(index))
+            {
+                backoff.reset();
+                stage(*m_slots[index]);
+                // Every ring can hold all slots, so this never fails
+                to.push(index);
+            }
+            else if (!previousRunning.load(std::memory_order_acquire) && from.empty())
+            {
+                break;
+            }
+            else
+            {
+                backoff.pause();
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Slot>> m_slots;
+    // Slots that can be ingested into, waiting for detection and waiting for output
+    SpscRing<uint32_t> m_free;
+    SpscRing<uint32_t> m_detect;
+    SpscRing<uint32_t> m_output;
+};
+
+#endif
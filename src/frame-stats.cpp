@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame-stats.hpp"
+
+namespace
+{
+const int64_t windowLength = 1000000;
+} // namespace
+
+DropDetector::DropDetector(int64_t framePeriod)
+    : m_estimate(framePeriod <= 0)
+    , m_framePeriod(framePeriod > 0 ? framePeriod : 0)
+    , m_lastTimestamp(0)
+{
+}
+
+uint32_t DropDetector::update(int64_t timestamp)
+{
+    const int64_t delta{timestamp - m_lastTimestamp};
+    const bool first{m_lastTimestamp == 0};
+    m_lastTimestamp = timestamp;
+    // The same frame again or a producer that started over does not tell anything about drops
+    if (first || delta <= 0)
+    {
+        return 0;
+    }
+    if (m_estimate && ((m_framePeriod == 0) || (delta < m_framePeriod)))
+    {
+        m_framePeriod = delta;
+    }
+    // Round to whole frame periods so that jitter of the producer does not count as a drop
+    const int64_t periods{(delta + m_framePeriod / 2) / m_framePeriod};
+    return (periods > 1) ? static_cast<uint32_t>(periods - 1) : 0;
+}
+
+int64_t DropDetector::framePeriod() const
+{
+    return m_framePeriod;
+}
+
+FrameStats::FrameStats()
+    : m_windowStart(0)
+    , m_current{0, 0, 0}
+    , m_last{0, 0, 0}
+    , m_totalProcessed(0)
+    , m_totalDropped(0)
+{
+}
+
+bool FrameStats::add(int64_t timestamp, int64_t now, uint32_t dropped)
+{
+    bool closed{false};
+    if (m_windowStart == 0)
+    {
+        m_windowStart = now;
+    }
+    else if (now - m_windowStart >= windowLength)
+    {
+        m_last = m_current;
+        m_current = Window{0, 0, 0};
+        m_windowStart = now;
+        closed = true;
+    }
+
+    m_current.processed++;
+    m_current.dropped += dropped;
+    if (now - timestamp > m_current.maxLatency)
+    {
+        m_current.maxLatency = now - timestamp;
+    }
+    m_totalProcessed++;
+    m_totalDropped += dropped;
+    return closed;
+}
+
+const FrameStats::Window &FrameStats::lastWindow() const
+{
+    return m_last;
+}
+
+uint64_t FrameStats::totalProcessed() const
+{
+    return m_totalProcessed;
+}
+
+uint64_t FrameStats::totalDropped() const
+{
+    return m_totalDropped;
+}
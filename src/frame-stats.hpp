@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAME_STATS_HPP
+#define FRAME_STATS_HPP
+
+#include <cstdint>
+
+// Finds out how many frames of the producer were skipped between two processed frames from their sample timestamps
+class DropDetector
+{
+   public:
+    // framePeriod is the time between two frames of the producer in microseconds; 0 estimates it
+    // as the shortest time seen between two processed frames
+    explicit DropDetector(int64_t framePeriod);
+
+    // Record that the frame with the given sample timestamp (microseconds) is processed and return
+    // the number of frames that were skipped since the previously processed frame
+    uint32_t update(int64_t timestamp);
+
+    // Time between two frames that is currently assumed, 0 while it is unknown
+    int64_t framePeriod() const;
+
+   private:
+    const bool m_estimate;
+    int64_t m_framePeriod;
+    int64_t m_lastTimestamp;
+};
+
+// Per-second counts of processed and dropped frames and the worst sample-to-output latency
+class FrameStats
+{
+   public:
+    struct Window
+    {
+        uint64_t processed;
+        uint64_t dropped;
+        // Largest time between the sample timestamp of a frame and its output in microseconds
+        int64_t maxLatency;
+    };
+
+    FrameStats();
+
+    // Add a frame with the given sample timestamp that was output at now (both in microseconds), after
+    // dropped frames were skipped. Returns true when this closed a window of one second, which is then
+    // available from lastWindow()
+    bool add(int64_t timestamp, int64_t now, uint32_t dropped);
+
+    const Window &lastWindow() const;
+    uint64_t totalProcessed() const;
+    uint64_t totalDropped() const;
+
+   private:
+    int64_t m_windowStart;
+    Window m_current;
+    Window m_last;
+    uint64_t m_totalProcessed;
+    uint64_t m_totalDropped;
+};
+
+#endif
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAME_WORKSPACE_HPP
+#define FRAME_WORKSPACE_HPP
+
+#include "bit-mask.hpp"
+#include "blob-extractor.hpp"
+#include "fused-segmentation.hpp"
+#include "projection-detector.hpp"
+#include "separable-blur.hpp"
+
+#include <opencv2/core/core.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// Part of the region of interest that the coarse-to-fine mode searches at full resolution, and the colors whose
+// coarse blobs asked for it
+struct RefineWindow
+{
+    cv::Rect rect;
+    bool blue;
+    bool yellow;
+};
+
+// Buffers that one stream needs to process a frame. They are allocated once for the region of interest
+// and reused for every frame, so the frame loop does not touch the heap once the first frame has been processed.
+struct FrameWorkspace
+{
+    // region is the region of interest, ingestRegion the region plus the rows around it that the blur reads
+    FrameWorkspace(const cv::Rect &region, const cv::Rect &ingestRegion)
+        : ingest(ingestRegion.height, ingestRegion.width, CV_8UC4)
+        , img(ingest(cv::Rect(region.x - ingestRegion.x, region.y - ingestRegion.y, region.width, region.height)))
+        , blueMask(region.height, region.width, CV_8UC1)
+        , yellowMask(region.height, region.width, CV_8UC1)
+        , blur()
+        , blueBlobs()
+        , yellowBlobs()
+        , segmentedPixels(0)
+        , coarse()
+        , coarseBlueMask()
+        , coarseYellowMask()
+        , coarseBlueBlobs()
+        , coarseYellowBlobs()
+        , refineWindows()
+        , refinedBlue()
+        , refinedYellow()
+        , blueBits()
+        , yellowBits()
+        , openScratch()
+        , blueProjection()
+        , yellowProjection()
+        , segmenter()
+    {
+    }
+
+    // Pixels copied out of the shared memory
+    cv::Mat ingest;
+    // Region of interest; a view into ingest
+    cv::Mat img;
+    cv::Mat blueMask;
+    cv::Mat yellowMask;
+    SeparableBlur blur;
+    BlobExtractor blueBlobs;
+    BlobExtractor yellowBlobs;
+    // Pixels of the last frame that were blurred and segmented
+    uint64_t segmentedPixels;
+    // Downsampled region of interest, its masks and blobs, the windows around them that are searched at full
+    // resolution and the blobs found there; only used by the coarse-to-fine mode and sized by its first frame
+    cv::Mat coarse;
+    cv::Mat coarseBlueMask;
+    cv::Mat coarseYellowMask;
+    BlobExtractor coarseBlueBlobs;
+    BlobExtractor coarseYellowBlobs;
+    std::vector<RefineWindow> refineWindows;
+    std::vector<Blob> refinedBlue;
+    std::vector<Blob> refinedYellow;
+    // Packed and opened masks of the searched windows and the eroded mask in between; only used when the masks are
+    // opened instead of blurring the image
+    BitMask blueBits;
+    BitMask yellowBits;
+    BitMask openScratch;
+    // Detectors of the projection mode
+    ProjectionDetector blueProjection;
+    ProjectionDetector yellowProjection;
+    // Blur and segmentation in one pass, only used when the blur is fused
+    FusedSegmenter segmenter;
+};
+
+#endif
@@ -0,0 +1,325 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fused-segmentation.hpp"
+#include "cpu-dispatch.hpp"
+#include "separable-blur.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+const int channels = 4;
+const int colors = 3;
+// Bytes behind a BGR row that the kernels may read or overwrite
+const size_t slack = 16;
+const int radius = SeparableBlur::RADIUS;
+} // namespace
+
+void bgrBlurRowHorizontalScalar(const uint8_t *padded, int width, uint8_t *bgr)
+{
+    const uint16_t *k = SeparableBlur::KERNEL;
+    for (int x = 0; x < width; x++, padded += channels, bgr += colors)
+    {
+        for (int c = 0; c < colors; c++)
+        {
+            const uint32_t sum{k[0] * static_cast<uint32_t>(padded[c] + padded[c + 6 * channels]) + k[1] * static_cast<uint32_t>(padded[c + channels] + padded[c + 5 * channels]) +
+                               k[2] * static_cast<uint32_t>(padded[c + 2 * channels] + padded[c + 4 * channels]) + k[3] * static_cast<uint32_t>(padded[c + 3 * channels])};
+            bgr[c] = static_cast<uint8_t>((sum + (1u << 7)) >> 8);
+        }
+    }
+}
+
+void bgrBlurRowVerticalScalar(const uint8_t *const *rows, int n, uint8_t *out)
+{
+    const uint16_t *k = SeparableBlur::KERNEL;
+    for (int i = 0; i < n; i++)
+    {
+        const uint32_t sum{k[0] * static_cast<uint32_t>(rows[0][i] + rows[6][i]) + k[1] * static_cast<uint32_t>(rows[1][i] + rows[5][i]) +
+                           k[2] * static_cast<uint32_t>(rows[2][i] + rows[4][i]) + k[3] * static_cast<uint32_t>(rows[3][i])};
+        out[i] = static_cast<uint8_t>((sum + (1u << 7)) >> 8);
+    }
+}
+
+void bgrToBgraRowScalar(const uint8_t *bgr, int width, uint8_t *bgra)
+{
+    for (int x = 0; x < width; x++, bgr += colors, bgra += channels)
+    {
+        bgra[0] = bgr[0];
+        bgra[1] = bgr[1];
+        bgra[2] = bgr[2];
+        bgra[3] = 0;
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("sse4.1"))) void bgrBlurRowHorizontalSse41(const uint8_t *padded, int width, uint8_t *bgr)
+{
+    const uint16_t *k = SeparableBlur::KERNEL;
+    const __m128i k1 = _mm_set1_epi16(static_cast<int16_t>(k[1]));
+    const __m128i k2 = _mm_set1_epi16(static_cast<int16_t>(k[2]));
+    const __m128i k3 = _mm_set1_epi16(static_cast<int16_t>(k[3]));
+    const __m128i round = _mm_set1_epi16(1 << 7);
+    // Drop the alpha byte of every pixel
+    const __m128i toBgr = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+    int x = 0;
+    for (; x + 4 <= width; x += 4)
+    {
+        // Widen four pixels of every tap to 16 bits; the weighted sum of 8-bit values never exceeds 255 * 256
+        __m128i low[SeparableBlur::KERNEL_SIZE], high[SeparableBlur::KERNEL_SIZE];
+        for (int t = 0; t < SeparableBlur::KERNEL_SIZE; t++)
+        {
+            const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(padded + channels * (x + t)));
+            low[t] = _mm_cvtepu8_epi16(pixels);
+            high[t] = _mm_cvtepu8_epi16(_mm_srli_si128(pixels, 8));
+        }
+        __m128i sumLow = _mm_add_epi16(_mm_add_epi16(low[0], low[6]), round);
+        sumLow = _mm_add_epi16(sumLow, _mm_mullo_epi16(k1, _mm_add_epi16(low[1], low[5])));
+        sumLow = _mm_add_epi16(sumLow, _mm_mullo_epi16(k2, _mm_add_epi16(low[2], low[4])));
+        sumLow = _mm_add_epi16(sumLow, _mm_mullo_epi16(k3, low[3]));
+        __m128i sumHigh = _mm_add_epi16(_mm_add_epi16(high[0], high[6]), round);
+        sumHigh = _mm_add_epi16(sumHigh, _mm_mullo_epi16(k1, _mm_add_epi16(high[1], high[5])));
+        sumHigh = _mm_add_epi16(sumHigh, _mm_mullo_epi16(k2, _mm_add_epi16(high[2], high[4])));
+        sumHigh = _mm_add_epi16(sumHigh, _mm_mullo_epi16(k3, high[3]));
+
+        // The 4 bytes behind the 12 BGR bytes are overwritten by the next step or lie in the slack
+        const __m128i pixels = _mm_packus_epi16(_mm_srli_epi16(sumLow, 8), _mm_srli_epi16(sumHigh, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(bgr + colors * x), _mm_shuffle_epi8(pixels, toBgr));
+    }
+    bgrBlurRowHorizontalScalar(padded + channels * x, width - x, bgr + colors * x);
+}
+
+__attribute__((target("sse4.1"))) void bgrBlurRowVerticalSse41(const uint8_t *const *rows, int n, uint8_t *out)
+{
+    const uint16_t *k = SeparableBlur::KERNEL;
+    const __m128i k1 = _mm_set1_epi16(static_cast<int16_t>(k[1]));
+    const __m128i k2 = _mm_set1_epi16(static_cast<int16_t>(k[2]));
+    const __m128i k3 = _mm_set1_epi16(static_cast<int16_t>(k[3]));
+    const __m128i round = _mm_set1_epi16(1 << 7);
+
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i low[SeparableBlur::KERNEL_SIZE], high[SeparableBlur::KERNEL_SIZE];
+        for (int t = 0; t < SeparableBlur::KERNEL_SIZE; t++)
+        {
+            const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows[t] + i));
+            low[t] = _mm_cvtepu8_epi16(values);
+            high[t] = _mm_cvtepu8_epi16(_mm_srli_si128(values, 8));
+        }
+        __m128i sumLow = _mm_add_epi16(_mm_add_epi16(low[0], low[6]), round);
+        sumLow = _mm_add_epi16(sumLow, _mm_mullo_epi16(k1, _mm_add_epi16(low[1], low[5])));
+        sumLow = _mm_add_epi16(sumLow, _mm_mullo_epi16(k2, _mm_add_epi16(low[2], low[4])));
+        sumLow = _mm_add_epi16(sumLow, _mm_mullo_epi16(k3, low[3]));
+        __m128i sumHigh = _mm_add_epi16(_mm_add_epi16(high[0], high[6]), round);
+        sumHigh = _mm_add_epi16(sumHigh, _mm_mullo_epi16(k1, _mm_add_epi16(high[1], high[5])));
+        sumHigh = _mm_add_epi16(sumHigh, _mm_mullo_epi16(k2, _mm_add_epi16(high[2], high[4])));
+        sumHigh = _mm_add_epi16(sumHigh, _mm_mullo_epi16(k3, high[3]));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packus_epi16(_mm_srli_epi16(sumLow, 8), _mm_srli_epi16(sumHigh, 8)));
+    }
+    const uint8_t *rest[SeparableBlur::KERNEL_SIZE];
+    for (int t = 0; t < SeparableBlur::KERNEL_SIZE; t++)
+    {
+        rest[t] = rows[t] + i;
+    }
+    bgrBlurRowVerticalScalar(rest, n - i, out + i);
+}
+
+__attribute__((target("sse4.1"))) void bgrToBgraRowSse41(const uint8_t *bgr, int width, uint8_t *bgra)
+{
+    const __m128i toBgra = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    int x = 0;
+    for (; x + 4 <= width; x += 4)
+    {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bgr + colors * x));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(bgra + channels * x), _mm_shuffle_epi8(pixels, toBgra));
+    }
+    bgrToBgraRowScalar(bgr + colors * x, width - x, bgra + channels * x);
+}
+
+__attribute__((target("avx2"))) void bgrBlurRowHorizontalAvx2(const uint8_t *padded, int width, uint8_t *bgr)
+{
+    const uint16_t *k = SeparableBlur::KERNEL;
+    const __m256i k1 = _mm256_set1_epi16(static_cast<int16_t>(k[1]));
+    const __m256i k2 = _mm256_set1_epi16(static_cast<int16_t>(k[2]));
+    const __m256i k3 = _mm256_set1_epi16(static_cast<int16_t>(k[3]));
+    const __m256i round = _mm256_set1_epi16(1 << 7);
+    // Drop the alpha byte of every pixel in both 128-bit lanes
+    const __m256i toBgr = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        // Widen eight pixels of every tap to 16 bits; the weighted sum of 8-bit values never exceeds 255 * 256
+        __m256i low[SeparableBlur::KERNEL_SIZE], high[SeparableBlur::KERNEL_SIZE];
+        for (int t = 0; t < SeparableBlur::KERNEL_SIZE; t++)
+        {
+            const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(padded + channels * (x + t)));
+            low[t] = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(pixels));
+            high[t] = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(pixels, 1));
+        }
+        __m256i sumLow = _mm256_add_epi16(_mm256_add_epi16(low[0], low[6]), round);
+        sumLow = _mm256_add_epi16(sumLow, _mm256_mullo_epi16(k1, _mm256_add_epi16(low[1], low[5])));
+        sumLow = _mm256_add_epi16(sumLow, _mm256_mullo_epi16(k2, _mm256_add_epi16(low[2], low[4])));
+        sumLow = _mm256_add_epi16(sumLow, _mm256_mullo_epi16(k3, low[3]));
+        __m256i sumHigh = _mm256_add_epi16(_mm256_add_epi16(high[0], high[6]), round);
+        sumHigh = _mm256_add_epi16(sumHigh, _mm256_mullo_epi16(k1, _mm256_add_epi16(high[1], high[5])));
+        sumHigh = _mm256_add_epi16(sumHigh, _mm256_mullo_epi16(k2, _mm256_add_epi16(high[2], high[4])));
+        sumHigh = _mm256_add_epi16(sumHigh, _mm256_mullo_epi16(k3, high[3]));
+
+        // Packing works within 128-bit lanes, so put pixels 0..3 back into the low and 4..7 into the high lane
+        const __m256i packed = _mm256_packus_epi16(_mm256_srli_epi16(sumLow, 8), _mm256_srli_epi16(sumHigh, 8));
+        const __m256i pixels = _mm256_shuffle_epi8(_mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)), toBgr);
+        // The 4 bytes behind each 12 BGR bytes are overwritten by the next store or lie in the slack
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(bgr + colors * x), _mm256_castsi256_si128(pixels));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(bgr + colors * (x + 4)), _mm256_extracti128_si256(pixels, 1));
+    }
+    bgrBlurRowHorizontalSse41(padded + channels * x, width - x, bgr + colors * x);
+}
+
+__attribute__((target("avx2"))) void bgrBlurRowVerticalAvx2(const uint8_t *const *rows, int n, uint8_t *out)
+{
+    const uint16_t *k = SeparableBlur::KERNEL;
+    const __m256i k1 = _mm256_set1_epi16(static_cast<int16_t>(k[1]));
+    const __m256i k2 = _mm256_set1_epi16(static_cast<int16_t>(k[2]));
+    const __m256i k3 = _mm256_set1_epi16(static_cast<int16_t>(k[3]));
+    const __m256i round = _mm256_set1_epi16(1 << 7);
+
+    int i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        __m256i low[SeparableBlur::KERNEL_SIZE], high[SeparableBlur::KERNEL_SIZE];
+        for (int t = 0; t < SeparableBlur::KERNEL_SIZE; t++)
+        {
+            const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rows[t] + i));
+            low[t] = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(values));
+            high[t] = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(values, 1));
+        }
+        __m256i sumLow = _mm256_add_epi16(_mm256_add_epi16(low[0], low[6]), round);
+        sumLow = _mm256_add_epi16(sumLow, _mm256_mullo_epi16(k1, _mm256_add_epi16(low[1], low[5])));
+        sumLow = _mm256_add_epi16(sumLow, _mm256_mullo_epi16(k2, _mm256_add_epi16(low[2], low[4])));
+        sumLow = _mm256_add_epi16(sumLow, _mm256_mullo_epi16(k3, low[3]));
+        __m256i sumHigh = _mm256_add_epi16(_mm256_add_epi16(high[0], high[6]), round);
+        sumHigh = _mm256_add_epi16(sumHigh, _mm256_mullo_epi16(k1, _mm256_add_epi16(high[1], high[5])));
+        sumHigh = _mm256_add_epi16(sumHigh, _mm256_mullo_epi16(k2, _mm256_add_epi16(high[2], high[4])));
+        sumHigh = _mm256_add_epi16(sumHigh, _mm256_mullo_epi16(k3, high[3]));
+
+        // Packing works within 128-bit lanes: restore the order of the four 8-byte groups
+        const __m256i packed = _mm256_packus_epi16(_mm256_srli_epi16(sumLow, 8), _mm256_srli_epi16(sumHigh, 8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+    const uint8_t *rest[SeparableBlur::KERNEL_SIZE];
+    for (int t = 0; t < SeparableBlur::KERNEL_SIZE; t++)
+    {
+        rest[t] = rows[t] + i;
+    }
+    bgrBlurRowVerticalSse41(rest, n - i, out + i);
+}
+#endif
+
+FusedSegmenter::FusedSegmenter()
+    : m_width(0)
+    , m_top(0)
+    , m_bottom(0)
+    , m_left(0)
+    , m_right(0)
+    , m_rowSize(0)
+    , m_padded()
+    , m_ring()
+    , m_bgr()
+    , m_bgra()
+{
+}
+
+uint8_t *FusedSegmenter::slot(int y)
+{
+    const int index{((y % SeparableBlur::KERNEL_SIZE) + SeparableBlur::KERNEL_SIZE) % SeparableBlur::KERNEL_SIZE};
+    return m_ring.data() + static_cast<size_t>(index) * m_rowSize;
+}
+
+void FusedSegmenter::horizontal(const cv::Mat &src, int y, BgrBlurRowHorizontal kernel)
+{
+    // Rows and columns outside of the view are read from the parent image as long as it has them; the source is
+    // never written, so rows below it can be read again
+    const uint8_t *row = src.data + static_cast<ptrdiff_t>(reflect101(y, m_top, m_bottom)) * static_cast<ptrdiff_t>(src.step[0]);
+    uint8_t *padded = m_padded.data();
+    std::memcpy(padded + radius * channels, row, static_cast<size_t>(m_width * channels));
+    for (int x = 1; x <= radius; x++)
+    {
+        std::memcpy(padded + (radius - x) * channels, row + reflect101(-x, m_left, m_right) * channels, channels);
+        std::memcpy(padded + (radius + m_width - 1 + x) * channels, row + reflect101(m_width - 1 + x, m_left, m_right) * channels, channels);
+    }
+    kernel(padded, m_width, slot(y));
+}
+
+void FusedSegmenter::apply(const cv::Mat &src, const HsvRange &first, const HsvRange &second, const ColorLut *lut, cv::Mat &firstMask, cv::Mat &secondMask)
+{
+    CV_Assert(src.type() == CV_8UC4);
+    CV_Assert(src.rows > radius && src.cols > radius);
+    CV_Assert(firstMask.type() == CV_8UC1 && firstMask.size() == src.size());
+    CV_Assert(secondMask.type() == CV_8UC1 && secondMask.size() == src.size());
+
+    // Find out how far the parent image of the view extends in each direction
+    cv::Size whole;
+    cv::Point offset;
+    src.locateROI(whole, offset);
+    m_top = -offset.y;
+    m_bottom = whole.height - offset.y - 1;
+    m_left = -offset.x;
+    m_right = whole.width - offset.x - 1;
+
+    m_width = src.cols;
+    m_rowSize = static_cast<size_t>(colors * m_width) + slack;
+    if (m_ring.size() < SeparableBlur::KERNEL_SIZE * m_rowSize)
+    {
+        m_ring.resize(SeparableBlur::KERNEL_SIZE * m_rowSize);
+        m_padded.resize(static_cast<size_t>((m_width + 2 * radius) * channels));
+        m_bgr.resize(m_rowSize);
+        m_bgra.resize(static_cast<size_t>(channels * m_width));
+    }
+
+    const VisionKernels &kernels = visionKernels();
+    for (int y = -radius; y < radius; y++)
+    {
+        horizontal(src, y, kernels.bgrBlurRowHorizontal);
+    }
+    const uint8_t *rows[SeparableBlur::KERNEL_SIZE];
+    for (int y = 0; y < src.rows; y++)
+    {
+        horizontal(src, y + radius, kernels.bgrBlurRowHorizontal);
+        for (int t = 0; t < SeparableBlur::KERNEL_SIZE; t++)
+        {
+            rows[t] = slot(y - radius + t);
+        }
+        // Blur one row and classify it while it is still in the cache
+        kernels.bgrBlurRowVertical(rows, colors * m_width, m_bgr.data());
+        kernels.bgrToBgraRow(m_bgr.data(), m_width, m_bgra.data());
+        if (lut != nullptr)
+        {
+            lut->classifyRow(m_bgra.data(), m_width, firstMask.ptr<uint8_t>(y), secondMask.ptr<uint8_t>(y));
+        }
+        else
+        {
+            kernels.hsvThresholdRow(m_bgra.data(), m_width, first, second, firstMask.ptr<uint8_t>(y), secondMask.ptr<uint8_t>(y));
+        }
+    }
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FUSED_SEGMENTATION_HPP
+#define FUSED_SEGMENTATION_HPP
+
+#include "color-lut.hpp"
+#include "hsv-threshold.hpp"
+
+#include <opencv2/core/core.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// Kernel that blurs width BGRA pixels horizontally into BGR bytes; padded holds SeparableBlur::RADIUS pixels of
+// border in front of and behind the row, and 16 bytes behind the 3 * width output bytes may be overwritten
+typedef void (*BgrBlurRowHorizontal)(const uint8_t *padded, int width, uint8_t *bgr);
+// Kernel that blurs n bytes vertically from the horizontally blurred rows y - RADIUS .. y + RADIUS
+typedef void (*BgrBlurRowVertical)(const uint8_t *const *rows, int n, uint8_t *out);
+// Kernel that spreads width BGR pixels to BGRA with an alpha of 0; 4 bytes behind the input must be readable
+typedef void (*BgrToBgraRow)(const uint8_t *bgr, int width, uint8_t *bgra);
+
+// Portable reference kernels
+void bgrBlurRowHorizontalScalar(const uint8_t *padded, int width, uint8_t *bgr);
+void bgrBlurRowVerticalScalar(const uint8_t *const *rows, int n, uint8_t *out);
+void bgrToBgraRowScalar(const uint8_t *bgr, int width, uint8_t *bgra);
+#if defined(__x86_64__) || defined(__i386__)
+// Kernels processing 4 (SSE4.1) or 8 (AVX2) pixels or 16 or 32 bytes per step; only call them when the CPU supports
+// the instruction set. FusedSegmenter picks them through visionKernels() in cpu-dispatch.hpp.
+void bgrBlurRowHorizontalSse41(const uint8_t *padded, int width, uint8_t *bgr);
+void bgrBlurRowVerticalSse41(const uint8_t *const *rows, int n, uint8_t *out);
+void bgrToBgraRowSse41(const uint8_t *bgr, int width, uint8_t *bgra);
+void bgrBlurRowHorizontalAvx2(const uint8_t *padded, int width, uint8_t *bgr);
+void bgrBlurRowVerticalAvx2(const uint8_t *const *rows, int n, uint8_t *out);
+#endif
+
+// Blur and segmentation in one pass: blurs the three color channels of a BGRA view with the 7x7 kernel of
+// SeparableBlur and classifies every row as soon as it is blurred, so the blurred image is never written and
+// alpha is never blurred. Borders are handled like SeparableBlur does. The horizontal pass rounds to 8 bits so that
+// the vertical pass fits into 16-bit lanes; each blurred channel is therefore within 1 of cv::GaussianBlur, and
+// pixels whose color lies right at a threshold may be classified differently.
+class FusedSegmenter
+{
+   public:
+    FusedSegmenter();
+
+    // Blur src and test it against two HSV ranges, with the lookup table if lut is not nullptr; both masks must be
+    // preallocated as CV_8UC1 with the size of src
+    void apply(const cv::Mat &src, const HsvRange &first, const HsvRange &second, const ColorLut *lut, cv::Mat &firstMask, cv::Mat &secondMask);
+
+   private:
+    // Blur source row y (relative to src, may lie outside of it) horizontally into its slot of the ring
+    void horizontal(const cv::Mat &src, int y, BgrBlurRowHorizontal kernel);
+    uint8_t *slot(int y);
+
+    int m_width;
+    int m_top;
+    int m_bottom;
+    int m_left;
+    int m_right;
+    // Bytes per row of the ring, including the slack the kernels may overwrite
+    size_t m_rowSize;
+    // Source row with RADIUS pixels of border on both sides
+    std::vector<uint8_t> m_padded;
+    // Horizontally blurred BGR rows y - RADIUS .. y + RADIUS of the current output row y
+    std::vector<uint8_t> m_ring;
+    // Blurred output row as BGR and as BGRA for the classifiers
+    std::vector<uint8_t> m_bgr;
+    std::vector<uint8_t> m_bgra;
+};
+
+#endif
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "h264-decoder.hpp"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/frame.h>
+}
+
+#include <stdexcept>
+
+namespace
+{
+// libyuv's kYuvI601Constants, scaled by 64
+const int32_t YG = 18997;
+const int32_t YGB = -1160;
+const int32_t UB = -128;
+const int32_t UG = 25;
+const int32_t VG = 52;
+const int32_t VR = -102;
+const int32_t BB = UB * 128 + YGB;
+const int32_t BG = UG * 128 + VG * 128 + YGB;
+const int32_t BR = VR * 128 + YGB;
+
+inline uint8_t clamp(int32_t value)
+{
+    return static_cast<uint8_t>((value < 0) ? 0 : ((value > 255) ? 255 : value));
+}
+} // namespace
+
+void i420ToBgra(const uint8_t *y, int strideY, const uint8_t *u, int strideU, const uint8_t *v, int strideV, cv::Mat &bgra)
+{
+    for (int row = 0; row < bgra.rows; row++)
+    {
+        const uint8_t *yRow = y + row * strideY;
+        const uint8_t *uRow = u + (row / 2) * strideU;
+        const uint8_t *vRow = v + (row / 2) * strideV;
+        uint8_t *out = bgra.ptr<uint8_t>(row);
+        for (int col = 0; col < bgra.cols; col++)
+        {
+            const int32_t y1{static_cast<int32_t>((static_cast<uint32_t>(yRow[col]) * 0x0101u * static_cast<uint32_t>(YG)) >> 16)};
+            const int32_t cb{uRow[col / 2]};
+            const int32_t cr{vRow[col / 2]};
+            out[4 * col + 0] = clamp((-(cb * UB) + y1 + BB) >> 6);
+            out[4 * col + 1] = clamp((-(cb * UG + cr * VG) + y1 + BG) >> 6);
+            out[4 * col + 2] = clamp((-(cr * VR) + y1 + BR) >> 6);
+            out[4 * col + 3] = 255;
+        }
+    }
+}
+
+H264Decoder::H264Decoder()
+    : m_context(nullptr)
+    , m_packet(nullptr)
+    , m_frame(nullptr)
+{
+#if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(58, 9, 100)
+    avcodec_register_all();
+#endif
+    const AVCodec *codec = avcodec_find_decoder(AV_CODEC_ID_H264);
+    if (codec == nullptr)
+    {
+        throw std::runtime_error("libavcodec has no h264 decoder");
+    }
+    m_context = avcodec_alloc_context3(codec);
+    m_packet = av_packet_alloc();
+    m_frame = av_frame_alloc();
+    if ((m_context != nullptr) && (m_packet != nullptr) && (m_frame != nullptr))
+    {
+        // Decode on the calling thread so that every frame comes out right after its data went in
+        m_context->thread_count = 1;
+        m_context->flags |= AV_CODEC_FLAG_LOW_DELAY;
+    }
+    if ((m_context == nullptr) || (m_packet == nullptr) || (m_frame == nullptr) || (avcodec_open2(m_context, codec, nullptr) < 0))
+    {
+        av_frame_free(&m_frame);
+        av_packet_free(&m_packet);
+        avcodec_free_context(&m_context);
+        throw std::runtime_error("Failed to open the h264 decoder");
+    }
+}
+
+H264Decoder::~H264Decoder()
+{
+    av_frame_free(&m_frame);
+    av_packet_free(&m_packet);
+    avcodec_free_context(&m_context);
+}
+
+bool H264Decoder::decode(const uint8_t *data, size_t size, cv::Mat &bgra)
+{
+    m_packet->data = const_cast<uint8_t *>(data);
+    m_packet->size = static_cast<int>(size);
+    if (avcodec_send_packet(m_context, m_packet) < 0)
+    {
+        return false;
+    }
+    if (avcodec_receive_frame(m_context, m_frame) < 0)
+    {
+        return false;
+    }
+    // The encoder of the vehicle view writes 8-bit 4:2:0 only
+    const bool i420{(m_frame->format == AV_PIX_FMT_YUV420P) || (m_frame->format == AV_PIX_FMT_YUVJ420P)};
+    if (i420)
+    {
+        bgra.create(m_frame->height, m_frame->width, CV_8UC4);
+        i420ToBgra(m_frame->data[0], m_frame->linesize[0], m_frame->data[1], m_frame->linesize[1], m_frame->data[2], m_frame->linesize[2], bgra);
+    }
+    av_frame_unref(m_frame);
+    return i420;
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H264_DECODER_HPP
+#define H264_DECODER_HPP
+
+#include <opencv2/core/core.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+struct AVCodecContext;
+struct AVFrame;
+struct AVPacket;
+
+// Decodes the h264 frames of opendlv.proxy.ImageReading messages into BGRA images with libavcodec.
+// H.264 decoding is bit-exact, and the YUV to BGRA conversion uses the same BT.601 fixed-point formula as
+// libyuv's I420ToARGB in the h264 decoder microservice, so the images match what the microservice receives
+// in the shared memory.
+class H264Decoder
+{
+   public:
+    H264Decoder();
+    ~H264Decoder();
+
+    H264Decoder(const H264Decoder &) = delete;
+    H264Decoder &operator=(const H264Decoder &) = delete;
+
+    // Decode one frame; returns false if the data did not complete a picture or could not be decoded
+    bool decode(const uint8_t *data, size_t size, cv::Mat &bgra);
+
+   private:
+    AVCodecContext *m_context;
+    AVPacket *m_packet;
+    AVFrame *m_frame;
+};
+
+// Convert an I420 image with libyuv's BT.601 limited range integer formula
+void i420ToBgra(const uint8_t *y, int strideY, const uint8_t *u, int strideU, const uint8_t *v, int strideV, cv::Mat &bgra);
+
+#endif
@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hsv-threshold.hpp"
+#include "cpu-dispatch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+// Fixed-point precision and hue range used by OpenCV's 8-bit BGR to HSV conversion
+const int hsvShift = 12;
+const int hsvRound = 1 << (hsvShift - 1);
+const int hueRange = 180;
+
+// Reciprocal tables used by OpenCV to turn the divisions of the HSV formula into multiplications
+struct HsvTables
+{
+    int32_t sdiv[256];
+    int32_t hdiv[256];
+
+    HsvTables()
+        : sdiv()
+        , hdiv()
+    {
+        for (int i = 1; i < 256; i++)
+        {
+            sdiv[i] = static_cast<int32_t>(std::nearbyint((255 << hsvShift) / (1.0 * i)));
+            hdiv[i] = static_cast<int32_t>(std::nearbyint((hueRange << hsvShift) / (6.0 * i)));
+        }
+    }
+};
+
+const HsvTables &tables()
+{
+    static const HsvTables TABLES;
+    return TABLES;
+}
+
+// Convert one pixel exactly like RGB2HSV_b in OpenCV's color conversion
+inline void toHsv(int b, int g, int r, const HsvTables &t, int &h, int &s, int &v)
+{
+    v = std::max(std::max(b, g), r);
+    const int vmin{std::min(std::min(b, g), r)};
+    const int diff{v - vmin};
+    const int vr{v == r ? -1 : 0};
+    const int vg{v == g ? -1 : 0};
+
+    s = (diff * t.sdiv[v] + hsvRound) >> hsvShift;
+    h = (vr & (g - b)) + (~vr & ((vg & (b - r + 2 * diff)) + ((~vg) & (r - g + 4 * diff))));
+    h = (h * t.hdiv[diff] + hsvRound) >> hsvShift;
+    h += h < 0 ? hueRange : 0;
+    h = std::min(std::max(h, 0), 255);
+}
+
+inline bool inRange(int h, int s, int v, const HsvRange &range)
+{
+    return (range.low[0] <= h) && (h <= range.high[0]) && (range.low[1] <= s) && (s <= range.high[1]) && (range.low[2] <= v) && (v <= range.high[2]);
+}
+
+uint8_t toBound(double value)
+{
+    return static_cast<uint8_t>(std::min(std::max(std::nearbyint(value), 0.0), 255.0));
+}
+} // namespace
+
+HsvRange toHsvRange(const cv::Scalar &low, const cv::Scalar &high)
+{
+    HsvRange range;
+    for (int i = 0; i < 3; i++)
+    {
+        range.low[i] = toBound(low[i]);
+        range.high[i] = toBound(high[i]);
+    }
+    return range;
+}
+
+void hsvThresholdRowScalar(const uint8_t *bgra, int width, const HsvRange &first, const HsvRange &second, uint8_t *firstMask, uint8_t *secondMask)
+{
+    const HsvTables &t = tables();
+    for (int x = 0; x < width; x++, bgra += 4)
+    {
+        int h, s, v;
+        toHsv(bgra[0], bgra[1], bgra[2], t, h, s, v);
+        firstMask[x] = inRange(h, s, v, first) ? 255 : 0;
+        secondMask[x] = inRange(h, s, v, second) ? 255 : 0;
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("sse4.1"))) void hsvThresholdRowSse41(const uint8_t *bgra, int width, const HsvRange &first, const HsvRange &second, uint8_t *firstMask, uint8_t *secondMask)
+{
+    const HsvTables &t = tables();
+    const __m128i byteMask = _mm_set1_epi32(0xff);
+    const __m128i round = _mm_set1_epi32(hsvRound);
+    const __m128i hue = _mm_set1_epi32(hueRange);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i maxByte = _mm_set1_epi32(255);
+    __m128i firstLow[3], firstHigh[3], secondLow[3], secondHigh[3];
+    for (int c = 0; c < 3; c++)
+    {
+        firstLow[c] = _mm_set1_epi32(first.low[c]);
+        firstHigh[c] = _mm_set1_epi32(first.high[c]);
+        secondLow[c] = _mm_set1_epi32(second.low[c]);
+        secondHigh[c] = _mm_set1_epi32(second.high[c]);
+    }
+
+    int x = 0;
+    for (; x + 4 <= width; x += 4)
+    {
+        // Split four BGRA pixels into one 32-bit lane per channel
+        const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bgra + 4 * x));
+        const __m128i b = _mm_and_si128(px, byteMask);
+        const __m128i g = _mm_and_si128(_mm_srli_epi32(px, 8), byteMask);
+        const __m128i r = _mm_and_si128(_mm_srli_epi32(px, 16), byteMask);
+
+        const __m128i v = _mm_max_epi32(_mm_max_epi32(b, g), r);
+        const __m128i diff = _mm_sub_epi32(v, _mm_min_epi32(_mm_min_epi32(b, g), r));
+        const __m128i vr = _mm_cmpeq_epi32(v, r);
+        const __m128i vg = _mm_cmpeq_epi32(v, g);
+
+        // SSE4.1 has no gather, so the reciprocals are looked up lane by lane
+        const __m128i sdiv = _mm_setr_epi32(t.sdiv[_mm_extract_epi32(v, 0)], t.sdiv[_mm_extract_epi32(v, 1)], t.sdiv[_mm_extract_epi32(v, 2)], t.sdiv[_mm_extract_epi32(v, 3)]);
+        const __m128i hdiv = _mm_setr_epi32(t.hdiv[_mm_extract_epi32(diff, 0)], t.hdiv[_mm_extract_epi32(diff, 1)], t.hdiv[_mm_extract_epi32(diff, 2)], t.hdiv[_mm_extract_epi32(diff, 3)]);
+
+        const __m128i s = _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32(diff, sdiv), round), hsvShift);
+        const __m128i hr = _mm_sub_epi32(g, b);
+        const __m128i hg = _mm_add_epi32(_mm_sub_epi32(b, r), _mm_slli_epi32(diff, 1));
+        const __m128i hb = _mm_add_epi32(_mm_sub_epi32(r, g), _mm_slli_epi32(diff, 2));
+        __m128i h = _mm_blendv_epi8(_mm_blendv_epi8(hb, hg, vg), hr, vr);
+        h = _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32(h, hdiv), round), hsvShift);
+        h = _mm_add_epi32(h, _mm_and_si128(_mm_cmpgt_epi32(zero, h), hue));
+        h = _mm_min_epi32(_mm_max_epi32(h, zero), maxByte);
+
+        // A lane is outside of a range as soon as one channel is below the low or above the high bound
+        const __m128i firstOut = _mm_or_si128(
+            _mm_or_si128(_mm_or_si128(_mm_cmpgt_epi32(firstLow[0], h), _mm_cmpgt_epi32(h, firstHigh[0])), _mm_or_si128(_mm_cmpgt_epi32(firstLow[1], s), _mm_cmpgt_epi32(s, firstHigh[1]))),
+            _mm_or_si128(_mm_cmpgt_epi32(firstLow[2], v), _mm_cmpgt_epi32(v, firstHigh[2])));
+        const __m128i secondOut = _mm_or_si128(
+            _mm_or_si128(_mm_or_si128(_mm_cmpgt_epi32(secondLow[0], h), _mm_cmpgt_epi32(h, secondHigh[0])), _mm_or_si128(_mm_cmpgt_epi32(secondLow[1], s), _mm_cmpgt_epi32(s, secondHigh[1]))),
+            _mm_or_si128(_mm_cmpgt_epi32(secondLow[2], v), _mm_cmpgt_epi32(v, secondHigh[2])));
+
+        // Narrow the 32-bit lane masks to bytes
+        const int32_t firstWord{_mm_cvtsi128_si32(_mm_packus_epi16(_mm_packs_epi32(_mm_andnot_si128(firstOut, maxByte), zero), zero))};
+        const int32_t secondWord{_mm_cvtsi128_si32(_mm_packus_epi16(_mm_packs_epi32(_mm_andnot_si128(secondOut, maxByte), zero), zero))};
+        std::memcpy(firstMask + x, &firstWord, sizeof(firstWord));
+        std::memcpy(secondMask + x, &secondWord, sizeof(secondWord));
+    }
+    hsvThresholdRowScalar(bgra + 4 * x, width - x, first, second, firstMask + x, secondMask + x);
+}
+
+__attribute__((target("avx2"))) void hsvThresholdRowAvx2(const uint8_t *bgra, int width, const HsvRange &first, const HsvRange &second, uint8_t *firstMask, uint8_t *secondMask)
+{
+    const HsvTables &t = tables();
+    const __m256i byteMask = _mm256_set1_epi32(0xff);
+    const __m256i round = _mm256_set1_epi32(hsvRound);
+    const __m256i hue = _mm256_set1_epi32(hueRange);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i maxByte = _mm256_set1_epi32(255);
+    __m256i firstLow[3], firstHigh[3], secondLow[3], secondHigh[3];
+    for (int c = 0; c < 3; c++)
+    {
+        firstLow[c] = _mm256_set1_epi32(first.low[c]);
+        firstHigh[c] = _mm256_set1_epi32(first.high[c]);
+        secondLow[c] = _mm256_set1_epi32(second.low[c]);
+        secondHigh[c] = _mm256_set1_epi32(second.high[c]);
+    }
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        // Split eight BGRA pixels into one 32-bit lane per channel
+        const __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bgra + 4 * x));
+        const __m256i b = _mm256_and_si256(px, byteMask);
+        const __m256i g = _mm256_and_si256(_mm256_srli_epi32(px, 8), byteMask);
+        const __m256i r = _mm256_and_si256(_mm256_srli_epi32(px, 16), byteMask);
+
+        const __m256i v = _mm256_max_epi32(_mm256_max_epi32(b, g), r);
+        const __m256i diff = _mm256_sub_epi32(v, _mm256_min_epi32(_mm256_min_epi32(b, g), r));
+        const __m256i vr = _mm256_cmpeq_epi32(v, r);
+        const __m256i vg = _mm256_cmpeq_epi32(v, g);
+
+        const __m256i sdiv = _mm256_i32gather_epi32(t.sdiv, v, 4);
+        const __m256i hdiv = _mm256_i32gather_epi32(t.hdiv, diff, 4);
+
+        const __m256i s = _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(diff, sdiv), round), hsvShift);
+        const __m256i hr = _mm256_sub_epi32(g, b);
+        const __m256i hg = _mm256_add_epi32(_mm256_sub_epi32(b, r), _mm256_slli_epi32(diff, 1));
+        const __m256i hb = _mm256_add_epi32(_mm256_sub_epi32(r, g), _mm256_slli_epi32(diff, 2));
+        __m256i h = _mm256_blendv_epi8(_mm256_blendv_epi8(hb, hg, vg), hr, vr);
+        h = _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(h, hdiv), round), hsvShift);
+        h = _mm256_add_epi32(h, _mm256_and_si256(_mm256_cmpgt_epi32(zero, h), hue));
+        h = _mm256_min_epi32(_mm256_max_epi32(h, zero), maxByte);
+
+        // A lane is outside of a range as soon as one channel is below the low or above the high bound
+        const __m256i firstOut = _mm256_or_si256(
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpgt_epi32(firstLow[0], h), _mm256_cmpgt_epi32(h, firstHigh[0])), _mm256_or_si256(_mm256_cmpgt_epi32(firstLow[1], s), _mm256_cmpgt_epi32(s, firstHigh[1]))),
+            _mm256_or_si256(_mm256_cmpgt_epi32(firstLow[2], v), _mm256_cmpgt_epi32(v, firstHigh[2])));
+        const __m256i secondOut = _mm256_or_si256(
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpgt_epi32(secondLow[0], h), _mm256_cmpgt_epi32(h, secondHigh[0])), _mm256_or_si256(_mm256_cmpgt_epi32(secondLow[1], s), _mm256_cmpgt_epi32(s, secondHigh[1]))),
+            _mm256_or_si256(_mm256_cmpgt_epi32(secondLow[2], v), _mm256_cmpgt_epi32(v, secondHigh[2])));
+
+        // Narrow the lane masks of both ranges to bytes: the first range ends up in the low, the second in the high 8 bytes
+        const __m256i in = _mm256_packs_epi32(_mm256_andnot_si256(firstOut, maxByte), _mm256_andnot_si256(secondOut, maxByte));
+        const __m128i words = _mm_packus_epi16(_mm256_castsi256_si128(in), _mm256_extracti128_si256(in, 1));
+        // words holds first[0..3], second[0..3], first[4..7], second[4..7]
+        const __m128i bytes = _mm_shuffle_epi32(words, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(firstMask + x), bytes);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(secondMask + x), _mm_unpackhi_epi64(bytes, bytes));
+    }
+    hsvThresholdRowScalar(bgra + 4 * x, width - x, first, second, firstMask + x, secondMask + x);
+}
+#endif
+
+void hsvThreshold(const cv::Mat &bgra, const HsvRange &first, const HsvRange &second, cv::Mat &firstMask, cv::Mat &secondMask)
+{
+    CV_Assert(bgra.type() == CV_8UC4);
+    CV_Assert(firstMask.type() == CV_8UC1 && firstMask.size() == bgra.size());
+    CV_Assert(secondMask.type() == CV_8UC1 && secondMask.size() == bgra.size());
+
+    const HsvThresholdRow kernel{visionKernels().hsvThresholdRow};
+    for (int y = 0; y < bgra.rows; y++)
+    {
+        kernel(bgra.ptr<uint8_t>(y), bgra.cols, first, second, firstMask.ptr<uint8_t>(y), secondMask.ptr<uint8_t>(y));
+    }
+}
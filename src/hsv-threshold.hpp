@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HSV_THRESHOLD_HPP
+#define HSV_THRESHOLD_HPP
+
+#include <opencv2/core/core.hpp>
+
+#include <cstdint>
+
+// Inclusive range in the 8-bit HSV space of cv::COLOR_BGR2HSV (hue 0..179, saturation and value 0..255)
+struct HsvRange
+{
+    uint8_t low[3];
+    uint8_t high[3];
+};
+
+// Convert the bounds that would be passed to cv::inRange into an HsvRange
+HsvRange toHsvRange(const cv::Scalar &low, const cv::Scalar &high);
+
+// Convert the pixels of a BGRA image to HSV and test them against two ranges in one pass.
+// The masks are bit-identical to cv::cvtColor(COLOR_BGR2HSV) followed by one cv::inRange per range.
+// Both masks must be preallocated as CV_8UC1 with the size of the image.
+void hsvThreshold(const cv::Mat &bgra, const HsvRange &first, const HsvRange &second, cv::Mat &firstMask, cv::Mat &secondMask);
+
+// Kernel that converts and thresholds one row of BGRA pixels into two masks
+typedef void (*HsvThresholdRow)(const uint8_t *bgra, int width, const HsvRange &first, const HsvRange &second, uint8_t *firstMask, uint8_t *secondMask);
+
+// Portable reference kernel
+void hsvThresholdRowScalar(const uint8_t *bgra, int width, const HsvRange &first, const HsvRange &second, uint8_t *firstMask, uint8_t *secondMask);
+#if defined(__x86_64__) || defined(__i386__)
+// Kernels processing 4 (SSE4.1) or 8 (AVX2) pixels per step; only call them when the CPU supports the instruction set.
+// The frame loop picks one through visionKernels() in cpu-dispatch.hpp.
+void hsvThresholdRowSse41(const uint8_t *bgra, int width, const HsvRange &first, const HsvRange &second, uint8_t *firstMask, uint8_t *secondMask);
+void hsvThresholdRowAvx2(const uint8_t *bgra, int width, const HsvRange &first, const HsvRange &second, uint8_t *firstMask, uint8_t *secondMask);
+#endif
+
+#endif
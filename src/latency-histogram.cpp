@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "latency-histogram.hpp"
+
+#include <cmath>
+
+namespace
+{
+// The histogram has a single writer, so a relaxed load and store is enough and avoids a locked instruction
+inline void increment(std::atomic<uint64_t> &counter)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+inline int mostSignificantBit(uint64_t value)
+{
+    return 63 - __builtin_clzll(value);
+}
+} // namespace
+
+LatencyHistogram::LatencyHistogram()
+    : m_count(0)
+    , m_max(0)
+{
+    for (size_t i = 0; i < BUCKETS; i++)
+    {
+        m_counts[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t LatencyHistogram::bucketOf(uint64_t value)
+{
+    if (value < 2 * SUB_BUCKETS)
+    {
+        return static_cast<size_t>(value);
+    }
+    const uint64_t largest{(uint64_t{1} << MAX_BITS) - 1};
+    if (value > largest)
+    {
+        value = largest;
+    }
+    // Keep the SUB_BUCKET_BITS + 1 most significant bits; the shift selects the power of two
+    const int shift{mostSignificantBit(value) - SUB_BUCKET_BITS};
+    return static_cast<size_t>(shift * SUB_BUCKETS) + static_cast<size_t>(value >> shift);
+}
+
+uint64_t LatencyHistogram::highestValueOf(size_t bucket)
+{
+    if (bucket < 2 * SUB_BUCKETS)
+    {
+        return bucket;
+    }
+    const int shift{static_cast<int>(bucket / SUB_BUCKETS) - 1};
+    const uint64_t top{bucket - static_cast<size_t>(shift * SUB_BUCKETS)};
+    return ((top + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds)
+{
+    increment(m_counts[bucketOf(nanoseconds)]);
+    increment(m_count);
+    if (nanoseconds > m_max.load(std::memory_order_relaxed))
+    {
+        m_max.store(nanoseconds, std::memory_order_relaxed);
+    }
+}
+
+uint64_t LatencyHistogram::count() const
+{
+    return m_count.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::max() const
+{
+    return m_max.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::percentile(double fraction) const
+{
+    const uint64_t total{count()};
+    if (total == 0)
+    {
+        return 0;
+    }
+    // Rank of the value we are looking for, counting from 1
+    uint64_t rank{static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(total)))};
+    rank = (rank < 1) ? 1 : rank;
+    uint64_t seen{0};
+    for (size_t i = 0; i < BUCKETS; i++)
+    {
+        seen += m_counts[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            // The last bucket also holds everything that was too long for the histogram
+            const uint64_t value{highestValueOf(i)};
+            return ((value < max()) && (i + 1 < BUCKETS)) ? value : max();
+        }
+    }
+    return max();
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Histogram of durations in nanoseconds with fixed, logarithmically growing buckets in the style of HdrHistogram:
+// values below 64 ns are counted exactly and every power of two above is split into 32 buckets, so a reported
+// value is at most about 3% above the recorded one. Recording is a handful of instructions and never allocates.
+// Only one thread may record into a histogram; other threads may read it at the same time.
+class LatencyHistogram
+{
+   public:
+    static const int SUB_BUCKET_BITS = 5;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    // Durations up to 2^41 ns (about 36 minutes); longer ones are counted in the last bucket
+    static const int MAX_BITS = 41;
+    static const size_t BUCKETS = static_cast<size_t>((MAX_BITS - SUB_BUCKET_BITS) * SUB_BUCKETS + SUB_BUCKETS);
+
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram &) = delete;
+    LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+    void record(uint64_t nanoseconds);
+
+    uint64_t count() const;
+    uint64_t max() const;
+    // Smallest recorded value (rounded up to its bucket) that is not exceeded by the given fraction (0..1) of all values
+    uint64_t percentile(double fraction) const;
+
+   private:
+    static size_t bucketOf(uint64_t value);
+    static uint64_t highestValueOf(size_t bucket);
+
+    std::atomic<uint64_t> m_counts[BUCKETS];
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_max;
+};
+
+#endif
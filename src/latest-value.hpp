@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LATEST_VALUE_HPP
+#define LATEST_VALUE_HPP
+
+#include "cluon-complete.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+// Most recent value of a message, written by one thread (the OD4 receive thread) and sampled by any number of
+// readers without locks. The writer never waits for a reader and a reader never waits for the writer.
+//
+// This is a seqlock over two copies of the value: the writer fills the copy that readers are not pointed at and
+// then advances the sequence, so a reader copying the current value only has to retry when the writer has
+// published twice while it was copying. The value is kept in relaxed atomic words, so torn copies that are
+// thrown away are not data races either.
+template <typename T> class LatestValue
+{
+    static_assert(std::is_trivially_copyable<T>::value, "LatestValue needs a trivially copyable message");
+
+   public:
+    LatestValue()
+        : m_sequence(0)
+        , m_slots()
+    {
+        for (auto &slot : m_slots)
+        {
+            for (auto &word : slot)
+            {
+                word.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    LatestValue(const LatestValue &) = delete;
+    LatestValue &operator=(const LatestValue &) = delete;
+
+    // Writer side; only one thread may publish
+    void publish(const T &value)
+    {
+        uint64_t words[WORDS] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        // The sequence is odd while the copy of the next version is written
+        const uint64_t sequence{m_sequence.load(std::memory_order_relaxed)};
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::atomic<uint64_t> *slot = m_slots[((sequence >> 1) + 1) & 1];
+        for (size_t i = 0; i < WORDS; i++)
+        {
+            slot[i].store(words[i], std::memory_order_relaxed);
+        }
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Reader side; copies the latest value into value and returns false as long as nothing has been published
+    bool read(T &value) const
+    {
+        uint64_t words[WORDS];
+        while (true)
+        {
+            const uint64_t before{m_sequence.load(std::memory_order_acquire)};
+            const uint64_t version{before >> 1};
+            if (0 == version)
+            {
+                return false;
+            }
+            const std::atomic<uint64_t> *slot = m_slots[version & 1];
+            for (size_t i = 0; i < WORDS; i++)
+            {
+                words[i] = slot[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            // The copy we read is only overwritten by version + 2, which first moves the sequence to 2 * version + 3
+            if (m_sequence.load(std::memory_order_relaxed) < 2 * version + 3)
+            {
+                std::memcpy(&value, words, sizeof(T));
+                return true;
+            }
+        }
+    }
+
+    // Number of values published so far; lets a reader tell whether anything new has arrived since it last looked
+    uint64_t version() const
+    {
+        return m_sequence.load(std::memory_order_acquire) >> 1;
+    }
+
+   private:
+    static const size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> m_sequence;
+    std::atomic<uint64_t> m_slots[2][WORDS];
+};
+
+template <typename T> const size_t LatestValue<T>::WORDS;
+
+// Delegate for OD4Session::dataTrigger<T> that publishes every received T into cell
+template <typename T> std::function<void(const T &, const cluon::EnvelopeMeta &)> publishLatest(LatestValue<T> &cell)
+{
+    return [&cell](const T &message, const cluon::EnvelopeMeta &) { cell.publish(message); };
+}
+
+#endif
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "projection-detector.hpp"
+#include "cpu-dispatch.hpp"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+// Columns and rows with fewer hits are noise
+const uint32_t minHits = 3;
+// Columns and rows with enough hits that are at most this far apart belong to the same band or candidate
+const int32_t maxGap = 2;
+
+// Call found(begin, end) for every run of counts of at least minHits, bridging gaps of up to maxGap
+template <typename T, typename Found> void forEachRun(const T *counts, int32_t n, Found found)
+{
+    int32_t i{0};
+    while (i < n)
+    {
+        while ((i < n) && (counts[i] < minHits))
+        {
+            i++;
+        }
+        if (i >= n)
+        {
+            break;
+        }
+        const int32_t begin{i};
+        int32_t end{i};
+        while ((i < n) && (i - end <= maxGap))
+        {
+            if (counts[i] >= minHits)
+            {
+                end = i;
+            }
+            i++;
+        }
+        found(begin, end);
+        i = end + 1;
+    }
+}
+} // namespace
+
+uint32_t maskProjectRowScalar(const uint8_t *mask, int width, uint16_t *columns)
+{
+    uint32_t hits{0};
+    for (int x = 0; x < width; x++)
+    {
+        const uint16_t hit{static_cast<uint16_t>(mask[x] != 0)};
+        hits += hit;
+        if (columns != nullptr)
+        {
+            columns[x] = static_cast<uint16_t>(columns[x] + hit);
+        }
+    }
+    return hits;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("sse4.1"))) uint32_t maskProjectRowSse41(const uint8_t *mask, int width, uint16_t *columns)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    __m128i sums = zero;
+    int x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+        // One per pixel that is not zero; the sum of absolute differences adds them up in two 64-bit lanes
+        const __m128i hit = _mm_andnot_si128(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(mask + x)), zero), one);
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(hit, zero));
+        if (columns != nullptr)
+        {
+            __m128i *low = reinterpret_cast<__m128i *>(columns + x);
+            __m128i *high = reinterpret_cast<__m128i *>(columns + x + 8);
+            _mm_storeu_si128(low, _mm_add_epi16(_mm_loadu_si128(low), _mm_cvtepu8_epi16(hit)));
+            _mm_storeu_si128(high, _mm_add_epi16(_mm_loadu_si128(high), _mm_cvtepu8_epi16(_mm_srli_si128(hit, 8))));
+        }
+    }
+    const uint32_t hits{static_cast<uint32_t>(_mm_cvtsi128_si32(sums)) + static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(sums, 8)))};
+    return hits + maskProjectRowScalar(mask + x, width - x, (columns != nullptr) ? columns + x : nullptr);
+}
+
+__attribute__((target("avx2"))) uint32_t maskProjectRowAvx2(const uint8_t *mask, int width, uint16_t *columns)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi8(1);
+    __m256i sums = zero;
+    int x = 0;
+    for (; x + 32 <= width; x += 32)
+    {
+        // One per pixel that is not zero; the sum of absolute differences adds them up in four 64-bit lanes
+        const __m256i hit = _mm256_andnot_si256(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(mask + x)), zero), one);
+        sums = _mm256_add_epi64(sums, _mm256_sad_epu8(hit, zero));
+        if (columns != nullptr)
+        {
+            __m256i *low = reinterpret_cast<__m256i *>(columns + x);
+            __m256i *high = reinterpret_cast<__m256i *>(columns + x + 16);
+            _mm256_storeu_si256(low, _mm256_add_epi16(_mm256_loadu_si256(low), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(hit))));
+            _mm256_storeu_si256(high, _mm256_add_epi16(_mm256_loadu_si256(high), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(hit, 1))));
+        }
+    }
+    const __m128i halves = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+    const uint32_t hits{static_cast<uint32_t>(_mm_cvtsi128_si32(halves)) + static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(halves, 8)))};
+    return hits + maskProjectRowScalar(mask + x, width - x, (columns != nullptr) ? columns + x : nullptr);
+}
+#endif
+
+ProjectionDetector::ProjectionDetector()
+    : m_columns()
+    , m_rows()
+    , m_candidateColumns()
+    , m_blobs()
+{
+}
+
+const std::vector<Blob> &ProjectionDetector::detect(const cv::Mat &mask, const cv::Point &offset)
+{
+    CV_Assert(mask.type() == CV_8UC1);
+    CV_Assert(mask.rows <= UINT16_MAX);
+
+    const MaskProjectRow kernel{visionKernels().maskProjectRow};
+    m_blobs.clear();
+    // Shrinking keeps the capacity, so windows up to the largest size so far do not allocate
+    m_columns.assign(static_cast<size_t>(mask.cols), 0);
+    m_rows.resize(static_cast<size_t>(mask.rows));
+    m_candidateColumns.resize(static_cast<size_t>(mask.cols));
+    for (int y = 0; y < mask.rows; y++)
+    {
+        kernel(mask.ptr<uint8_t>(y), mask.cols, m_columns.data());
+    }
+    forEachRun(m_columns.data(), mask.cols, [&](int32_t begin, int32_t end) { addBand(mask, begin, end, offset, kernel); });
+
+    // BlobExtractor returns the blob found last in raster order first, which getCones() relies on to pick the top one
+    std::sort(m_blobs.begin(), m_blobs.end(), foundLater);
+    return m_blobs;
+}
+
+void ProjectionDetector::addBand(const cv::Mat &mask, int32_t begin, int32_t end, const cv::Point &offset, MaskProjectRow kernel)
+{
+    for (int y = 0; y < mask.rows; y++)
+    {
+        m_rows[static_cast<size_t>(y)] = kernel(mask.ptr<uint8_t>(y) + begin, end - begin + 1, nullptr);
+    }
+    forEachRun(m_rows.data(), mask.rows, [&](int32_t top, int32_t bottom) { addCandidate(mask, begin, end, top, bottom, offset, kernel); });
+}
+
+void ProjectionDetector::addCandidate(const cv::Mat &mask, int32_t begin, int32_t end, int32_t top, int32_t bottom, const cv::Point &offset, MaskProjectRow kernel)
+{
+    const int32_t width{end - begin + 1};
+    uint16_t *columns = m_candidateColumns.data();
+    std::fill(columns, columns + width, 0);
+    uint64_t area{0}, sumY{0};
+    for (int32_t y = top; y <= bottom; y++)
+    {
+        const uint32_t hits{kernel(mask.ptr<uint8_t>(y) + begin, width, columns)};
+        area += hits;
+        sumY += static_cast<uint64_t>(y) * hits;
+    }
+
+    // The rows of the candidate may only cover part of the band
+    int32_t left{0};
+    while (columns[left] == 0)
+    {
+        left++;
+    }
+    int32_t right{width - 1};
+    while (columns[right] == 0)
+    {
+        right--;
+    }
+    uint64_t sumX{0};
+    for (int32_t x = left; x <= right; x++)
+    {
+        sumX += static_cast<uint64_t>(begin + x) * columns[x];
+    }
+
+    // The top row of the candidate has hits, and a scan of the whole mask would reach its leftmost one first
+    const uint8_t *topRow = mask.ptr<uint8_t>(top);
+    int32_t first{begin + left};
+    while ((first < begin + right) && (topRow[first] == 0))
+    {
+        first++;
+    }
+
+    const cv::Rect boundingBox(begin + left + offset.x, top + offset.y, right - left + 1, bottom - top + 1);
+    const cv::Point2f centroid(static_cast<float>(static_cast<double>(sumX) / static_cast<double>(area) + offset.x), static_cast<float>(static_cast<double>(sumY) / static_cast<double>(area) + offset.y));
+    m_blobs.push_back(Blob{boundingBox, static_cast<uint32_t>(area), centroid, cv::Point(first + offset.x, top + offset.y)});
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROJECTION_DETECTOR_HPP
+#define PROJECTION_DETECTOR_HPP
+
+#include "blob-extractor.hpp"
+
+#include <opencv2/core/core.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// Kernel that counts the non-zero pixels of a row of a CV_8UC1 mask and, unless columns is nullptr, adds one to the
+// column counter of every one of them
+typedef uint32_t (*MaskProjectRow)(const uint8_t *mask, int width, uint16_t *columns);
+
+// Portable reference kernel
+uint32_t maskProjectRowScalar(const uint8_t *mask, int width, uint16_t *columns);
+#if defined(__x86_64__) || defined(__i386__)
+// Kernels processing 16 (SSE4.1) or 32 (AVX2) pixels per step; only call them when the CPU supports the instruction
+// set. ProjectionDetector picks one through visionKernels() in cpu-dispatch.hpp.
+uint32_t maskProjectRowSse41(const uint8_t *mask, int width, uint16_t *columns);
+uint32_t maskProjectRowAvx2(const uint8_t *mask, int width, uint16_t *columns);
+#endif
+
+// Alternative to BlobExtractor that finds the cones of a mask from projections instead of connected components.
+// The hits per column of the whole mask split it into bands of columns with hits, the hits per row of a band split
+// it into candidates, and the hits per column of a candidate tighten its box. Every pass reads at most every pixel
+// once, so the cost only depends on the size of the mask. Separate blobs whose columns and rows are less than a few
+// pixels apart come out as one candidate. The candidates come out in the order of BlobExtractor: bottom first.
+// The buffers are kept between calls, so masks of the same size do not allocate.
+class ProjectionDetector
+{
+   public:
+    ProjectionDetector();
+
+    // Find the candidates of a CV_8UC1 mask; offset is added to their positions
+    const std::vector<Blob> &detect(const cv::Mat &mask, const cv::Point &offset = cv::Point());
+
+    const std::vector<Blob> &blobs() const
+    {
+        return m_blobs;
+    }
+
+   private:
+    // Split the columns begin..end of the mask into candidates by the hits per row
+    void addBand(const cv::Mat &mask, int32_t begin, int32_t end, const cv::Point &offset, MaskProjectRow kernel);
+    // Add the pixels of the columns begin..end and rows top..bottom as a candidate
+    void addCandidate(const cv::Mat &mask, int32_t begin, int32_t end, int32_t top, int32_t bottom, const cv::Point &offset, MaskProjectRow kernel);
+
+    // Hits per column of the whole mask, per row of the current band and per column of the current candidate
+    std::vector<uint16_t> m_columns;
+    std::vector<uint32_t> m_rows;
+    std::vector<uint16_t> m_candidateColumns;
+    std::vector<Blob> m_blobs;
+};
+
+#endif
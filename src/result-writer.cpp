@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "result-writer.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+// Longest line a record can format to, apart from the name of its stream
+const size_t maxLine = 96;
+const size_t binaryRecord = sizeof(int64_t) + sizeof(double) + sizeof(uint32_t);
+} // namespace
+
+ResultWriter::ResultWriter(ResultFormat format, const std::string &path, const std::vector<std::string> &names, size_t capacity, size_t flushBytes, std::chrono::milliseconds flushInterval, const Send &send)
+    : m_format(format)
+    , m_names(names)
+    , m_flushBytes(flushBytes)
+    , m_flushInterval(flushInterval)
+    , m_send(send)
+    , m_fd(STDOUT_FILENO)
+    , m_ownsFd(false)
+    , m_rings()
+    , m_nextRing(0)
+    , m_buffer()
+    , m_buffered(0)
+    , m_running(true)
+    , m_parked(false)
+    , m_wakeMutex()
+    , m_wake()
+    , m_written(0)
+    , m_dropped(0)
+    , m_flushes(0)
+    , m_thread()
+{
+    if (!path.empty())
+    {
+        m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        m_ownsFd = (m_fd >= 0);
+    }
+    for (size_t i = 0; i < std::max<size_t>(1, m_names.size()); i++)
+    {
+        m_rings.emplace_back(new SpscRing<ResultRecord>(capacity));
+    }
+    // Room for a full flush plus the record that crosses the threshold
+    size_t longestName{0};
+    for (const std::string &name : m_names)
+    {
+        longestName = std::max(longestName, name.size());
+    }
+    m_buffer.resize(m_flushBytes + maxLine + longestName);
+    if (valid())
+    {
+        if (m_format == RESULT_CSV)
+        {
+            const char header[] = "timestamp,steeringWheelAngle,stream\n";
+            std::memcpy(m_buffer.data(), header, sizeof(header) - 1);
+            m_buffered = sizeof(header) - 1;
+        }
+        m_thread = std::thread(&ResultWriter::run, this);
+    }
+}
+
+ResultWriter::~ResultWriter()
+{
+    close();
+    if (m_ownsFd)
+    {
+        ::close(m_fd);
+    }
+}
+
+bool ResultWriter::valid() const
+{
+    return m_fd >= 0;
+}
+
+bool ResultWriter::push(const ResultRecord &record)
+{
+    SpscRing<ResultRecord> &ring = *m_rings[(record.stream < m_rings.size()) ? record.stream : 0];
+    if (!ring.push(record))
+    {
+        // Streams may be pushed from different threads
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // Pairs with the fence in sleep(): either the writer sees the record before it sleeps or we see that it sleeps
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_parked.load(std::memory_order_relaxed))
+    {
+        // Taking the lock makes sure that the writer is inside wait() and does not miss the notification
+        {
+            std::lock_guard<std::mutex> lck(m_wakeMutex);
+        }
+        m_wake.notify_one();
+    }
+    return true;
+}
+
+void ResultWriter::close()
+{
+    {
+        std::lock_guard<std::mutex> lck(m_wakeMutex);
+        m_running.store(false, std::memory_order_release);
+    }
+    m_wake.notify_one();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+uint64_t ResultWriter::written() const
+{
+    return m_written.load(std::memory_order_relaxed);
+}
+
+uint64_t ResultWriter::dropped() const
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t ResultWriter::flushes() const
+{
+    return m_flushes.load(std::memory_order_relaxed);
+}
+
+void ResultWriter::run()
+{
+    // Time by which the oldest buffered record has to be written
+    std::chrono::steady_clock::time_point deadline;
+    ResultRecord record;
+    while (true)
+    {
+        if (pop(record))
+        {
+            if (m_send)
+            {
+                m_send(record);
+            }
+            if (RESULT_SEND != m_format)
+            {
+                if (0 == m_buffered)
+                {
+                    deadline = std::chrono::steady_clock::now() + m_flushInterval;
+                }
+                format(record);
+                if (m_buffered >= m_flushBytes)
+                {
+                    flush();
+                }
+            }
+            m_written.store(m_written.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            continue;
+        }
+        if (!m_running.load(std::memory_order_acquire) && empty())
+        {
+            break;
+        }
+        if ((m_buffered > 0) && (std::chrono::steady_clock::now() >= deadline))
+        {
+            flush();
+        }
+        sleep(m_buffered > 0, deadline);
+    }
+    flush();
+}
+
+void ResultWriter::sleep(bool flushDue, std::chrono::steady_clock::time_point deadline)
+{
+    std::unique_lock<std::mutex> lck(m_wakeMutex);
+    m_parked.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto woken = [this]() { return !empty() || !m_running.load(std::memory_order_acquire); };
+    if (flushDue)
+    {
+        // Wake up in time to write the oldest buffered record
+        m_wake.wait_until(lck, deadline, woken);
+    }
+    else
+    {
+        m_wake.wait(lck, woken);
+    }
+    m_parked.store(false, std::memory_order_relaxed);
+}
+
+bool ResultWriter::pop(ResultRecord &record)
+{
+    for (size_t i = 0; i < m_rings.size(); i++)
+    {
+        const size_t index{m_nextRing};
+        m_nextRing = (m_nextRing + 1 == m_rings.size()) ? 0 : m_nextRing + 1;
+        if (m_rings[index]->pop(record))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ResultWriter::empty() const
+{
+    for (const std::unique_ptr<SpscRing<ResultRecord>> &ring : m_rings)
+    {
+        if (!ring->empty())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ResultWriter::format(const ResultRecord &record)
+{
+    char *out = m_buffer.data() + m_buffered;
+    const bool named{(m_names.size() > 1) && (record.stream < m_names.size())};
+    int length{0};
+    switch (m_format)
+    {
+    case RESULT_TEXT:
+        // %g prints the angle like std::cout did
+        length = std::snprintf(out, maxLine, "group_04; %" PRId64 "; %g", record.timestamp, record.steeringWheelAngle);
+        if (named)
+        {
+            std::memcpy(out + length, "; ", 2);
+            std::memcpy(out + length + 2, m_names[record.stream].data(), m_names[record.stream].size());
+            length += 2 + static_cast<int>(m_names[record.stream].size());
+        }
+        out[length++] = '\n';
+        break;
+    case RESULT_CSV:
+        length = std::snprintf(out, maxLine, "%" PRId64 ",%.9g,%" PRIu32 "\n", record.timestamp, record.steeringWheelAngle, record.stream);
+        break;
+    case RESULT_BINARY:
+        std::memcpy(out, &record.timestamp, sizeof(int64_t));
+        std::memcpy(out + sizeof(int64_t), &record.steeringWheelAngle, sizeof(double));
+        std::memcpy(out + sizeof(int64_t) + sizeof(double), &record.stream, sizeof(uint32_t));
+        length = static_cast<int>(binaryRecord);
+        break;
+    case RESULT_SEND:
+        break;
+    }
+    m_buffered += static_cast<size_t>(length);
+}
+
+void ResultWriter::flush()
+{
+    size_t offset{0};
+    while (offset < m_buffered)
+    {
+        const ssize_t n{::write(m_fd, m_buffer.data() + offset, m_buffered - offset)};
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            // Nobody reads our output anymore; there is nothing better to do than to forget it
+            break;
+        }
+        offset += static_cast<size_t>(n);
+    }
+    if (m_buffered > 0)
+    {
+        m_flushes.store(m_flushes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    m_buffered = 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESULT_WRITER_HPP
+#define RESULT_WRITER_HPP
+
+#include "spsc-ring.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Result of one frame as it leaves the frame loop
+struct ResultRecord
+{
+    // Sample timestamp of the frame in microseconds
+    int64_t timestamp;
+    double steeringWheelAngle;
+    // Index of the shared memory area in the names given to the writer
+    uint32_t stream;
+};
+
+enum ResultFormat
+{
+    // "group_04; <timestamp>; <steering wheel angle>" as the microservice always printed it
+    RESULT_TEXT,
+    // Header line, then "<timestamp>,<steering wheel angle>,<stream>"
+    RESULT_CSV,
+    // Records of 20 bytes in host byte order: int64 timestamp, double steering wheel angle, uint32 stream
+    RESULT_BINARY,
+    // Nothing is written; the records only go to the send function, e.g. to publish them in the OD4 session
+    RESULT_SEND,
+};
+
+// Writes the results of the frame loop on a background thread, so that formatting and writing, and a reader of
+// our output that stalls, never hold up a frame. The frame loop only copies a record into the preallocated ring
+// of its stream;
+// the writer formats the records into a buffer and writes it out when flushBytes are buffered or the oldest
+// buffered record is flushInterval old. The writer sleeps while the ring is empty, and the frame loop only
+// takes the lock to wake it when it actually sleeps.
+class ResultWriter
+{
+   public:
+    typedef std::function<void(const ResultRecord &)> Send;
+
+    // Write to path, or to stdout when path is empty; names are the names of the streams, and the text
+    // format appends them to every line when there is more than one. Every stream gets a ring of capacity records.
+    // Unless it is empty, send gets every record on the writer thread as soon as it is dequeued, whatever the format
+    ResultWriter(ResultFormat format, const std::string &path, const std::vector<std::string> &names, size_t capacity, size_t flushBytes, std::chrono::milliseconds flushInterval, const Send &send);
+    ~ResultWriter();
+
+    ResultWriter(const ResultWriter &) = delete;
+    ResultWriter &operator=(const ResultWriter &) = delete;
+
+    // False when the output file could not be opened
+    bool valid() const;
+
+    // Queue a record in the ring of record.stream; only one thread at a time may push the records of a stream.
+    // A full ring drops and counts the record instead of waiting and returns false
+    bool push(const ResultRecord &record);
+
+    // Write everything that is queued and stop the writer thread
+    void close();
+
+    uint64_t written() const;
+    uint64_t dropped() const;
+    uint64_t flushes() const;
+
+   private:
+    void run();
+    bool pop(ResultRecord &record);
+    bool empty() const;
+    void sleep(bool flushDue, std::chrono::steady_clock::time_point deadline);
+    void format(const ResultRecord &record);
+    void flush();
+
+    const ResultFormat m_format;
+    const std::vector<std::string> m_names;
+    const size_t m_flushBytes;
+    const std::chrono::milliseconds m_flushInterval;
+    const Send m_send;
+    int m_fd;
+    bool m_ownsFd;
+    std::vector<std::unique_ptr<SpscRing<ResultRecord>>> m_rings;
+    // Ring that the writer looks at first, so that a busy stream cannot starve the others
+    size_t m_nextRing;
+    // Formatted records that have not been written yet
+    std::vector<char> m_buffer;
+    size_t m_buffered;
+    std::atomic<bool> m_running;
+    // Set while the writer sleeps on m_wake, so that push() only locks m_wakeMutex when there is someone to wake
+    std::atomic<bool> m_parked;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::atomic<uint64_t> m_written;
+    std::atomic<uint64_t> m_dropped;
+    std::atomic<uint64_t> m_flushes;
+    std::thread m_thread;
+};
+
+#endif
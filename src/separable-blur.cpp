@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "separable-blur.hpp"
+#include "cpu-dispatch.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+const int channels = 4;
+} // namespace
+
+// cv::getGaussianKernel(7, 1.0) scaled by 256 and rounded, which sums up to exactly 256
+const uint16_t SeparableBlur::KERNEL[SeparableBlur::KERNEL_SIZE] = {1, 14, 62, 102, 62, 14, 1};
+
+void blurRowHorizontalScalar(const uint8_t *padded, int n, uint16_t *out)
+{
+    const uint16_t *k = SeparableBlur::KERNEL;
+    for (int i = 0; i < n; i++)
+    {
+        out[i] = static_cast<uint16_t>(k[0] * (padded[i] + padded[i + 6 * channels]) + k[1] * (padded[i + channels] + padded[i + 5 * channels]) +
+                                       k[2] * (padded[i + 2 * channels] + padded[i + 4 * channels]) + k[3] * padded[i + 3 * channels]);
+    }
+}
+
+void blurRowVerticalScalar(const uint16_t *const *rows, int n, uint8_t *out)
+{
+    const uint16_t *k = SeparableBlur::KERNEL;
+    for (int i = 0; i < n; i++)
+    {
+        const uint32_t sum{k[0] * static_cast<uint32_t>(rows[0][i] + rows[6][i]) + k[1] * static_cast<uint32_t>(rows[1][i] + rows[5][i]) +
+                           k[2] * static_cast<uint32_t>(rows[2][i] + rows[4][i]) + k[3] * static_cast<uint32_t>(rows[3][i])};
+        out[i] = static_cast<uint8_t>((sum + (1u << 15)) >> 16);
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("sse4.1"))) void blurRowHorizontalSse41(const uint8_t *padded, int n, uint16_t *out)
+{
+    const uint16_t *k = SeparableBlur::KERNEL;
+    const __m128i k1 = _mm_set1_epi16(static_cast<int16_t>(k[1]));
+    const __m128i k2 = _mm_set1_epi16(static_cast<int16_t>(k[2]));
+    const __m128i k3 = _mm_set1_epi16(static_cast<int16_t>(k[3]));
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        // Widen eight values of every tap to 16 bits; the weighted sum of 8-bit values never exceeds 255 * 256
+        __m128i p[SeparableBlur::KERNEL_SIZE];
+        for (int t = 0; t < SeparableBlur::KERNEL_SIZE; t++)
+        {
+            p[t] = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(padded + i + t * channels)));
+        }
+        // The outermost taps have a weight of 1
+        __m128i sum = _mm_add_epi16(p[0], p[6]);
+        sum = _mm_add_epi16(sum, _mm_mullo_epi16(k1, _mm_add_epi16(p[1], p[5])));
+        sum = _mm_add_epi16(sum, _mm_mullo_epi16(k2, _mm_add_epi16(p[2], p[4])));
+        sum = _mm_add_epi16(sum, _mm_mullo_epi16(k3, p[3]));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), sum);
+    }
+    blurRowHorizontalScalar(padded + i, n - i, out + i);
+}
+
+__attribute__((target("sse4.1"))) void blurRowVerticalSse41(const uint16_t *const *rows, int n, uint8_t *out)
+{
+    const uint16_t *k = SeparableBlur::KERNEL;
+    const __m128i k1 = _mm_set1_epi32(k[1]);
+    const __m128i k2 = _mm_set1_epi32(k[2]);
+    const __m128i k3 = _mm_set1_epi32(k[3]);
+    const __m128i round = _mm_set1_epi32(1 << 15);
+    const __m128i zero = _mm_setzero_si128();
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        // The sums of two taps exceed 16 bits, so the low and high four values are summed up in 32-bit lanes
+        __m128i low[SeparableBlur::KERNEL_SIZE], high[SeparableBlur::KERNEL_SIZE];
+        for (int t = 0; t < SeparableBlur::KERNEL_SIZE; t++)
+        {
+            const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows[t] + i));
+            low[t] = _mm_unpacklo_epi16(values, zero);
+            high[t] = _mm_unpackhi_epi16(values, zero);
+        }
+        __m128i sumLow = _mm_add_epi32(_mm_add_epi32(low[0], low[6]), round);
+        sumLow = _mm_add_epi32(sumLow, _mm_mullo_epi32(k1, _mm_add_epi32(low[1], low[5])));
+        sumLow = _mm_add_epi32(sumLow, _mm_mullo_epi32(k2, _mm_add_epi32(low[2], low[4])));
+        sumLow = _mm_add_epi32(sumLow, _mm_mullo_epi32(k3, low[3]));
+        __m128i sumHigh = _mm_add_epi32(_mm_add_epi32(high[0], high[6]), round);
+        sumHigh = _mm_add_epi32(sumHigh, _mm_mullo_epi32(k1, _mm_add_epi32(high[1], high[5])));
+        sumHigh = _mm_add_epi32(sumHigh, _mm_mullo_epi32(k2, _mm_add_epi32(high[2], high[4])));
+        sumHigh = _mm_add_epi32(sumHigh, _mm_mullo_epi32(k3, high[3]));
+
+        // After the shift every lane holds a value of at most 255
+        const __m128i words = _mm_packs_epi32(_mm_srli_epi32(sumLow, 16), _mm_srli_epi32(sumHigh, 16));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + i), _mm_packus_epi16(words, zero));
+    }
+    const uint16_t *rest[SeparableBlur::KERNEL_SIZE];
+    for (int t = 0; t < SeparableBlur::KERNEL_SIZE; t++)
+    {
+        rest[t] = rows[t] + i;
+    }
+    blurRowVerticalScalar(rest, n - i, out + i);
+}
+
+__attribute__((target("avx2"))) void blurRowHorizontalAvx2(const uint8_t *padded, int n, uint16_t *out)
+{
+    const uint16_t *k = SeparableBlur::KERNEL;
+    const __m256i k1 = _mm256_set1_epi16(static_cast<int16_t>(k[1]));
+    const __m256i k2 = _mm256_set1_epi16(static_cast<int16_t>(k[2]));
+    const __m256i k3 = _mm256_set1_epi16(static_cast<int16_t>(k[3]));
+
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        // Widen sixteen values of every tap to 16 bits; the weighted sum of 8-bit values never exceeds 255 * 256
+        __m256i p[SeparableBlur::KERNEL_SIZE];
+        for (int t = 0; t < SeparableBlur::KERNEL_SIZE; t++)
+        {
+            p[t] = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(padded + i + t * channels)));
+        }
+        // The outermost taps have a weight of 1
+        __m256i sum = _mm256_add_epi16(p[0], p[6]);
+        sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(k1, _mm256_add_epi16(p[1], p[5])));
+        sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(k2, _mm256_add_epi16(p[2], p[4])));
+        sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(k3, p[3]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), sum);
+    }
+    blurRowHorizontalScalar(padded + i, n - i, out + i);
+}
+
+__attribute__((target("avx2"))) void blurRowVerticalAvx2(const uint16_t *const *rows, int n, uint8_t *out)
+{
+    const uint16_t *k = SeparableBlur::KERNEL;
+    const __m256i k1 = _mm256_set1_epi32(k[1]);
+    const __m256i k2 = _mm256_set1_epi32(k[2]);
+    const __m256i k3 = _mm256_set1_epi32(k[3]);
+    const __m256i round = _mm256_set1_epi32(1 << 15);
+
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        // The sums of two taps exceed 16 bits, so the low and high eight values are summed up in 32-bit lanes
+        __m256i low[SeparableBlur::KERNEL_SIZE], high[SeparableBlur::KERNEL_SIZE];
+        for (int t = 0; t < SeparableBlur::KERNEL_SIZE; t++)
+        {
+            low[t] = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(rows[t] + i)));
+            high[t] = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(rows[t] + i + 8)));
+        }
+        __m256i sumLow = _mm256_add_epi32(_mm256_add_epi32(low[0], low[6]), round);
+        sumLow = _mm256_add_epi32(sumLow, _mm256_mullo_epi32(k1, _mm256_add_epi32(low[1], low[5])));
+        sumLow = _mm256_add_epi32(sumLow, _mm256_mullo_epi32(k2, _mm256_add_epi32(low[2], low[4])));
+        sumLow = _mm256_add_epi32(sumLow, _mm256_mullo_epi32(k3, low[3]));
+        __m256i sumHigh = _mm256_add_epi32(_mm256_add_epi32(high[0], high[6]), round);
+        sumHigh = _mm256_add_epi32(sumHigh, _mm256_mullo_epi32(k1, _mm256_add_epi32(high[1], high[5])));
+        sumHigh = _mm256_add_epi32(sumHigh, _mm256_mullo_epi32(k2, _mm256_add_epi32(high[2], high[4])));
+        sumHigh = _mm256_add_epi32(sumHigh, _mm256_mullo_epi32(k3, high[3]));
+
+        // Packing works within 128-bit lanes: words holds low[0..3], high[0..3], low[4..7], high[4..7]
+        const __m256i words = _mm256_packus_epi32(_mm256_srli_epi32(sumLow, 16), _mm256_srli_epi32(sumHigh, 16));
+        const __m256i ordered = _mm256_permute4x64_epi64(words, _MM_SHUFFLE(3, 1, 2, 0));
+        const __m128i bytes = _mm_packus_epi16(_mm256_castsi256_si128(ordered), _mm256_extracti128_si256(ordered, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), bytes);
+    }
+    const uint16_t *rest[SeparableBlur::KERNEL_SIZE];
+    for (int t = 0; t < SeparableBlur::KERNEL_SIZE; t++)
+    {
+        rest[t] = rows[t] + i;
+    }
+    blurRowVerticalScalar(rest, n - i, out + i);
+}
+#endif
+
+SeparableBlur::SeparableBlur()
+    : m_width(0)
+    , m_top(0)
+    , m_bottom(0)
+    , m_left(0)
+    , m_right(0)
+    , m_padded()
+    , m_ring()
+{
+}
+
+uint16_t *SeparableBlur::slot(int y)
+{
+    const int index{((y % KERNEL_SIZE) + KERNEL_SIZE) % KERNEL_SIZE};
+    return m_ring.data() + static_cast<size_t>(index) * static_cast<size_t>(m_width * channels);
+}
+
+void SeparableBlur::horizontal(const cv::Mat &src, int y, BlurRowHorizontal kernel)
+{
+    // Below the parent image the mirrored row has already been blurred and is still in the ring; copying it
+    // instead of reading the source keeps in-place blurring correct
+    if (y > m_bottom)
+    {
+        std::memcpy(slot(y), slot(2 * m_bottom - y), static_cast<size_t>(m_width * channels) * sizeof(uint16_t));
+        return;
+    }
+
+    // Rows and columns outside of the view are read from the parent image as long as it has them
+    const uint8_t *row = src.data + static_cast<ptrdiff_t>(reflect101(y, m_top, m_bottom)) * static_cast<ptrdiff_t>(src.step[0]);
+    uint8_t *padded = m_padded.data();
+    for (int x = -RADIUS; x < m_width + RADIUS; x++)
+    {
+        std::memcpy(padded + (x + RADIUS) * channels, row + reflect101(x, m_left, m_right) * channels, channels);
+    }
+
+    kernel(padded, m_width * channels, slot(y));
+}
+
+void SeparableBlur::apply(const cv::Mat &src, cv::Mat &dst)
+{
+    CV_Assert(src.type() == CV_8UC4);
+    CV_Assert(src.rows > RADIUS && src.cols > RADIUS);
+    dst.create(src.rows, src.cols, src.type());
+
+    // Find out how far the parent image of the view extends in each direction
+    cv::Size whole;
+    cv::Point offset;
+    src.locateROI(whole, offset);
+    m_top = -offset.y;
+    m_bottom = whole.height - offset.y - 1;
+    m_left = -offset.x;
+    m_right = whole.width - offset.x - 1;
+
+    m_width = src.cols;
+    const size_t rowSize{static_cast<size_t>(m_width * channels)};
+    if (m_ring.size() < KERNEL_SIZE * rowSize)
+    {
+        m_ring.resize(KERNEL_SIZE * rowSize);
+        m_padded.resize(rowSize + 2 * RADIUS * channels);
+    }
+
+    const VisionKernels &kernels = visionKernels();
+    for (int y = -RADIUS; y < RADIUS; y++)
+    {
+        horizontal(src, y, kernels.blurRowHorizontal);
+    }
+    const uint16_t *rows[KERNEL_SIZE];
+    for (int y = 0; y < src.rows; y++)
+    {
+        // Output row y only needs source rows up to y + RADIUS, which have not been overwritten yet
+        horizontal(src, y + RADIUS, kernels.blurRowHorizontal);
+        for (int t = 0; t < KERNEL_SIZE; t++)
+        {
+            rows[t] = slot(y - RADIUS + t);
+        }
+        kernels.blurRowVertical(rows, static_cast<int>(rowSize), dst.ptr<uint8_t>(y));
+    }
+}
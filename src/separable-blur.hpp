@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SEPARABLE_BLUR_HPP
+#define SEPARABLE_BLUR_HPP
+
+#include <opencv2/core/core.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// Mirror a coordinate at the edges of [low, high] without repeating the edge (BORDER_REFLECT_101)
+inline int reflect101(int i, int low, int high)
+{
+    if (i < low)
+    {
+        return 2 * low - i;
+    }
+    if (i > high)
+    {
+        return 2 * high - i;
+    }
+    return i;
+}
+
+// Kernel that blurs n interleaved 8-bit values of a row horizontally; padded holds SeparableBlur::RADIUS pixels of
+// border in front of and behind the row
+typedef void (*BlurRowHorizontal)(const uint8_t *padded, int n, uint16_t *out);
+// Kernel that blurs n values vertically from the horizontally blurred rows y - RADIUS .. y + RADIUS
+typedef void (*BlurRowVertical)(const uint16_t *const *rows, int n, uint8_t *out);
+
+// Portable reference kernels
+void blurRowHorizontalScalar(const uint8_t *padded, int n, uint16_t *out);
+void blurRowVerticalScalar(const uint16_t *const *rows, int n, uint8_t *out);
+#if defined(__x86_64__) || defined(__i386__)
+// Bit-identical kernels processing 8 (SSE4.1) or 16 (AVX2) values per step; only call them when the CPU supports
+// the instruction set. SeparableBlur picks one through visionKernels() in cpu-dispatch.hpp.
+void blurRowHorizontalSse41(const uint8_t *padded, int n, uint16_t *out);
+void blurRowVerticalSse41(const uint16_t *const *rows, int n, uint8_t *out);
+void blurRowHorizontalAvx2(const uint8_t *padded, int n, uint16_t *out);
+void blurRowVerticalAvx2(const uint16_t *const *rows, int n, uint8_t *out);
+#endif
+
+// Replacement for cv::GaussianBlur(src, dst, cv::Size(7, 7), 1.0) on BGRA images that keeps its buffers between calls.
+// It uses the same 8-bit fixed-point kernel {1, 14, 62, 102, 62, 14, 1} / 256 per direction as OpenCV's separable
+// 8-bit filter and, like cv::GaussianBlur, reads the rows and columns of the parent image around a view before
+// falling back to BORDER_REFLECT_101. src and dst may be the same image.
+class SeparableBlur
+{
+   public:
+    static const int KERNEL_SIZE = 7;
+    static const int RADIUS = KERNEL_SIZE / 2;
+    static const uint16_t KERNEL[KERNEL_SIZE];
+
+    SeparableBlur();
+
+    void apply(const cv::Mat &src, cv::Mat &dst);
+
+   private:
+    // Blur source row y (relative to src, may lie outside of it) horizontally into its slot of the ring
+    void horizontal(const cv::Mat &src, int y, BlurRowHorizontal kernel);
+    uint16_t *slot(int y);
+
+    int m_width;
+    int m_top;
+    int m_bottom;
+    int m_left;
+    int m_right;
+    // Source row with RADIUS pixels of border on both sides
+    std::vector<uint8_t> m_padded;
+    // Horizontally blurred rows y - RADIUS .. y + RADIUS of the current output row y
+    std::vector<uint16_t> m_ring;
+};
+
+#endif
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Bounded lock-free ring for exactly one producer thread and one consumer thread.
+// The capacity is rounded up to a power of two and the storage is allocated once in the constructor.
+template <typename T> class SpscRing
+{
+   public:
+    explicit SpscRing(size_t capacity)
+        : m_mask(roundUp(capacity) - 1)
+        , m_buffer(m_mask + 1)
+        , m_head(0)
+        , m_headPadding()
+        , m_tail(0)
+        , m_tailPadding()
+    {
+    }
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    // Producer side; returns false when the ring is full
+    bool push(const T &value)
+    {
+        const size_t tail{m_tail.load(std::memory_order_relaxed)};
+        if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+        {
+            return false;
+        }
+        m_buffer[tail & m_mask] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; returns false when the ring is empty
+    bool pop(T &value)
+    {
+        const size_t head{m_head.load(std::memory_order_relaxed)};
+        if (head == m_tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        value = m_buffer[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+    size_t size() const
+    {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const
+    {
+        return m_mask + 1;
+    }
+
+   private:
+    static size_t roundUp(size_t capacity)
+    {
+        size_t power{1};
+        while (power < capacity)
+        {
+            power <<= 1;
+        }
+        return power;
+    }
+
+    const size_t m_mask;
+    std::vector<T> m_buffer;
+    // Producer and consumer indices live on their own cache lines
+    std::atomic<size_t> m_head;
+    char m_headPadding[64 - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> m_tail;
+    char m_tailPadding[64 - sizeof(std::atomic<size_t>)];
+};
+
+// Waiting strategy for a stage whose ring is empty or full: spin first, then yield and finally sleep
+class Backoff
+{
+   public:
+    void pause()
+    {
+        if (m_rounds < 64)
+        {
+            m_rounds++;
+        }
+        else if (m_rounds < 128)
+        {
+            m_rounds++;
+            std::this_thread::yield();
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    void reset()
+    {
+        m_rounds = 0;
+    }
+
+   private:
+    uint32_t m_rounds{0};
+};
+
+#endif
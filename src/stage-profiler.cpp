@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stage-profiler.hpp"
+
+#include <iomanip>
+
+namespace
+{
+const char *const stageNames[STAGE_COUNT] = {"wait", "lock+copy", "blur", "color", "getCones blue", "getCones yellow", "getDistance", "send", "output", "sample-to-output"};
+
+inline double toMicroseconds(uint64_t nanoseconds)
+{
+    return static_cast<double>(nanoseconds) / 1000.0;
+}
+} // namespace
+
+StageProfiler::StageProfiler(std::chrono::steady_clock::duration dumpInterval)
+    : m_histograms()
+    , m_dumpInterval(dumpInterval)
+    , m_nextDump(std::chrono::steady_clock::now() + dumpInterval)
+{
+}
+
+void StageProfiler::record(Stage stage, uint64_t nanoseconds)
+{
+    m_histograms[stage].record(nanoseconds);
+}
+
+const LatencyHistogram &StageProfiler::histogram(Stage stage) const
+{
+    return m_histograms[stage];
+}
+
+void StageProfiler::dump(std::ostream &out) const
+{
+    const std::ios::fmtflags flags{out.flags()};
+    const std::streamsize precision{out.precision()};
+    out << std::fixed << std::setprecision(1);
+    out << std::left << std::setw(18) << "stage [us]" << std::right << std::setw(10) << "count" << std::setw(12) << "p50" << std::setw(12) << "p99" << std::setw(12) << "p99.9"
+        << std::setw(12) << "max" << std::endl;
+    for (int i = 0; i < STAGE_COUNT; i++)
+    {
+        const LatencyHistogram &h = m_histograms[i];
+        if (h.count() == 0)
+        {
+            continue;
+        }
+        out << std::left << std::setw(18) << stageNames[i] << std::right << std::setw(10) << h.count() << std::setw(12) << toMicroseconds(h.percentile(0.5)) << std::setw(12)
+            << toMicroseconds(h.percentile(0.99)) << std::setw(12) << toMicroseconds(h.percentile(0.999)) << std::setw(12) << toMicroseconds(h.max()) << std::endl;
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void StageProfiler::dumpIfDue(std::ostream &out)
+{
+    const std::chrono::steady_clock::time_point now{std::chrono::steady_clock::now()};
+    if (now >= m_nextDump)
+    {
+        m_nextDump = now + m_dumpInterval;
+        dump(out);
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STAGE_PROFILER_HPP
+#define STAGE_PROFILER_HPP
+
+#include "latency-histogram.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// Stages of the frame loop that are timed
+enum Stage
+{
+    STAGE_WAIT,
+    STAGE_LOCK_COPY,
+    STAGE_BLUR,
+    STAGE_COLOR,
+    STAGE_CONES_BLUE,
+    STAGE_CONES_YELLOW,
+    STAGE_DISTANCE,
+    // Sending the GroundSteeringRequest in the OD4 session (--send); recorded by the result writer thread
+    STAGE_SEND,
+    STAGE_OUTPUT,
+    // From the sample timestamp in the shared memory to the printed steering wheel angle
+    STAGE_SAMPLE_TO_OUTPUT,
+    STAGE_COUNT
+};
+
+// One latency histogram per stage of the frame loop, accumulated since startup. Each stage must always be recorded
+// by the same thread.
+class StageProfiler
+{
+   public:
+    explicit StageProfiler(std::chrono::steady_clock::duration dumpInterval);
+
+    void record(Stage stage, uint64_t nanoseconds);
+    const LatencyHistogram &histogram(Stage stage) const;
+
+    // Print count, p50, p99, p99.9 and max of every stage in microseconds
+    void dump(std::ostream &out) const;
+    // Dump when the interval has passed since the last periodic dump; must always be called from the same thread
+    void dumpIfDue(std::ostream &out);
+
+   private:
+    LatencyHistogram m_histograms[STAGE_COUNT];
+    const std::chrono::steady_clock::duration m_dumpInterval;
+    std::chrono::steady_clock::time_point m_nextDump;
+};
+
+// Measures the time between consecutive laps and records it for the stage that just ended; does nothing without a profiler
+class StageClock
+{
+   public:
+    explicit StageClock(StageProfiler *profiler)
+        : m_profiler(profiler)
+        , m_last()
+    {
+        if (m_profiler != nullptr)
+        {
+            m_last = std::chrono::steady_clock::now();
+        }
+    }
+
+    void lap(Stage stage)
+    {
+        if (m_profiler != nullptr)
+        {
+            const std::chrono::steady_clock::time_point now{std::chrono::steady_clock::now()};
+            m_profiler->record(stage, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_last).count()));
+            m_last = now;
+        }
+    }
+
+   private:
+    StageProfiler *m_profiler;
+    std::chrono::steady_clock::time_point m_last;
+};
+
+#endif
@@ -19,88 +19,112 @@
 #include "cluon-complete.hpp"
 // Include the OpenDLV Standard Message Set that contains messages that are usually exchanged for automotive or robotic applications
 #include "opendlv-standard-message-set.hpp"
+// Include the lock-free cell that holds the latest received ground steering
+#include "latest-value.hpp"
+// Include the cone detection and steering shared with the offline evaluation
+#include "cone-detection.hpp"
+#include "cpu-dispatch.hpp"
+// Include the ingest of the region of interest out of the shared memory
+#include "frame-ingest.hpp"
+// Include the three-stage pipeline that overlaps ingest, detection and output
+#include "frame-pipeline.hpp"
+// Include the accounting of dropped frames and latency
+#include "frame-stats.hpp"
+// Include the background writer of the steering wheel angles
+#include "result-writer.hpp"
+#ifdef HAVE_ALLOCATION_COUNTER
+// Include the counter of heap allocations per thread
+#include "allocation-counter.hpp"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 // Include the GUI and image processing header files from OpenCV
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
-// Create two points to store the coordinates of the cones
-cv::Point blueCones;
-cv::Point yellowCones;
-// Create variables to store the coordinates of the previous cones
-cv::Point lastBlueCone;
-cv::Point lastYellowCone;
-// Constants for color and direction
-const char blue = 'B';
-const char yellow = 'Y';
-const char right = 'R';
-const char left = 'L';
-// Bools for cone detection
-bool isBlue = false;
-bool isYellow = false;
-bool bLeft = false;
-bool yLeft = false;
-bool fBlue = false;
-bool fYellow = false;
-bool isMirrored = true;
-// Variable for storing the direction of the car
-double steeringWheelAngle = 0.0;
-// Constant storing the number that is used to calculate the steering wheel angle
-const double magicNumber = 0.145540;
-// Range for the angle calculation
-const double threshold = 0.08;
-const double threshold2 = 0.9;
-// Variable to keep count of the corect frames
-double variable = 0;
-
-// Function to calculate the number of frames that meet the performance requirement
-void calculatePerformance(double groundSteering)
+// Number of frames after which the frame loop must not allocate anymore
+const uint64_t warmUpFrames = 10;
+
+// Frame slot of the pipelined mode; the detect stage leaves the steering wheel angle of the frame for the output stage
+struct PipelinedFrame
 {
-    // If original steering angle is 0, check if we are in range +/- 0.05
-    if (groundSteering == 0)
+    PipelinedFrame(const cv::Rect &region, const cv::Rect &ingestRegion)
+        : workspace(region, ingestRegion)
+        , timestamp(0)
+        , dropped(0)
+        , steeringWheelAngle(0.0)
     {
-        if (steeringWheelAngle < 0.05 && steeringWheelAngle > -0.05)
-        {
-            variable++;
-        }
     }
-    // If original steering angle is greater than 0, check if we are within 50%
-    else if (groundSteering > 0)
-    {
-        if (groundSteering * 0.5 < steeringWheelAngle && steeringWheelAngle < groundSteering * 1.5)
-        {
-            variable++;
-        }
-    }
-    // If original steering angle is less than 0, check if we are within 50%
-    else
+
+    FrameWorkspace workspace;
+    int64_t timestamp;
+    // Frames of the producer that were skipped before this one
+    uint32_t dropped;
+    double steeringWheelAngle;
+};
+
+// Where and how the results are written
+struct OutputSettings
+{
+    ResultFormat format;
+    std::string path;
+    size_t flushBytes;
+    std::chrono::milliseconds flushInterval;
+    // Also send every steering wheel angle in the OD4 session, with this senderStamp (plus the index of the stream)
+    bool send;
+    uint32_t senderStamp;
+};
+
+// Number of results that can wait for the writer before further results are dropped
+const size_t resultCapacity = 1024;
+
+// Function to start the writer of the results of the given streams; it also sends them in the OD4 session when asked to
+std::unique_ptr<ResultWriter> openResults(const OutputSettings &output, const std::vector<std::string> &names, cluon::OD4Session &od4, StageProfiler *profiler);
+
+// Function to send the steering wheel angle of a frame as GroundSteeringRequest, stamped with the sample time of the frame
+void sendSteering(cluon::OD4Session &od4, int64_t timestamp, double steeringWheelAngle, uint32_t senderStamp, StageProfiler *profiler);
+
+// Function to write the results that are still queued and report what the writer did
+void closeResults(ResultWriter &results, const char *program);
+
+// One shared memory area of the multi-stream mode with its own detector
+struct Stream
+{
+    Stream(const std::string &name, const VisionSettings &settings)
+        : sharedMemory(new cluon::SharedMemory{name})
+        , detector(settings)
+        , lastTimestamp(0)
+        , scheduled(false)
+        , pending(false)
     {
-        if (groundSteering * 0.5 > steeringWheelAngle && steeringWheelAngle > groundSteering * 1.5)
-        {
-            variable++;
-        }
     }
-    // Print the result
-    std::cout << variable << std::endl;
-}
 
-// High and low global variable values for blue and yellow colors
-cv::Scalar blueLow = cv::Scalar(100, 50, 30);
-cv::Scalar blueHigh = cv::Scalar(120, 255, 255);
-cv::Scalar yellowLow = cv::Scalar(17, 60, 70);
-cv::Scalar yellowHigh = cv::Scalar(40, 200, 200);
+    std::unique_ptr<cluon::SharedMemory> sharedMemory;
+    ConeDetector detector;
+    int64_t lastTimestamp;
+    // Set while the stream is queued or a worker processes a frame of it, so that its frames stay in order
+    std::atomic<bool> scheduled;
+    // Set when a new frame arrived since a worker last looked at the stream
+    std::atomic<bool> pending;
+};
 
-// Create a point for the center of the car
-cv::Point car = cv::Point(320, 0);
+// Longest time the waiter of a stream in the multi-stream mode sleeps before it looks at the timestamp in the shared
+// memory again and at whether the session still runs
+const std::chrono::milliseconds streamRecheckInterval(20);
 
-// Function to draw the cones on the image
-void getCones(cv::Mat hsvImg, cv::Mat img, cv::Scalar low, cv::Scalar high, char color);
+// Function to collect the names of all --name arguments; each may also be a comma separated list
+std::vector<std::string> sharedMemoryNames(int32_t argc, char **argv);
 
-// Create a funciton calculate the car direction
-void calculate(char direction, double difference);
+// Function to process the frames of several shared memory areas on a pool of workers until the OD4 session ends
+int32_t serveStreams(const std::vector<std::string> &names, size_t workers, uint16_t cid, const VisionSettings &settings, const OutputSettings &output, const char *program);
 
-// Create a function to calculate the difference between cones and the car
-void getDistance();
+// Function to account for a frame that has been output and print the statistics of every finished second
+void reportFrame(const VisionSettings &settings, FrameStats &stats, const ResultWriter &results, int64_t timestamp, uint32_t dropped, bool print, const char *name);
 
 int32_t main(int32_t argc, char **argv)
 {
@@ -113,11 +137,49 @@ int32_t main(int32_t argc, char **argv)
         (0 == commandlineArguments.count("height")))
     {
         std::cerr << argv[0] << " attaches to a shared memory area containing an ARGB image." << std::endl;
-        std::cerr << "Usage:   " << argv[0] << " --cid=<OD4 session> --name=<name of shared memory area> [--verbose]" << std::endl;
+        std::cerr << "Usage:   " << argv[0] << " --cid=<OD4 session> --name=<name of shared memory area> [--ingest=copy|inplace] [--classifier=hsv|lut [--lut-bits=6]] [--tracking [--track-rescan=5]] [--coarse=1|2|4] [--denoise=blur|open] [--blur=separate|fused] [--detector=blobs|projection] [--kernels=auto|scalar|sse4.1|avx2] [--workers=<n>] [--output=text|csv|binary|od4] [--output-file=<path>] [--flush-bytes=4096] [--flush-ms=100] [--send [--sender-stamp=1]] [--pipeline [--pipeline-slots=4]] [--schedule=wait|latest] [--fps=<n>] [--frame-stats] [--profile [--profile-every=10]] [--count-allocations] [--max-allocations=<n>] [--verbose]" << std::endl;
         std::cerr << "         --cid:    CID of the OD4Session to send and receive messages" << std::endl;
-        std::cerr << "         --name:   name of the shared memory area to attach" << std::endl;
+        std::cerr << "         --name:   name of the shared memory area to attach; repeat it or separate names by commas to serve several" << std::endl;
+        std::cerr << "                   cameras, each with its own cone detector, on a shared pool of --workers threads (default: one per core)" << std::endl;
         std::cerr << "         --width:  width of the frame" << std::endl;
         std::cerr << "         --height: height of the frame" << std::endl;
+        std::cerr << "         --ingest: copy only the region of interest out of the shared memory (copy, default)" << std::endl;
+        std::cerr << "                   or blur it directly from the shared memory while the lock is held (inplace)" << std::endl;
+        std::cerr << "         --classifier: segment the colors with the exact HSV conversion (hsv, default)" << std::endl;
+        std::cerr << "                       or with a lookup table of quantized BGR colors built at startup (lut)" << std::endl;
+        std::cerr << "         --lut-bits:   bits per channel of the lookup table (" << ColorLut::MIN_BITS << ".." << ColorLut::MAX_BITS << "; 8 is exact)" << std::endl;
+        std::cerr << "         --output:     write the steering wheel angles as \"group_04; <timestamp>; <angle>\" lines (text, default), as CSV," << std::endl;
+        std::cerr << "                       as 20-byte binary records or only send them like --send (od4)" << std::endl;
+        std::cerr << "         --output-file: write them to this file instead of stdout" << std::endl;
+        std::cerr << "         --flush-bytes: write the buffered results once this many bytes are buffered" << std::endl;
+        std::cerr << "         --flush-ms:    or once the oldest buffered result is this many milliseconds old" << std::endl;
+        std::cerr << "         --send:        also send every steering wheel angle as GroundSteeringRequest in the OD4 session, with the" << std::endl;
+        std::cerr << "                        sample time of the frame as sampleTimeStamp, from the thread that writes the results" << std::endl;
+        std::cerr << "         --sender-stamp: senderStamp of the sent requests (default 1; the ground truth in the recordings uses 0);" << std::endl;
+        std::cerr << "                         several streams use consecutive sender stamps" << std::endl;
+        std::cerr << "         --tracking:     predict where the cones will be and only search windows around them; the whole region" << std::endl;
+        std::cerr << "                         is searched every --track-rescan frames and after a cone was lost" << std::endl;
+        std::cerr << "         --coarse:       look for the cones in the region downsampled by this factor first and blur, segment" << std::endl;
+        std::cerr << "                         and search only around what was found there at full resolution (default 1: off)" << std::endl;
+        std::cerr << "         --denoise:      blur the region before segmenting it (blur, default) or open the segmented masks with a" << std::endl;
+        std::cerr << "                         3x3 square on one bit per pixel instead (open)" << std::endl;
+        std::cerr << "         --blur:         blur the whole region before segmenting it (separate, default) or blur every row right" << std::endl;
+        std::cerr << "                         before it is segmented, rounding each pass to 8 bits (fused)" << std::endl;
+        std::cerr << "         --detector:     find the cones as connected components of the masks (blobs, default) or from peaks of" << std::endl;
+        std::cerr << "                         their hits per column and row (projection)" << std::endl;
+        std::cerr << "         --kernels:      instruction set of the segmentation and blur kernels; auto picks the best one that the" << std::endl;
+        std::cerr << "                         CPU supports (default)" << std::endl;
+        std::cerr << "         --pipeline:       ingest, detect and print frames on three threads so that consecutive frames overlap" << std::endl;
+        std::cerr << "         --pipeline-slots: number of preallocated frames in flight in the pipeline (at least 3)" << std::endl;
+        std::cerr << "         --schedule:       wait for the notification of the next frame (wait, default) or take the frame in the" << std::endl;
+        std::cerr << "                           shared memory right away when it is newer than the last processed one (latest)" << std::endl;
+        std::cerr << "         --fps:            frame rate of the producer to count dropped frames; estimated from the timestamps if omitted" << std::endl;
+        std::cerr << "         --frame-stats:    print the processed and dropped frames, the worst sample-to-output latency and the results" << std::endl;
+        std::cerr << "                           that the writer dropped every second" << std::endl;
+        std::cerr << "         --profile:        time every stage of the frame loop and print p50/p99/p99.9/max per stage at exit" << std::endl;
+        std::cerr << "         --profile-every:  also print them every this many seconds" << std::endl;
+        std::cerr << "         --count-allocations: print the heap allocations of every frame (needs -D WITH_ALLOCATION_COUNTER=ON)" << std::endl;
+        std::cerr << "         --max-allocations:   exit with an error once a frame after the warm-up allocates more often (needs -D WITH_ALLOCATION_COUNTER=ON)" << std::endl;
         std::cerr << "Example: " << argv[0] << " --cid=253 --name=img --width=640 --height=480 --verbose" << std::endl;
     }
     else
@@ -127,6 +189,154 @@ int32_t main(int32_t argc, char **argv)
         const uint32_t WIDTH{static_cast<uint32_t>(std::stoi(commandlineArguments["width"]))};
         const uint32_t HEIGHT{static_cast<uint32_t>(std::stoi(commandlineArguments["height"]))};
         const bool VERBOSE{commandlineArguments.count("verbose") != 0};
+        const bool INPLACE{(commandlineArguments.count("ingest") != 0) && (commandlineArguments["ingest"] == "inplace")};
+        const bool USE_LUT{(commandlineArguments.count("classifier") != 0) && (commandlineArguments["classifier"] == "lut")};
+        const int LUT_BITS{(commandlineArguments.count("lut-bits") != 0) ? std::stoi(commandlineArguments["lut-bits"]) : 6};
+        const bool TRACKING{commandlineArguments.count("tracking") != 0};
+        const uint32_t TRACK_RESCAN{(commandlineArguments.count("track-rescan") != 0) ? static_cast<uint32_t>(std::max(1, std::stoi(commandlineArguments["track-rescan"]))) : 5};
+        const int COARSE{(commandlineArguments.count("coarse") != 0) ? std::stoi(commandlineArguments["coarse"]) : 1};
+        const bool OPEN_MASKS{(commandlineArguments.count("denoise") != 0) && (commandlineArguments["denoise"] == "open")};
+        const bool PROJECTION{(commandlineArguments.count("detector") != 0) && (commandlineArguments["detector"] == "projection")};
+        const bool FUSED_BLUR{(commandlineArguments.count("blur") != 0) && (commandlineArguments["blur"] == "fused")};
+        const std::string KERNELS{(commandlineArguments.count("kernels") != 0) ? commandlineArguments["kernels"] : "auto"};
+        const bool PIPELINE{commandlineArguments.count("pipeline") != 0};
+        const size_t PIPELINE_SLOTS{(commandlineArguments.count("pipeline-slots") != 0) ? static_cast<size_t>(std::max(0, std::stoi(commandlineArguments["pipeline-slots"]))) : 4};
+        const bool LATEST{(commandlineArguments.count("schedule") != 0) && (commandlineArguments["schedule"] == "latest")};
+        const int64_t FRAME_PERIOD{(commandlineArguments.count("fps") != 0) ? static_cast<int64_t>(1000000.0 / std::stod(commandlineArguments["fps"])) : 0};
+        const bool FRAME_STATS{commandlineArguments.count("frame-stats") != 0};
+        const bool PROFILE{commandlineArguments.count("profile") != 0};
+        const int PROFILE_EVERY{(commandlineArguments.count("profile-every") != 0) ? std::stoi(commandlineArguments["profile-every"]) : 10};
+        const std::string OUTPUT{(commandlineArguments.count("output") != 0) ? commandlineArguments["output"] : "text"};
+        const std::string OUTPUT_FILE{(commandlineArguments.count("output-file") != 0) ? commandlineArguments["output-file"] : ""};
+        const size_t FLUSH_BYTES{(commandlineArguments.count("flush-bytes") != 0) ? static_cast<size_t>(std::max(0, std::stoi(commandlineArguments["flush-bytes"]))) : 4096};
+        const int FLUSH_MS{(commandlineArguments.count("flush-ms") != 0) ? std::stoi(commandlineArguments["flush-ms"]) : 100};
+        const bool SEND{(commandlineArguments.count("send") != 0) || (OUTPUT == "od4")};
+        const uint32_t SENDER_STAMP{(commandlineArguments.count("sender-stamp") != 0) ? static_cast<uint32_t>(std::stoul(commandlineArguments["sender-stamp"])) : 1};
+#ifdef HAVE_ALLOCATION_COUNTER
+        const bool COUNT_ALLOCATIONS{commandlineArguments.count("count-allocations") != 0};
+        const bool CHECK_ALLOCATIONS{commandlineArguments.count("max-allocations") != 0};
+        const uint64_t MAX_ALLOCATIONS{CHECK_ALLOCATIONS ? static_cast<uint64_t>(std::stoll(commandlineArguments["max-allocations"])) : 0};
+        if (PIPELINE && (COUNT_ALLOCATIONS || CHECK_ALLOCATIONS))
+        {
+            std::cerr << argv[0] << ": Allocations are only counted in the serial frame loop." << std::endl;
+            return retCode;
+        }
+#else
+        if ((commandlineArguments.count("count-allocations") != 0) || (commandlineArguments.count("max-allocations") != 0))
+        {
+            std::cerr << argv[0] << ": Counting allocations requires building with -D WITH_ALLOCATION_COUNTER=ON." << std::endl;
+            return retCode;
+        }
+#endif
+        if ((COARSE != 1) && (COARSE != 2) && (COARSE != 4))
+        {
+            std::cerr << argv[0] << ": --coarse must be 1, 2 or 4." << std::endl;
+            return retCode;
+        }
+        if (TRACKING && (COARSE > 1))
+        {
+            std::cerr << argv[0] << ": --tracking and --coarse cannot be combined." << std::endl;
+            return retCode;
+        }
+        if (OPEN_MASKS && (INPLACE || (COARSE > 1)))
+        {
+            std::cerr << argv[0] << ": --denoise=open does not blur, so it cannot be combined with --ingest=inplace or --coarse." << std::endl;
+            return retCode;
+        }
+        if (PROJECTION && (OPEN_MASKS || (COARSE > 1)))
+        {
+            std::cerr << argv[0] << ": --detector=projection cannot be combined with --denoise=open or --coarse." << std::endl;
+            return retCode;
+        }
+        if (FUSED_BLUR && (INPLACE || OPEN_MASKS))
+        {
+            std::cerr << argv[0] << ": --blur=fused cannot be combined with --ingest=inplace or --denoise=open, which blur differently or not at all." << std::endl;
+            return retCode;
+        }
+        if (PIPELINE && PIPELINE_SLOTS < 3)
+        {
+            std::cerr << argv[0] << ": The pipeline needs at least 3 frame slots to keep all stages busy." << std::endl;
+            return retCode;
+        }
+        KernelSet kernelSet;
+        if (!parseKernelSet(KERNELS, kernelSet))
+        {
+            std::cerr << argv[0] << ": Unknown --kernels=" << KERNELS << "; use auto, scalar, sse4.1 or avx2." << std::endl;
+            return retCode;
+        }
+        if (!kernelSetSupported(kernelSet))
+        {
+            std::cerr << argv[0] << ": This CPU does not support the " << kernelSetName(kernelSet) << " kernels; the best it supports are " << kernelSetName(bestKernelSet()) << "." << std::endl;
+            return retCode;
+        }
+        // Bind the kernels before anything uses them
+        selectKernels(kernelSet);
+        std::clog << argv[0] << ": Using the " << kernelSetName(visionKernels().set) << " vision kernels." << std::endl;
+
+        // Clip the region of interest and the rows around it that the blur kernel reads to the frame
+        const cv::Rect frame(0, 0, static_cast<int>(WIDTH), static_cast<int>(HEIGHT));
+        const cv::Rect region = roi & frame;
+        const cv::Rect ingestRegion = cv::Rect(region.x, region.y - blurMargin, region.width, region.height + 2 * blurMargin) & frame;
+        // The HSV thresholds are fixed, so convert them once for the segmentation kernel
+        const HsvRange blueRange = toHsvRange(blueLow, blueHigh);
+        const HsvRange yellowRange = toHsvRange(yellowLow, yellowHigh);
+        // Optionally replace the per-pixel HSV conversion with a table lookup
+        std::unique_ptr<ColorLut> lut;
+        if (USE_LUT)
+        {
+            lut.reset(new ColorLut(blueRange, yellowRange, LUT_BITS));
+            std::clog << argv[0] << ": Built " << lut->bitsPerChannel() << " bits per channel color lookup table (" << lut->size() << " bytes)." << std::endl;
+        }
+        // Optionally time every stage of the frame loop
+        std::unique_ptr<StageProfiler> profiler;
+        if (PROFILE)
+        {
+            profiler.reset(new StageProfiler(std::chrono::seconds(PROFILE_EVERY)));
+        }
+        // Only draw the cones when the image is displayed
+        const VisionSettings settings{WIDTH, HEIGHT, region, ingestRegion, INPLACE, LATEST, blueRange, yellowRange, lut.get(), VERBOSE, profiler.get(), TRACKING, TRACK_RESCAN, COARSE, OPEN_MASKS, PROJECTION, FUSED_BLUR};
+
+        // Format the results on a background thread and write them in batches
+        ResultFormat format{RESULT_TEXT};
+        if (OUTPUT == "csv")
+        {
+            format = RESULT_CSV;
+        }
+        else if (OUTPUT == "binary")
+        {
+            format = RESULT_BINARY;
+        }
+        else if (OUTPUT == "od4")
+        {
+            format = RESULT_SEND;
+        }
+        else if (OUTPUT != "text")
+        {
+            std::cerr << argv[0] << ": Unknown --output=" << OUTPUT << "; use text, csv, binary or od4." << std::endl;
+            return retCode;
+        }
+        const OutputSettings output{format, OUTPUT_FILE, FLUSH_BYTES, std::chrono::milliseconds(std::max(0, FLUSH_MS)), SEND, SENDER_STAMP};
+
+        // Several --name arguments serve several cameras from this process on a shared pool of workers
+        const std::vector<std::string> NAMES{sharedMemoryNames(argc, argv)};
+        if (NAMES.size() > 1)
+        {
+            if (PIPELINE || VERBOSE || PROFILE || FRAME_STATS)
+            {
+                std::cerr << argv[0] << ": --pipeline, --verbose, --profile and --frame-stats only work with a single --name." << std::endl;
+                return retCode;
+            }
+#ifdef HAVE_ALLOCATION_COUNTER
+            if (COUNT_ALLOCATIONS || CHECK_ALLOCATIONS)
+            {
+                std::cerr << argv[0] << ": Allocations are only counted in the serial frame loop." << std::endl;
+                return retCode;
+            }
+#endif
+            const size_t CORES{std::max(1u, std::thread::hardware_concurrency())};
+            const size_t WORKERS{(commandlineArguments.count("workers") != 0) ? static_cast<size_t>(std::max(1, std::stoi(commandlineArguments["workers"]))) : std::min(NAMES.size(), CORES)};
+            return serveStreams(NAMES, WORKERS, static_cast<uint16_t>(std::stoi(commandlineArguments["cid"])), settings, output, argv[0]);
+        }
 
         // Attach to the shared memory.
         std::unique_ptr<cluon::SharedMemory> sharedMemory{new cluon::SharedMemory{NAME}};
@@ -138,340 +348,348 @@ int32_t main(int32_t argc, char **argv)
             // The instance od4 allows you to send and receive messages.
             cluon::OD4Session od4{static_cast<uint16_t>(std::stoi(commandlineArguments["cid"]))};
 
-            opendlv::proxy::GroundSteeringRequest gsr;
-            std::mutex gsrMutex;
-            auto onGroundSteeringRequest = [&gsr, &gsrMutex](cluon::data::Envelope &&env)
+            // Latest received ground steering; the receive thread publishes into it and the frame loop samples it without a lock.
+            // The envelope data structure provide further details, such as sampleTimePoint as shown in this test case:
+            // https://github.com/chrberger/libcluon/blob/master/libcluon/testsuites/TestEnvelopeConverter.cpp#L31-L40
+            LatestValue<opendlv::proxy::GroundSteeringRequest> gsr;
+            // The requests are decoded straight from the received datagram into a message that the session reuses.
+            std::function<void(const opendlv::proxy::GroundSteeringRequest &, const cluon::EnvelopeMeta &)> publishGroundSteering{publishLatest(gsr)};
+            od4.dataTrigger<opendlv::proxy::GroundSteeringRequest>(
+                [&publishGroundSteering, SEND, SENDER_STAMP](const opendlv::proxy::GroundSteeringRequest &request, const cluon::EnvelopeMeta &meta)
+                {
+                    // Do not take our own requests for the ground truth
+                    if (!SEND || (meta.senderStamp != SENDER_STAMP))
+                    {
+                        publishGroundSteering(request, meta);
+                    }
+                });
+
+            std::unique_ptr<ResultWriter> results{openResults(output, std::vector<std::string>{NAME}, od4, settings.profiler)};
+            if (!results->valid())
             {
-                // The envelope data structure provide further details, such as sampleTimePoint as shown in this test case:
-                // https://github.com/chrberger/libcluon/blob/master/libcluon/testsuites/TestEnvelopeConverter.cpp#L31-L40
-                std::lock_guard<std::mutex> lck(gsrMutex);
-                gsr = cluon::extractMessage<opendlv::proxy::GroundSteeringRequest>(std::move(env));
-                // std::cout << "groundSteering = " << gsr.groundSteering() << std::endl;
-            };
+                std::cerr << argv[0] << ": Failed to open '" << OUTPUT_FILE << "'." << std::endl;
+                return retCode;
+            }
 
-            od4.dataTrigger(opendlv::proxy::GroundSteeringRequest::ID(), onGroundSteeringRequest);
+            // Count the frames that were skipped and the time from sampling a frame to printing its steering wheel angle
+            DropDetector dropDetector(FRAME_PERIOD);
+            FrameStats stats;
+            // Timestamp of the last ingested frame
+            int64_t lastTimestamp{0};
 
-            // Endless loop; end the program by pressing Ctrl-C.
-            while (od4.isRunning())
+            if (PIPELINE)
             {
-                // OpenCV data structure to hold an image.
-                cv::Mat img;
-                // Wait for a notification of a new frame.
-                sharedMemory->wait();
-                // Lock the shared memory.
-                sharedMemory->lock();
-                {
-                    // Copy the pixels from the shared memory into our own data structure.
-                    cv::Mat wrapped(HEIGHT, WIDTH, CV_8UC4, sharedMemory->data());
-                    img = wrapped.clone();
-                }
-                // Get the time for each image
-                std::pair<bool, cluon::data::TimeStamp> imageTime = sharedMemory->getTimeStamp();
-                // Convert the time to microseconds
-                std::string timestamp = std::to_string(cluon::time::toMicroseconds(imageTime.second));
-                // Crop some of the dead space
-                img = img(cv::Rect(0, 240, 640, 100));
-                // Unlock the shared memory
-                sharedMemory->unlock();
-
-                // TODO: Do something with the frame.
-                // Blue the image to reduce noise
-                cv::GaussianBlur(img, img, cv::Size(7, 7), 1.0);
-                // Create a new mat image
-                cv::Mat hsvImg;
-                // Copy the original image to the new one
-                img.copyTo(hsvImg);
-                // Convert the new image to the hsv color space
-                cv::cvtColor(hsvImg, hsvImg, cv::COLOR_BGR2HSV);
-                // Reset the cone variables every frame
-                isBlue = false;
-                isYellow = false;
-                isMirrored = true;
-                // Call the getCones function for blue
-                getCones(hsvImg, img, blueLow, blueHigh, blue);
-                // Call the getCones function for yellow
-                getCones(hsvImg, img, yellowLow, yellowHigh, yellow);
-                // Call the getDistance function
-                getDistance();
-
-                // Funciton to be used for measuring the preformance
-                // double groundSteering = gsr.groundSteering();
-                // calculatePerformance(groundSteering);
-
-                // If you want to access the latest received ground steering, don't forget to lock the mutex:
-                {
-                    std::lock_guard<std::mutex> lck(gsrMutex);
-                    std::cout << "group_04; " << timestamp << "; " << steeringWheelAngle << std::endl;
-                }
-                // Display image on your screen.
-                if (VERBOSE)
+                // Cone positions and steering state of the stream; the slots only carry the buffers
+                SteeringController steering;
+                // Preallocate a workspace for every frame that can be in flight
+                FramePipeline<PipelinedFrame> pipeline(PIPELINE_SLOTS, region, ingestRegion);
+                std::clog << argv[0] << ": Running ingest, detection and output on separate threads with " << PIPELINE_SLOTS << " frame slots." << std::endl;
+                // Endless loop; end the program by pressing Ctrl-C.
+                pipeline.run(
+                    [&od4, &sharedMemory, &settings, &dropDetector, &lastTimestamp](PipelinedFrame &slot)
+                    {
+                        if (!od4.isRunning())
+                        {
+                            return false;
+                        }
+                        slot.timestamp = ingestFrame(*sharedMemory, settings, lastTimestamp, slot.workspace);
+                        slot.dropped = dropDetector.update(slot.timestamp);
+                        lastTimestamp = slot.timestamp;
+                        return true;
+                    },
+                    [&settings, &steering](PipelinedFrame &slot)
+                    {
+                        // The cone state carries over from frame to frame, so only this stage touches it
+                        detectFrame(settings, slot.workspace, steering);
+                        slot.steeringWheelAngle = steering.steeringWheelAngle;
+                    },
+                    [&sharedMemory, &results, &settings, &stats, VERBOSE, FRAME_STATS, &argv](PipelinedFrame &slot)
+                    {
+                        StageClock clock(settings.profiler);
+                        results->push(ResultRecord{slot.timestamp, slot.steeringWheelAngle, 0});
+                        // Display image on your screen.
+                        if (VERBOSE)
+                        {
+                            cv::imshow(sharedMemory->name().c_str(), slot.workspace.img);
+                            cv::waitKey(1);
+                        }
+                        clock.lap(STAGE_OUTPUT);
+                        reportFrame(settings, stats, *results, slot.timestamp, slot.dropped, FRAME_STATS, argv[0]);
+                    });
+            }
+            else
+            {
+                // Preallocate the buffers for the region of interest, its blur margin, the masks and the blobs
+                ConeDetector detector(settings);
+
+                // Number of processed frames
+                uint64_t frames{0};
+                // Endless loop; end the program by pressing Ctrl-C.
+                while (od4.isRunning())
                 {
-                    cv::imshow(sharedMemory->name().c_str(), img);
-                    cv::waitKey(1);
+#ifdef HAVE_ALLOCATION_COUNTER
+                    // Remember how often this thread allocated before the frame
+                    const uint64_t allocationsBefore{threadAllocations()};
+#endif
+                    // Wait for the next frame and copy what we need out of the shared memory
+                    const int64_t timestamp{ingestFrame(*sharedMemory, settings, lastTimestamp, detector.workspace())};
+                    const uint32_t dropped{dropDetector.update(timestamp)};
+                    lastTimestamp = timestamp;
+
+                    // Find the cones and steer
+                    const double steeringWheelAngle{detector.detect()};
+
+                    // Funciton to be used for measuring the preformance
+                    // opendlv::proxy::GroundSteeringRequest latest;
+                    // double groundSteering = gsr.read(latest) ? latest.groundSteering() : 0.0;
+                    // detector.steering().calculatePerformance(groundSteering);
+                    // std::cout << detector.steering().variable << std::endl;
+
+                    StageClock clock(settings.profiler);
+                    results->push(ResultRecord{timestamp, steeringWheelAngle, 0});
+                    // Display image on your screen.
+                    if (VERBOSE)
+                    {
+                        cv::imshow(sharedMemory->name().c_str(), detector.workspace().img);
+                        cv::waitKey(1);
+                    }
+                    clock.lap(STAGE_OUTPUT);
+                    reportFrame(settings, stats, *results, timestamp, dropped, FRAME_STATS, argv[0]);
+                    frames++;
+#ifdef HAVE_ALLOCATION_COUNTER
+                    // Report the allocations of this frame and stop when a frame after the warm-up exceeds the budget
+                    const uint64_t allocations{threadAllocations() - allocationsBefore};
+                    if (COUNT_ALLOCATIONS)
+                    {
+                        std::clog << argv[0] << ": Frame " << frames << " made " << allocations << " heap allocations." << std::endl;
+                    }
+                    if (CHECK_ALLOCATIONS && (frames > warmUpFrames) && (allocations > MAX_ALLOCATIONS))
+                    {
+                        std::cerr << argv[0] << ": Frame " << frames << " made " << allocations << " heap allocations, more than the allowed " << MAX_ALLOCATIONS << "." << std::endl;
+                        return retCode;
+                    }
+#endif
                 }
             }
+            closeResults(*results, argv[0]);
+            if (FRAME_STATS)
+            {
+                std::clog << argv[0] << ": Processed " << stats.totalProcessed() << " frames and dropped " << stats.totalDropped() << " (frame period " << dropDetector.framePeriod() << " us)." << std::endl;
+            }
+            if (profiler)
+            {
+                profiler->dump(std::clog);
+            }
         }
         retCode = 0;
     }
     return retCode;
 }
 
-void getCones(cv::Mat hsvImg, cv::Mat img, cv::Scalar low, cv::Scalar high, char color)
+std::vector<std::string> sharedMemoryNames(int32_t argc, char **argv)
 {
-    // Create a mask from the hvs image that only contains the colors in the specified range
-    cv::Mat mask;
-    cv::inRange(hsvImg, low, high, mask);
-    // Initiate a variable to store the outlines of the cones
-    std::vector<std::vector<cv::Point>> contours;
-    // Find the outlines of cones from the mask and assign them to the contours variable
-    cv::findContours(mask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-    // Create a rectangle to store the previous position of the cone
-    cv::Rect lastRect(0, 0, 0, 0);
-    // Check if the color is blue
-    if (color == blue)
+    // cluon::getCommandlineArguments keeps only the last of repeated arguments, so look at all of them here
+    const std::string prefix{"--name="};
+    std::vector<std::string> names;
+    for (int32_t i = 1; i < argc; i++)
     {
-        // Go through all the contours
-        for (size_t i = 0; i < contours.size(); ++i)
+        const std::string argument{argv[i]};
+        if (0 == argument.compare(0, prefix.size(), prefix))
         {
-            // Get a rectangle from the current outline
-            cv::Rect boundRect = cv::boundingRect(contours[i]);
-            // Check that the rectangle isn't too big or too small to eliminate noise
-            if ((boundRect.area() > 200) && boundRect.area() < 1500)
+            for (const std::string &name : stringtoolbox::split(argument.substr(prefix.size()), ','))
             {
-                // A blue cone has been found
-                isBlue = true;
-                // Check if the current cone is in the same position as the previous one
-                if (boundRect.y > lastRect.y)
+                if (!name.empty())
                 {
-                    // Draw the rectangle on the source image
-                    // boundRect.tl() is the top left of the rectangle; boundRect.br() is the bottom right corner
-                    cv::rectangle(img, boundRect.tl(), boundRect.br(), cvScalar(0, 255, 0), 3);
+                    names.push_back(name);
                 }
-                // Update the last rectangle
-                lastRect = boundRect;
             }
         }
-        // Save the closest rectangle to the blue cone variable
-        blueCones = cv::Point(lastRect.x + lastRect.width / 2, lastRect.y + lastRect.height / 2);
-        // Update the lastBlueCone variable with the new position
-        if (!fBlue)
-        {
-            fBlue = true;
-            lastBlueCone = blueCones;
-            // Check if the blue cone is on the left or right side of the image
-        }
-        if (blueCones.x < car.x && isMirrored)
-        {
-            bLeft = true;
-            yLeft = false;
-            isMirrored = false;
-        }
     }
-    // Check if the color is yellow
-    else if (color == yellow)
+    return names;
+}
+
+int32_t serveStreams(const std::vector<std::string> &names, size_t workers, uint16_t cid, const VisionSettings &settings, const OutputSettings &output, const char *program)
+{
+    // Attach to all shared memory areas and give each its own detector
+    std::vector<std::unique_ptr<Stream>> streams;
+    for (const std::string &name : names)
     {
-        // Go through all the contours
-        for (size_t i = 0; i < contours.size(); ++i)
-        {
-            // Get a rectangle from the current outline
-            cv::Rect boundRect = cv::boundingRect(contours[i]);
-            // Check that the rectangle isn't too big or too small to eliminate noise
-            if ((boundRect.area() > 200) && boundRect.area() < 1500)
-            {
-                // change the isYellow variable to true
-                isYellow = true;
-                // Check if the current cone is in the same position as the previous one
-                if (boundRect.y > lastRect.y)
-                {
-                    // Draw the rectangle on the source image
-                    // boundRect.tl() is the top left of the rectangle; boundRect.br() is the bottom right corner
-                    cv::rectangle(img, boundRect.tl(), boundRect.br(), cvScalar(0, 255, 0), 3);
-                }
-                // Update the last rectangle
-                lastRect = boundRect;
-            }
-        }
-        // Save the closest rectangle to the yellow cone variable
-        yellowCones = cv::Point(lastRect.x + lastRect.width / 2, lastRect.y + lastRect.height / 2);
-        // Update the lastYellowCone variable with the new position
-        if (!fYellow)
+        std::unique_ptr<Stream> stream{new Stream(name, settings)};
+        if (!stream->sharedMemory->valid())
         {
-            fYellow = true;
-            lastYellowCone = yellowCones;
-        }
-        // Check if the yellow cone is on the left or right side of the image
-        if (yellowCones.x < car.x && isMirrored)
-        {
-            bLeft = false;
-            yLeft = true;
-            isMirrored = false;
+            std::cerr << program << ": Failed to attach to shared memory '" << name << "'." << std::endl;
+            return 1;
         }
+        std::clog << program << ": Attached to shared memory '" << stream->sharedMemory->name() << " (" << stream->sharedMemory->size() << " bytes)." << std::endl;
+        streams.push_back(std::move(stream));
     }
-}
 
-void getDistance()
-{
-    // If both blue and yellow cones are found
-    if (isBlue && isYellow)
+    cluon::OD4Session od4{cid};
+    // Every stream has its own ring in the writer, so the workers push their results without a lock
+    std::unique_ptr<ResultWriter> results{openResults(output, names, od4, nullptr)};
+    if (!results->valid())
     {
-        // Set the steering wheel angle to 0
-        steeringWheelAngle = 0.049;
+        std::cerr << program << ": Failed to open '" << output.path << "'." << std::endl;
+        return 1;
     }
-    else
+    std::clog << program << ": Serving " << streams.size() << " streams on " << workers << " workers." << std::endl;
+
+    // Streams with a new frame that wait for a worker, in the order their frames arrived; a stream is queued at most once
+    std::mutex readyMutex;
+    std::condition_variable readyCondition;
+    std::vector<size_t> ready(streams.size());
+    size_t readyHead{0};
+    size_t readyCount{0};
+    bool stopping{false};
+    // Queue a stream unless it is queued or being processed already
+    auto schedule = [&streams, &readyMutex, &readyCondition, &ready, &readyHead, &readyCount](size_t index)
     {
-        // Initialize variable to store the differance between the cones and the car
-        double difference = 0.0;
-        // Check if the blue cone is on the left side of the image
-        if (bLeft)
+        if (!streams[index]->scheduled.exchange(true))
         {
-            // Check if we have a blue cone in frame
-            if (isBlue)
             {
-                // Set the differance to the difference between the car and the blue cone
-                difference = static_cast<double>(blueCones.x) / static_cast<double>(car.x);
-                // Check that the calculation is in the correct range
-                if (abs(difference) < threshold || abs(difference) > threshold2)
-                {
-                    steeringWheelAngle = -0.049;
-                }
-                else
-                {
-                    // Check if the current blue cone is the same as the last blue cone
-                    if (blueCones.x > lastBlueCone.x)
-                    {
-                        // Call the steer function with the direction and the differance to calculate the steering wheel angle
-                        calculate(right, difference || abs(difference) > threshold2);
-                    }
-                    else
-                    {
-                        steeringWheelAngle = -0.049;
-                    }
-                }
+                std::lock_guard<std::mutex> lck(readyMutex);
+                ready[(readyHead + readyCount) % ready.size()] = index;
+                readyCount++;
             }
-            // Check if we have a yellow cone in frame
-            else if (isYellow)
+            readyCondition.notify_one();
+        }
+    };
+
+    // One thread per stream sleeps on the notifications of its shared memory and queues the stream when the frame
+    // in it changed; the bounded wait catches a notification that came while the timestamp was read
+    std::vector<std::thread> waiters;
+    for (size_t i = 0; i < streams.size(); i++)
+    {
+        waiters.emplace_back(
+            [&streams, &od4, &schedule, program, i]()
             {
-                // Set the differance to the difference between the car and the yellow cone
-                difference = static_cast<double>(car.x) / static_cast<double>(yellowCones.x);
-                // Check that the calculation is in the correct range
-                if (abs(difference) < threshold || abs(difference) > threshold2)
+                Stream &stream = *streams[i];
+                int64_t seen{0};
+                while (od4.isRunning() && stream.sharedMemory->valid())
                 {
-                    steeringWheelAngle = 0.049;
-                }
-                else
-                {
-                    // Check if the current yellow cone is the same as the last yellow cone
-                    if (yellowCones.y == lastYellowCone.y)
+                    stream.sharedMemory->waitFor(streamRecheckInterval);
+                    stream.sharedMemory->lock();
+                    const int64_t timestamp{cluon::time::toMicroseconds(stream.sharedMemory->getTimeStamp().second)};
+                    stream.sharedMemory->unlock();
+                    if (timestamp != seen)
                     {
-                        steeringWheelAngle = 0.049;
-                    }
-                    else if (yellowCones.y > lastYellowCone.y)
-                    {
-                        calculate(left, difference);
+                        seen = timestamp;
+                        stream.pending.store(true);
+                        schedule(i);
                     }
                 }
-            }
-            // Set the differance to 0
-            difference = 0.0;
-        }
-        // Check if the yellow cone is on the left side of the image
-        else if (yLeft)
-        {
-            // Check if we have a yellow cone in frame
-            if (isYellow)
-            {
-                // Set the differance to the difference between the car and the yellow cone
-                difference = static_cast<double>(yellowCones.x) / static_cast<double>(car.x);
-                // Check that the calculation is in the correct range
-                if (abs(difference) < threshold || abs(difference) > threshold2)
+                if (!stream.sharedMemory->valid())
                 {
-                    steeringWheelAngle = -0.049;
+                    std::cerr << program << ": Lost shared memory '" << stream.sharedMemory->name() << "'." << std::endl;
                 }
-                else
+            });
+    }
+
+    // The workers sleep until a stream is queued and process its newest frame
+    std::vector<std::thread> pool;
+    for (size_t w = 0; w < workers; w++)
+    {
+        pool.emplace_back(
+            [&streams, &results, &settings, &readyMutex, &readyCondition, &ready, &readyHead, &readyCount, &stopping, &schedule]()
+            {
+                while (true)
                 {
-                    // Check if the current yellow cone is the same as the last yellow cone
-                    if (yellowCones.x > lastYellowCone.x)
-                    {
-                        calculate(right, difference);
-                    }
-                    else
+                    size_t index{0};
                     {
-                        steeringWheelAngle = -0.049;
+                        std::unique_lock<std::mutex> lck(readyMutex);
+                        readyCondition.wait(lck, [&readyCount, &stopping]() { return (readyCount > 0) || stopping; });
+                        if (0 == readyCount)
+                        {
+                            break;
+                        }
+                        index = ready[readyHead];
+                        readyHead = (readyHead + 1) % ready.size();
+                        readyCount--;
                     }
-                }
-            }
-            // Check if we have a blue cone in frame
-            else if (isBlue)
-            {
-                // Set the differance to the difference between the car and the blue cone
-                difference = static_cast<double>(car.x) / static_cast<double>(blueCones.x);
-                // Check that the calculation is in the correct range
-                if (abs(difference) < threshold || abs(difference) > threshold2)
-                {
-                    steeringWheelAngle = 0.049;
-                }
-                else
-                {
-                    if (blueCones.y == lastBlueCone.y)
+                    Stream &stream = *streams[index];
+                    stream.pending.store(false);
+                    int64_t timestamp{0};
+                    if (pollFrame(*stream.sharedMemory, settings, stream.lastTimestamp, stream.detector.workspace(), timestamp))
                     {
-                        steeringWheelAngle = 0.049;
+                        stream.lastTimestamp = timestamp;
+                        const double steeringWheelAngle{stream.detector.detect()};
+                        results->push(ResultRecord{timestamp, steeringWheelAngle, static_cast<uint32_t>(index)});
                     }
-                    else if (blueCones.y > lastBlueCone.y)
+                    stream.scheduled.store(false);
+                    // A frame that arrived while we were busy queues the stream again behind the others
+                    if (stream.pending.load())
                     {
-                        calculate(left, difference);
+                        schedule(index);
                     }
                 }
-            }
-            // Set the differance to 0
-            difference = 0.0;
-        }
-        else
-        {
-            steeringWheelAngle = 0.049;
-        }
+            });
+    }
+    for (std::thread &waiter : waiters)
+    {
+        waiter.join();
+    }
+    {
+        std::lock_guard<std::mutex> lck(readyMutex);
+        stopping = true;
     }
-    // Set the last blue cone to the current blue cone
-    lastBlueCone = blueCones;
-    // Set the last yellow cone to the current yellow cone
-    lastYellowCone = yellowCones;
+    readyCondition.notify_all();
+    for (std::thread &worker : pool)
+    {
+        worker.join();
+    }
+    closeResults(*results, program);
+    return 0;
 }
 
-void calculate(char direction, double difference)
+std::unique_ptr<ResultWriter> openResults(const OutputSettings &output, const std::vector<std::string> &names, cluon::OD4Session &od4, StageProfiler *profiler)
 {
-    int negative = 1;
-    // Check if the direction is right
-    if (direction == right)
+    ResultWriter::Send send;
+    if (output.send)
     {
-        // Check if the steering wheel angle more then 0
-        if (steeringWheelAngle > 0.49)
+        // Sending serializes the request on the heap, so it happens on the writer thread instead of in the frame loop
+        const uint32_t senderStamp{output.senderStamp};
+        send = [&od4, senderStamp, profiler](const ResultRecord &record)
         {
-            // Set the steering wheel angle to 0
-            steeringWheelAngle = 0.49;
-        }
-        negative = -1;
+            sendSteering(od4, record.timestamp, record.steeringWheelAngle, senderStamp + record.stream, profiler);
+        };
     }
-    // Check if the direction is left
-    else if (direction == left)
+    return std::unique_ptr<ResultWriter>(new ResultWriter(output.format, output.path, names, resultCapacity, output.flushBytes, output.flushInterval, send));
+}
+
+void sendSteering(cluon::OD4Session &od4, int64_t timestamp, double steeringWheelAngle, uint32_t senderStamp, StageProfiler *profiler)
+{
+    StageClock clock(profiler);
+    opendlv::proxy::GroundSteeringRequest steering;
+    steering.groundSteering(static_cast<float>(steeringWheelAngle));
+    // The sample time of the frame travels with the request, so a receiver can measure the latency from the camera to itself
+    od4.send(steering, cluon::time::fromMicroseconds(timestamp), senderStamp);
+    clock.lap(STAGE_SEND);
+}
+
+void closeResults(ResultWriter &results, const char *program)
+{
+    results.close();
+    std::clog << program << ": Wrote " << results.written() << " results in " << results.flushes() << " flushes";
+    if (results.dropped() > 0)
     {
-        // Check if the steering wheel angle less then 0
-        if (steeringWheelAngle < -0.49)
-        {
-            // Set the steering wheel angle to 0
-            steeringWheelAngle = -0.49;
-        }
-        negative = 1;
+        std::clog << " and dropped " << results.dropped() << " because the writer fell behind";
     }
-    // based if the differance, create a value that is between -0.29 and 0.29
-    steeringWheelAngle = 0.09 * (1 + difference) * negative;
-    // check if the steering wheel angle is more then 0.29
-    if (steeringWheelAngle > magicNumber)
+    std::clog << "." << std::endl;
+}
+
+void reportFrame(const VisionSettings &settings, FrameStats &stats, const ResultWriter &results, int64_t timestamp, uint32_t dropped, bool print, const char *name)
+{
+    const int64_t now{cluon::time::toMicroseconds(cluon::time::now())};
+    if (settings.profiler != nullptr)
     {
-        // Set the steering wheel angle to 0.29
-        steeringWheelAngle = magicNumber;
-    } // check if the steering wheel angle is less then -0.29
-    else if (steeringWheelAngle < -(magicNumber))
+        settings.profiler->record(STAGE_SAMPLE_TO_OUTPUT, (now > timestamp) ? static_cast<uint64_t>(now - timestamp) * 1000 : 0);
+        settings.profiler->dumpIfDue(std::clog);
+    }
+    if (stats.add(timestamp, now, dropped) && print)
     {
-        // Set the steering wheel angle to -0.29
-        steeringWheelAngle = -(magicNumber);
+        const FrameStats::Window &window = stats.lastWindow();
+        std::clog << name << ": " << window.processed << " frames processed, " << window.dropped << " dropped ("
+                  << static_cast<double>(window.dropped) / static_cast<double>(window.processed) << " dropped per processed frame), max latency "
+                  << static_cast<double>(window.maxLatency) / 1000.0 << " ms, " << results.dropped() << " results dropped by the writer so far." << std::endl;
     }
 }
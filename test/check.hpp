@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <iostream>
+
+// Minimal assertions for the tests: a failed CHECK prints the condition and its location and the test returns
+// checkResult() from main, which is 1 once any CHECK failed
+#define CHECK(condition) checkCondition((condition), #condition, __FILE__, __LINE__)
+
+inline int &checkFailures()
+{
+    static int failures{0};
+    return failures;
+}
+
+inline bool checkCondition(bool condition, const char *text, const char *file, int line)
+{
+    if (!condition)
+    {
+        std::cerr << file << ":" << line << ": CHECK(" << text << ") failed." << std::endl;
+        checkFailures()++;
+    }
+    return condition;
+}
+
+inline int checkResult()
+{
+    if (checkFailures() > 0)
+    {
+        std::cerr << checkFailures() << " checks failed." << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+#endif
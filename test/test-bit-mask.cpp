@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Checks the packed masks of --denoise=open against the byte masks they replace: the opening against
+// cv::morphologyEx(MORPH_OPEN) with a 3x3 square and the blobs of the packed mask against the blobs of the same mask
+// as bytes, for every kernel set the CPU supports
+
+#include "bit-mask.hpp"
+#include "blob-extractor.hpp"
+#include "check.hpp"
+#include "cpu-dispatch.hpp"
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+// Random mask of specks and boxes, so the opening both removes and keeps pixels
+cv::Mat randomMask(std::mt19937 &generator, int width, int height)
+{
+    cv::Mat mask(height, width, CV_8UC1);
+    std::uniform_int_distribution<int> percent(0, 99);
+    for (int y = 0; y < height; y++)
+    {
+        uint8_t *row = mask.ptr<uint8_t>(y);
+        for (int x = 0; x < width; x++)
+        {
+            row[x] = (percent(generator) < 5) ? 255 : 0;
+        }
+    }
+    std::uniform_int_distribution<int> boxes(1, 6);
+    for (int i = boxes(generator); i > 0; i--)
+    {
+        const int x{std::uniform_int_distribution<int>(0, width - 1)(generator)};
+        const int y{std::uniform_int_distribution<int>(0, height - 1)(generator)};
+        const int w{std::uniform_int_distribution<int>(1, width - x)(generator)};
+        const int h{std::uniform_int_distribution<int>(1, height - y)(generator)};
+        for (int row = y; row < y + h; row++)
+        {
+            for (int column = x; column < x + w; column++)
+            {
+                mask.ptr<uint8_t>(row)[column] = 255;
+            }
+        }
+    }
+    return mask;
+}
+
+bool sameMask(const cv::Mat &expected, const cv::Mat &actual)
+{
+    cv::Mat difference;
+    cv::bitwise_xor(expected, actual, difference);
+    return cv::countNonZero(difference) == 0;
+}
+
+bool sameBlobs(const std::vector<Blob> &expected, const std::vector<Blob> &actual)
+{
+    if (expected.size() != actual.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        if ((expected[i].boundingBox != actual[i].boundingBox) || (expected[i].area != actual[i].area) || (std::fabs(expected[i].centroid.x - actual[i].centroid.x) > 1e-3f) ||
+            (std::fabs(expected[i].centroid.y - actual[i].centroid.y) > 1e-3f))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+int32_t main()
+{
+    const cv::Mat square = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
+    for (KernelSet set : {KERNELS_SCALAR, KERNELS_SSE41, KERNELS_AVX2})
+    {
+        if (!kernelSetSupported(set))
+        {
+            continue;
+        }
+        selectKernels(set);
+        std::cout << kernelSetName(set) << std::endl;
+
+        // Widths around the word and vector sizes, and the region of interest of the microservice
+        std::mt19937 generator{42};
+        BitMask bits;
+        BitMask scratch;
+        BlobExtractor bitBlobs;
+        BlobExtractor byteBlobs;
+        cv::Mat unpacked;
+        cv::Mat opened;
+        for (int width : {1, 7, 63, 64, 65, 130, 255, 257, 640})
+        {
+            for (int height : {1, 2, 5, 100})
+            {
+                const cv::Mat mask = randomMask(generator, width, height);
+
+                bits.pack(mask);
+                bits.unpack(unpacked);
+                CHECK(sameMask(mask, unpacked));
+
+                bits.open(scratch);
+                bits.unpack(unpacked);
+                cv::morphologyEx(mask, opened, cv::MORPH_OPEN, square);
+                CHECK(sameMask(opened, unpacked));
+
+                const cv::Point offset(3, 5);
+                CHECK(sameBlobs(byteBlobs.extract(opened, offset), bitBlobs.extract(bits, offset)));
+                CHECK(bits.moments().area == static_cast<uint64_t>(cv::countNonZero(opened)));
+            }
+        }
+    }
+    return checkResult();
+}
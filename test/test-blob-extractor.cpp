@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Checks BlobExtractor against the cv::findContours(RETR_EXTERNAL) + cv::boundingRect calls it replaced in getCones():
+// the same boxes in the same order, since the last cone-sized blob wins. The other detector tests use BlobExtractor as
+// their reference, so this one compares it with OpenCV itself.
+
+#include "bit-mask.hpp"
+#include "blob-extractor.hpp"
+#include "check.hpp"
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+void fill(cv::Mat &mask, int x, int y, int width, int height, uint8_t value)
+{
+    for (int row = y; row < y + height; row++)
+    {
+        for (int column = x; column < x + width; column++)
+        {
+            mask.ptr<uint8_t>(row)[column] = value;
+        }
+    }
+}
+
+// Square ring of the given thickness around a hole
+void ring(cv::Mat &mask, int x, int y, int size, int thickness)
+{
+    fill(mask, x, y, size, size, 255);
+    fill(mask, x + thickness, y + thickness, size - 2 * thickness, size - 2 * thickness, 0);
+}
+
+// Boxes of the outer contours of the mask, in the order getCones() iterated over them
+std::vector<cv::Rect> contourBoxes(const cv::Mat &mask)
+{
+    cv::Mat copy = mask.clone();
+    std::vector<std::vector<cv::Point>> contours;
+    cv::findContours(copy, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+    std::vector<cv::Rect> boxes;
+    for (const auto &contour : contours)
+    {
+        boxes.push_back(cv::boundingRect(contour));
+    }
+    return boxes;
+}
+
+std::vector<cv::Rect> blobBoxes(const std::vector<Blob> &blobs)
+{
+    std::vector<cv::Rect> boxes;
+    for (const Blob &blob : blobs)
+    {
+        boxes.push_back(blob.boundingBox);
+    }
+    return boxes;
+}
+
+// Compares the blobs of the byte and the packed mask with the contours; prints the first mismatch of a case
+bool sameAsContours(const cv::Mat &mask, const char *name)
+{
+    static BlobExtractor extractor;
+    static BitMask bits;
+    const std::vector<cv::Rect> expected = contourBoxes(mask);
+    const std::vector<cv::Rect> fromBytes = blobBoxes(extractor.extract(mask));
+    bits.pack(mask);
+    const std::vector<cv::Rect> fromBits = blobBoxes(extractor.extract(bits));
+    if ((expected != fromBytes) || (expected != fromBits))
+    {
+        std::cerr << name << " (" << mask.cols << "x" << mask.rows << "): " << expected.size() << " contours, " << fromBytes.size() << " blobs from bytes, "
+                  << fromBits.size() << " blobs from bits" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Specks, lines and boxes; dense masks make components that wind around holes with other components inside
+cv::Mat randomMask(std::mt19937 &generator, int width, int height, int percent)
+{
+    cv::Mat mask(height, width, CV_8UC1);
+    std::uniform_int_distribution<int> hundred(0, 99);
+    for (int y = 0; y < height; y++)
+    {
+        uint8_t *row = mask.ptr<uint8_t>(y);
+        for (int x = 0; x < width; x++)
+        {
+            row[x] = (hundred(generator) < percent) ? 255 : 0;
+        }
+    }
+    std::uniform_int_distribution<int> boxes(0, 4);
+    for (int i = boxes(generator); i > 0; i--)
+    {
+        const int x{std::uniform_int_distribution<int>(0, width - 1)(generator)};
+        const int y{std::uniform_int_distribution<int>(0, height - 1)(generator)};
+        const int w{std::uniform_int_distribution<int>(1, std::min(width - x, 40))(generator)};
+        const int h{std::uniform_int_distribution<int>(1, std::min(height - y, 40))(generator)};
+        fill(mask, x, y, w, h, 255);
+    }
+    return mask;
+}
+
+void testNestedHoles()
+{
+    cv::Mat mask = cv::Mat::zeros(60, 77, CV_8UC1);
+    // Ring in a ring in a ring: only the outermost one is external
+    ring(mask, 2, 2, 50, 3);
+    ring(mask, 9, 9, 36, 2);
+    ring(mask, 15, 15, 24, 2);
+    fill(mask, 25, 25, 4, 4, 255);
+    // A blob in a hole of a blob that is itself in a hole
+    fill(mask, 20, 20, 2, 2, 255);
+    // A ring open towards the border: its inside belongs to the background around the image
+    ring(mask, 55, 10, 22, 2);
+    fill(mask, 75, 14, 2, 6, 0);
+    fill(mask, 62, 17, 5, 5, 255);
+    CHECK(sameAsContours(mask, "nested holes"));
+    CHECK(contourBoxes(mask).size() == 3);
+}
+
+void testBorders()
+{
+    for (int width : {1, 2, 7, 8, 9, 13, 63, 65, 641})
+    {
+        for (int height : {1, 2, 3, 17})
+        {
+            cv::Mat mask = cv::Mat::zeros(height, width, CV_8UC1);
+            // Blobs touching the corners and the middle of every border
+            fill(mask, 0, 0, 1, 1, 255);
+            fill(mask, width - 1, 0, 1, 1, 255);
+            fill(mask, 0, height - 1, 1, 1, 255);
+            fill(mask, width - 1, height - 1, 1, 1, 255);
+            fill(mask, width / 2, 0, 1, 1, 255);
+            fill(mask, width / 2, height - 1, 1, 1, 255);
+            fill(mask, 0, height / 2, 1, 1, 255);
+            fill(mask, width - 1, height / 2, 1, 1, 255);
+            CHECK(sameAsContours(mask, "border pixels"));
+
+            // A frame along all four borders with a blob in its hole
+            fill(mask, 0, 0, width, height, 0);
+            fill(mask, 0, 0, width, height, 255);
+            if ((width > 4) && (height > 4))
+            {
+                fill(mask, 1, 1, width - 2, height - 2, 0);
+                fill(mask, 2, 2, width - 4, height - 4, 255);
+            }
+            CHECK(sameAsContours(mask, "border frame"));
+        }
+    }
+}
+
+void testDiagonals()
+{
+    cv::Mat mask = cv::Mat::zeros(40, 71, CV_8UC1);
+    // Two boxes joined by a chain of single pixels touching at their corners are one blob
+    fill(mask, 2, 2, 5, 5, 255);
+    for (int i = 0; i < 6; i++)
+    {
+        fill(mask, 7 + i, 7 + i, 1, 1, 255);
+    }
+    fill(mask, 13, 13, 6, 4, 255);
+    // A diamond of single pixels: its inside only touches the outside diagonally, so it is a hole and the pixel in
+    // it is not external
+    const int cx{40};
+    const int cy{20};
+    for (int i = 0; i < 6; i++)
+    {
+        fill(mask, cx - 6 + i, cy - i, 1, 1, 255);
+        fill(mask, cx + i, cy - 6 + i, 1, 1, 255);
+        fill(mask, cx + 6 - i, cy + i, 1, 1, 255);
+        fill(mask, cx - i, cy + 6 - i, 1, 1, 255);
+    }
+    fill(mask, cx, cy, 1, 1, 255);
+    // A checkerboard is one blob
+    for (int y = 25; y < 35; y++)
+    {
+        for (int x = 55 + (y % 2); x < 68; x += 2)
+        {
+            fill(mask, x, y, 1, 1, 255);
+        }
+    }
+    CHECK(sameAsContours(mask, "diagonal links"));
+    CHECK(contourBoxes(mask).size() == 3);
+}
+
+void testOrder()
+{
+    // Blobs that share their top row, blobs whose box starts left of an earlier blob, and blobs further down
+    cv::Mat mask = cv::Mat::zeros(30, 50, CV_8UC1);
+    fill(mask, 10, 2, 3, 8, 255);
+    fill(mask, 20, 2, 3, 3, 255);
+    fill(mask, 2, 6, 4, 2, 255);
+    fill(mask, 30, 4, 2, 10, 255);
+    fill(mask, 26, 12, 10, 2, 255);
+    fill(mask, 40, 20, 5, 5, 255);
+    fill(mask, 1, 20, 5, 5, 255);
+    CHECK(sameAsContours(mask, "order"));
+}
+
+// The coarse-to-fine detection extracts the blobs of several windows and sorts them with foundLater(); that has to
+// restore the order of one scan of the whole mask, also for blobs that share their top row but whose boxes start
+// in the other order
+void testScanOrder()
+{
+    cv::Mat mask = cv::Mat::zeros(40, 60, CV_8UC1);
+    // First pixel at x = 20 of row 5, but the box reaches out to x = 4 further down
+    fill(mask, 20, 5, 6, 3, 255);
+    fill(mask, 4, 8, 22, 3, 255);
+    // First pixel at x = 12 of row 5, inside the box of the other blob
+    fill(mask, 12, 5, 3, 2, 255);
+    // The same mirrored further down
+    fill(mask, 30, 20, 6, 3, 255);
+    fill(mask, 30, 23, 22, 3, 255);
+    fill(mask, 45, 20, 3, 2, 255);
+    CHECK(sameAsContours(mask, "scan order"));
+
+    BlobExtractor extractor;
+    const std::vector<Blob> &blobs = extractor.extract(mask);
+    const std::vector<cv::Rect> expected = blobBoxes(blobs);
+    std::vector<Blob> shuffled(blobs.rbegin(), blobs.rend());
+    std::sort(shuffled.begin(), shuffled.end(), foundLater);
+    CHECK(blobBoxes(shuffled) == expected);
+}
+
+void testRandomMasks()
+{
+    std::mt19937 generator{4};
+    for (int width : {1, 5, 8, 9, 15, 16, 17, 63, 64, 65, 100, 257, 640, 641})
+    {
+        for (int height : {1, 2, 7, 100})
+        {
+            for (int percent : {1, 10, 35, 60})
+            {
+                CHECK(sameAsContours(randomMask(generator, width, height, percent), "random"));
+            }
+        }
+    }
+
+    // A window of a larger mask, whose rows are not contiguous and start off the word boundaries
+    const cv::Mat parent = randomMask(generator, 640, 480, 20);
+    CHECK(sameAsContours(parent(cv::Rect(3, 240, 637, 100)), "window"));
+}
+} // namespace
+
+int32_t main()
+{
+    testNestedHoles();
+    testBorders();
+    testDiagonals();
+    testOrder();
+    testScanOrder();
+    testRandomMasks();
+    return checkResult();
+}
@@ -0,0 +1,329 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Checks the zero-copy parsing of OD4 envelopes that the dispatch of OD4Session uses: on valid envelopes
+// extractEnvelopeHeader(), extractEnvelopeView() and FromProtoVisitor::decodeFrom() must agree with the stream-based
+// extractEnvelope() and extractMessage(), and truncated VarInts, lengths that overrun the bytes and unknown wire types
+// must be rejected without reading past the bytes
+
+#include "cluon-complete.hpp"
+#include "opendlv-standard-message-set.hpp"
+
+#include "check.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+void appendVarInt(std::string &bytes, uint64_t value)
+{
+    while (value > 0x7f)
+    {
+        bytes.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<char>(value));
+}
+
+// Key of a field of a Proto-encoded message
+void appendKey(std::string &bytes, uint32_t fieldId, uint8_t wireType)
+{
+    appendVarInt(bytes, (static_cast<uint64_t>(fieldId) << 3) | wireType);
+}
+
+// Put the OD4 header in front of a Proto-encoded Envelope
+std::string withHeader(const std::string &envelope)
+{
+    std::string bytes{static_cast<char>(0x0D), static_cast<char>(0xA4)};
+    bytes.push_back(static_cast<char>(envelope.size() & 0xff));
+    bytes.push_back(static_cast<char>((envelope.size() >> 8) & 0xff));
+    bytes.push_back(static_cast<char>((envelope.size() >> 16) & 0xff));
+    return bytes + envelope;
+}
+
+template <typename T> std::string encode(T &message)
+{
+    cluon::ToProtoVisitor encoder;
+    message.accept(encoder);
+    return encoder.encodedData();
+}
+
+cluon::data::TimeStamp randomTimeStamp(std::mt19937 &generator)
+{
+    cluon::data::TimeStamp timeStamp;
+    timeStamp.seconds(std::uniform_int_distribution<int32_t>(-10, 2000000000)(generator));
+    timeStamp.microseconds(std::uniform_int_distribution<int32_t>(0, 999999)(generator));
+    return timeStamp;
+}
+
+bool sameTimeStamp(const cluon::data::TimeStamp &a, const cluon::data::TimeStamp &b)
+{
+    return (a.seconds() == b.seconds()) && (a.microseconds() == b.microseconds());
+}
+
+// Decode the payload with both paths; the messages must encode to the same bytes
+template <typename T> bool decodesLikeStream(const cluon::data::Envelope &envelope, const char *payload, size_t payloadLength)
+{
+    T expected{cluon::extractMessage<T>(cluon::data::Envelope(envelope))};
+    T actual;
+    cluon::FromProtoVisitor decoder;
+    if (!decoder.decodeFrom(payload, payloadLength, actual))
+    {
+        return false;
+    }
+    return encode(expected) == encode(actual);
+}
+
+// Random message of one of a few types with float, double, string and bytes fields
+std::pair<int32_t, std::string> randomPayload(std::mt19937 &generator)
+{
+    std::uniform_real_distribution<double> real(-1000.0, 1000.0);
+    switch (std::uniform_int_distribution<int>(0, 2)(generator))
+    {
+        case 0:
+        {
+            opendlv::proxy::GroundSteeringRequest message;
+            message.groundSteering(static_cast<float>(real(generator)));
+            return std::make_pair(opendlv::proxy::GroundSteeringRequest::ID(), encode(message));
+        }
+        case 1:
+        {
+            opendlv::proxy::GeodeticWgs84Reading message;
+            message.latitude(real(generator)).longitude(real(generator));
+            return std::make_pair(opendlv::proxy::GeodeticWgs84Reading::ID(), encode(message));
+        }
+        default:
+        {
+            std::string data(std::uniform_int_distribution<size_t>(0, 300)(generator), '\0');
+            for (char &c : data)
+            {
+                c = static_cast<char>(std::uniform_int_distribution<int>(0, 255)(generator));
+            }
+            opendlv::proxy::ImageReading message;
+            message.fourcc("h264").width(std::uniform_int_distribution<uint32_t>(0, 4000)(generator)).height(480).data(data);
+            return std::make_pair(opendlv::proxy::ImageReading::ID(), encode(message));
+        }
+    }
+}
+
+void testVarInts()
+{
+    for (uint64_t value : {uint64_t{0}, uint64_t{1}, uint64_t{127}, uint64_t{128}, uint64_t{300}, uint64_t{1} << 32, UINT64_MAX})
+    {
+        std::string bytes;
+        appendVarInt(bytes, value);
+        const char *pos{bytes.data()};
+        uint64_t decoded{0};
+        CHECK(cluon::readProtoVarInt(pos, bytes.data() + bytes.size(), decoded));
+        CHECK(decoded == value);
+        CHECK(pos == bytes.data() + bytes.size());
+
+        // Every byte but the last one announces another byte
+        pos = bytes.data();
+        CHECK(!cluon::readProtoVarInt(pos, bytes.data() + bytes.size() - 1, decoded));
+        CHECK(pos <= bytes.data() + bytes.size() - 1);
+    }
+
+    // More than the 10 bytes of a 64-bit value
+    const std::string tooLong(11, static_cast<char>(0x80));
+    const char *pos{tooLong.data()};
+    uint64_t decoded{0};
+    CHECK(!cluon::readProtoVarInt(pos, tooLong.data() + tooLong.size(), decoded));
+}
+
+void testValidEnvelopes()
+{
+    std::mt19937 generator{42};
+    for (int i = 0; i < 1000; i++)
+    {
+        const std::pair<int32_t, std::string> payload{randomPayload(generator)};
+        cluon::data::Envelope envelope;
+        envelope.dataType(payload.first)
+            .serializedData(payload.second)
+            .sent(randomTimeStamp(generator))
+            .received(randomTimeStamp(generator))
+            .sampleTimeStamp(randomTimeStamp(generator))
+            .senderStamp(std::uniform_int_distribution<uint32_t>(0, UINT32_MAX)(generator));
+        const std::string bytes{cluon::serializeEnvelope(cluon::data::Envelope(envelope))};
+
+        std::stringstream stream(bytes);
+        const std::pair<bool, cluon::data::Envelope> expected{cluon::extractEnvelope(stream)};
+        CHECK(expected.first);
+        const cluon::data::Envelope &reference = expected.second;
+
+        int32_t dataType{0};
+        uint32_t senderStamp{0};
+        CHECK(cluon::extractEnvelopeHeader(bytes.data(), bytes.size(), dataType, senderStamp));
+        CHECK(dataType == reference.dataType());
+        CHECK(senderStamp == reference.senderStamp());
+
+        cluon::EnvelopeMeta meta;
+        const char *data{nullptr};
+        size_t length{0};
+        if (!CHECK(cluon::extractEnvelopeView(bytes.data(), bytes.size(), meta, data, length)))
+        {
+            continue;
+        }
+        CHECK(meta.dataType == reference.dataType());
+        CHECK(meta.senderStamp == reference.senderStamp());
+        CHECK(sameTimeStamp(meta.sent, reference.sent()));
+        CHECK(sameTimeStamp(meta.received, reference.received()));
+        CHECK(sameTimeStamp(meta.sampleTimeStamp, reference.sampleTimeStamp()));
+        CHECK((data >= bytes.data()) && (data + length <= bytes.data() + bytes.size()));
+        CHECK(std::string(data, length) == reference.serializedData());
+
+        if (opendlv::proxy::GroundSteeringRequest::ID() == payload.first)
+        {
+            CHECK(decodesLikeStream<opendlv::proxy::GroundSteeringRequest>(reference, data, length));
+        }
+        else if (opendlv::proxy::GeodeticWgs84Reading::ID() == payload.first)
+        {
+            CHECK(decodesLikeStream<opendlv::proxy::GeodeticWgs84Reading>(reference, data, length));
+        }
+        else
+        {
+            CHECK(decodesLikeStream<opendlv::proxy::ImageReading>(reference, data, length));
+        }
+    }
+}
+
+// Neither the header nor the view of the bytes may be extracted
+bool rejected(const std::string &bytes)
+{
+    int32_t dataType{0};
+    uint32_t senderStamp{0};
+    cluon::EnvelopeMeta meta;
+    const char *data{nullptr};
+    size_t length{0};
+    return !cluon::extractEnvelopeHeader(bytes.data(), bytes.size(), dataType, senderStamp) && !cluon::extractEnvelopeView(bytes.data(), bytes.size(), meta, data, length);
+}
+
+void testMalformedEnvelopes()
+{
+    opendlv::proxy::GroundSteeringRequest message;
+    message.groundSteering(0.25f);
+    cluon::data::Envelope envelope;
+    envelope.dataType(opendlv::proxy::GroundSteeringRequest::ID()).serializedData(encode(message)).senderStamp(1);
+    const std::string valid{cluon::serializeEnvelope(std::move(envelope))};
+
+    // Datagrams cut short of the length in the OD4 header, and a wrong header
+    for (size_t length = 0; length < valid.size(); length++)
+    {
+        CHECK(rejected(valid.substr(0, length)));
+    }
+    std::string wrongMagic{valid};
+    wrongMagic[1] = 0x42;
+    CHECK(rejected(wrongMagic));
+    int32_t dataType{0};
+    uint32_t senderStamp{0};
+    CHECK(!cluon::extractEnvelopeHeader(nullptr, 0, dataType, senderStamp));
+
+    // Envelopes whose header matches their length but whose fields do not
+    std::string truncatedKey;
+    appendKey(truncatedKey, 1, 0);
+    appendVarInt(truncatedKey, 2180);
+    truncatedKey.push_back(static_cast<char>(0x80));
+    CHECK(rejected(withHeader(truncatedKey)));
+
+    std::string truncatedValue;
+    appendKey(truncatedValue, 6, 0);
+    truncatedValue.push_back(static_cast<char>(0xff));
+    CHECK(rejected(withHeader(truncatedValue)));
+
+    std::string overrun;
+    appendKey(overrun, 2, 2);
+    appendVarInt(overrun, 100);
+    overrun += "abc";
+    CHECK(rejected(withHeader(overrun)));
+
+    std::string hugeLength;
+    appendKey(hugeLength, 2, 2);
+    appendVarInt(hugeLength, UINT64_MAX);
+    hugeLength += "abc";
+    CHECK(rejected(withHeader(hugeLength)));
+
+    std::string shortDouble;
+    appendKey(shortDouble, 7, 1);
+    shortDouble += "abcd";
+    CHECK(rejected(withHeader(shortDouble)));
+
+    // Start group, end group and the unassigned wire types
+    for (uint8_t wireType : {uint8_t{3}, uint8_t{4}, uint8_t{6}, uint8_t{7}})
+    {
+        std::string unknown;
+        appendKey(unknown, 1, 0);
+        appendVarInt(unknown, 2180);
+        appendKey(unknown, 9, wireType);
+        unknown += "abcdefgh";
+        CHECK(rejected(withHeader(unknown)));
+    }
+}
+
+void testMalformedPayloads()
+{
+    opendlv::proxy::ImageReading message;
+    message.fourcc("h264").width(640).height(480).data(std::string(100, 'x'));
+    const std::string valid{encode(message)};
+
+    // A payload cut inside of its last field
+    opendlv::proxy::ImageReading decoded;
+    cluon::FromProtoVisitor decoder;
+    CHECK(!decoder.decodeFrom(valid.data(), valid.size() - 1, decoded));
+    CHECK(!decoder.decodeFrom(nullptr, 1, decoded));
+    CHECK(decoder.decodeFrom(nullptr, 0, decoded));
+
+    std::string overrun;
+    appendKey(overrun, 1, 2);
+    appendVarInt(overrun, 5);
+    overrun += "h26";
+    CHECK(!decoder.decodeFrom(overrun.data(), overrun.size(), decoded));
+
+    std::string truncatedValue;
+    appendKey(truncatedValue, 2, 0);
+    truncatedValue.push_back(static_cast<char>(0x80));
+    CHECK(!decoder.decodeFrom(truncatedValue.data(), truncatedValue.size(), decoded));
+
+    std::string shortFloat;
+    appendKey(shortFloat, 1, 5);
+    shortFloat += "ab";
+    opendlv::proxy::GroundSteeringRequest request;
+    CHECK(!decoder.decodeFrom(shortFloat.data(), shortFloat.size(), request));
+
+    for (uint8_t wireType : {uint8_t{3}, uint8_t{4}, uint8_t{6}, uint8_t{7}})
+    {
+        std::string unknown;
+        appendKey(unknown, 2, wireType);
+        unknown += "abcdefgh";
+        CHECK(!decoder.decodeFrom(unknown.data(), unknown.size(), decoded));
+    }
+}
+} // namespace
+
+int32_t main()
+{
+    testVarInts();
+    testValidEnvelopes();
+    testMalformedEnvelopes();
+    testMalformedPayloads();
+    return checkResult();
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Runs the serial frame loop of the microservice on synthetic frames and checks that no frame after the warm-up
+// allocates, for every combination of the detection paths and both schedules
+
+#include "cluon-complete.hpp"
+
+#include "allocation-counter.hpp"
+#include "check.hpp"
+#include "cone-detection.hpp"
+#include "cpu-dispatch.hpp"
+#include "frame-ingest.hpp"
+#include "frame-stats.hpp"
+#include "result-writer.hpp"
+
+#include <opencv2/core/core.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const uint32_t width = 640;
+const uint32_t height = 480;
+// Same warm-up as the microservice
+const uint64_t warmUpFrames = 10;
+const uint64_t checkedFrames = 50;
+
+// Fill a box of the BGRA frame with one color
+void fillBox(uint8_t *frame, int x, int y, int w, int h, uint8_t b, uint8_t g, uint8_t r)
+{
+    for (int row = y; row < y + h; row++)
+    {
+        uint8_t *pixel = frame + (static_cast<size_t>(row) * width + static_cast<size_t>(x)) * 4;
+        for (int column = 0; column < w; column++, pixel += 4)
+        {
+            pixel[0] = b;
+            pixel[1] = g;
+            pixel[2] = r;
+            pixel[3] = 255;
+        }
+    }
+}
+
+// Gray frame with a blue cone on the left and a yellow cone on the right of the region of interest that move a bit
+// from frame to frame
+void drawFrame(uint8_t *frame, uint64_t index)
+{
+    std::memset(frame, 90, static_cast<size_t>(width) * height * 4);
+    const int shift{static_cast<int>(index % 8) * 3};
+    fillBox(frame, 100 + shift, 270, 30, 40, 200, 80, 30);
+    fillBox(frame, 500 - shift, 280, 30, 40, 40, 150, 170);
+}
+
+struct Variant
+{
+    const char *name;
+    bool inplace;
+    bool lut;
+    bool tracking;
+    int coarseScale;
+    bool openMasks;
+    bool projection;
+    bool fusedBlur;
+};
+
+// Run the frames through ingest, detection and output like the serial loop and return the most allocations of a
+// frame after the warm-up
+uint64_t runSerialLoop(cluon::SharedMemory &producer, cluon::SharedMemory &consumer, const Variant &variant, bool latestFrameWins, const ColorLut &lut)
+{
+    const cv::Rect frame(0, 0, static_cast<int>(width), static_cast<int>(height));
+    const cv::Rect region = roi & frame;
+    const cv::Rect ingestRegion = cv::Rect(region.x, region.y - blurMargin, region.width, region.height + 2 * blurMargin) & frame;
+    const VisionSettings settings{width, height, region, ingestRegion, variant.inplace, latestFrameWins, toHsvRange(blueLow, blueHigh), toHsvRange(yellowLow, yellowHigh),
+                                  variant.lut ? &lut : nullptr, false, nullptr, variant.tracking, 5, variant.coarseScale, variant.openMasks, variant.projection,
+                                  variant.fusedBlur};
+    ConeDetector detector(settings);
+    ResultWriter results(RESULT_TEXT, "/dev/null", std::vector<std::string>{"test"}, 1024, 4096, std::chrono::milliseconds(100), ResultWriter::Send());
+    DropDetector dropDetector(0);
+    FrameStats stats;
+
+    // The producer writes the next frame like the camera would once the last one was taken, and keeps notifying, as
+    // the default schedule only wakes up for notifications that come while it waits
+    std::atomic<uint64_t> taken{0};
+    std::atomic<bool> running{true};
+    std::thread camera([&producer, &taken, &running]() {
+        uint64_t written{0};
+        while (running.load())
+        {
+            if (written <= taken.load())
+            {
+                written++;
+                producer.lock();
+                drawFrame(reinterpret_cast<uint8_t *>(producer.data()), written);
+                producer.setTimeStamp(cluon::time::fromMicroseconds(static_cast<int64_t>(written) * 33333));
+                producer.unlock();
+            }
+            producer.notifyAll();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    int64_t lastTimestamp{0};
+    uint64_t worst{0};
+    for (uint64_t index = 1; index <= warmUpFrames + checkedFrames; index++)
+    {
+        const uint64_t allocationsBefore{threadAllocations()};
+        const int64_t timestamp{ingestFrame(consumer, settings, lastTimestamp, detector.workspace())};
+        taken.store(index);
+        const uint32_t dropped{dropDetector.update(timestamp)};
+        lastTimestamp = timestamp;
+        const double steeringWheelAngle{detector.detect()};
+        results.push(ResultRecord{timestamp, steeringWheelAngle, 0});
+        stats.add(timestamp, timestamp, dropped);
+        const uint64_t allocations{threadAllocations() - allocationsBefore};
+        if (index > warmUpFrames)
+        {
+            worst = std::max(worst, allocations);
+        }
+    }
+    running.store(false);
+    camera.join();
+    results.close();
+    CHECK(results.written() == warmUpFrames + checkedFrames);
+    return worst;
+}
+} // namespace
+
+int32_t main()
+{
+    selectKernels(bestKernelSet());
+    const std::string name{"/test-frame-allocations"};
+    cluon::SharedMemory producer{name, width * height * 4};
+    cluon::SharedMemory consumer{name};
+    if (!CHECK(producer.valid() && consumer.valid()))
+    {
+        return checkResult();
+    }
+    const ColorLut lut(toHsvRange(blueLow, blueHigh), toHsvRange(yellowLow, yellowHigh), 6);
+
+    const std::vector<Variant> variants{
+        {"copy", false, false, false, 1, false, false, false},
+        {"inplace", true, false, false, 1, false, false, false},
+        {"lut", false, true, false, 1, false, false, false},
+        {"tracking", false, false, true, 1, false, false, false},
+        {"coarse", false, false, false, 2, false, false, false},
+        {"open", false, false, false, 1, true, false, false},
+        {"projection", false, false, false, 1, false, true, false},
+        {"fused", false, false, false, 1, false, false, true},
+    };
+    for (bool latestFrameWins : {false, true})
+    {
+        for (const Variant &variant : variants)
+        {
+            const uint64_t worst{runSerialLoop(producer, consumer, variant, latestFrameWins, lut)};
+            std::clog << variant.name << (latestFrameWins ? ", --schedule=latest" : ", --schedule=wait") << ": at most " << worst
+                      << " heap allocations per frame after the warm-up." << std::endl;
+            CHECK(0 == worst);
+        }
+    }
+    return checkResult();
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Checks --blur=fused against the separate passes it replaces: the masks of FusedSegmenter against SeparableBlur
+// followed by hsvThreshold() or the lookup table, for every kernel set the CPU supports. The fused blur rounds after
+// the horizontal pass, so only the few pixels right at a threshold may be classified differently. The separate passes
+// in turn give the masks of the OpenCV calls they replaced, cv::GaussianBlur, cv::cvtColor and cv::inRange, so the
+// fused masks are held to the same tolerance against those.
+
+#include "check.hpp"
+#include "color-lut.hpp"
+#include "cpu-dispatch.hpp"
+#include "fused-segmentation.hpp"
+#include "hsv-threshold.hpp"
+#include "separable-blur.hpp"
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+
+namespace
+{
+const int width = 640;
+const int height = 100;
+// Share of the mask pixels that may differ
+const double tolerance = 0.002;
+
+// Same thresholds as the microservice
+const cv::Scalar blueLow = cv::Scalar(100, 50, 30);
+const cv::Scalar blueHigh = cv::Scalar(120, 255, 255);
+const cv::Scalar yellowLow = cv::Scalar(17, 60, 70);
+const cv::Scalar yellowHigh = cv::Scalar(40, 200, 200);
+
+// Share of the pixels of two pairs of masks that differ
+double mismatches(const cv::Mat &expectedFirst, const cv::Mat &expectedSecond, const cv::Mat &first, const cv::Mat &second)
+{
+    cv::Mat difference;
+    cv::bitwise_xor(expectedFirst, first, difference);
+    int differing{cv::countNonZero(difference)};
+    cv::bitwise_xor(expectedSecond, second, difference);
+    differing += cv::countNonZero(difference);
+    return differing / (2.0 * static_cast<double>(first.total()));
+}
+} // namespace
+
+int32_t main()
+{
+    const HsvRange blueRange = toHsvRange(blueLow, blueHigh);
+    const HsvRange yellowRange = toHsvRange(yellowLow, yellowHigh);
+    const ColorLut lut(blueRange, yellowRange, 6);
+
+    // Noisy blue, yellow and gray patches, with the rows above and below the region that the microservice copies
+    // for the blur
+    cv::Mat ingest(height + 2 * SeparableBlur::RADIUS, width, CV_8UC4);
+    const uint8_t patches[3][3] = {{200, 80, 40}, {30, 200, 230}, {90, 90, 90}};
+    std::mt19937 generator{42};
+    std::uniform_int_distribution<int> noise(-40, 40);
+    for (int y = 0; y < ingest.rows; y++)
+    {
+        uint8_t *row = ingest.ptr<uint8_t>(y);
+        for (int x = 0; x < ingest.cols; x++)
+        {
+            const uint8_t *patch = patches[(x / 24 + y / 16) % 3];
+            for (int c = 0; c < 3; c++)
+            {
+                row[4 * x + c] = cv::saturate_cast<uint8_t>(patch[c] + noise(generator));
+            }
+            row[4 * x + 3] = 255;
+        }
+    }
+    const cv::Mat region = ingest(cv::Rect(0, SeparableBlur::RADIUS, width, height));
+
+    // The exact separate passes of the portable kernels are the reference
+    cv::Mat blurred(region.size(), CV_8UC4);
+    cv::Mat expectedBlue(region.size(), CV_8UC1), expectedYellow(region.size(), CV_8UC1);
+    cv::Mat expectedLutBlue(region.size(), CV_8UC1), expectedLutYellow(region.size(), CV_8UC1);
+    SeparableBlur blur;
+    selectKernels(KERNELS_SCALAR);
+    blur.apply(region, blurred);
+    hsvThreshold(blurred, blueRange, yellowRange, expectedBlue, expectedYellow);
+    lut.classify(blurred, expectedLutBlue, expectedLutYellow);
+    CHECK(cv::countNonZero(expectedBlue) > 0);
+    CHECK(cv::countNonZero(expectedYellow) > 0);
+
+    // The calls the separate passes replaced; the blur reads the rows above and below the region from the ingest
+    cv::Mat opencvBlurred, hsv, opencvBlue, opencvYellow;
+    cv::GaussianBlur(region, opencvBlurred, cv::Size(SeparableBlur::KERNEL_SIZE, SeparableBlur::KERNEL_SIZE), 1.0);
+    cv::cvtColor(opencvBlurred, hsv, cv::COLOR_BGR2HSV);
+    cv::inRange(hsv, blueLow, blueHigh, opencvBlue);
+    cv::inRange(hsv, yellowLow, yellowHigh, opencvYellow);
+    CHECK(mismatches(opencvBlue, opencvYellow, expectedBlue, expectedYellow) <= 0.0);
+
+    // The vector kernels round like the portable ones, so every kernel set gives the masks of the portable kernels
+    cv::Mat scalarBlue(region.size(), CV_8UC1), scalarYellow(region.size(), CV_8UC1);
+    cv::Mat blueMask(region.size(), CV_8UC1), yellowMask(region.size(), CV_8UC1);
+    FusedSegmenter segmenter;
+    segmenter.apply(region, blueRange, yellowRange, nullptr, scalarBlue, scalarYellow);
+    for (KernelSet set : {KERNELS_SCALAR, KERNELS_SSE41, KERNELS_AVX2})
+    {
+        if (!kernelSetSupported(set))
+        {
+            continue;
+        }
+        selectKernels(set);
+
+        segmenter.apply(region, blueRange, yellowRange, nullptr, blueMask, yellowMask);
+        const double differing{mismatches(expectedBlue, expectedYellow, blueMask, yellowMask)};
+        const double differingOpencv{mismatches(opencvBlue, opencvYellow, blueMask, yellowMask)};
+        CHECK(mismatches(scalarBlue, scalarYellow, blueMask, yellowMask) <= 0.0);
+        segmenter.apply(region, blueRange, yellowRange, &lut, blueMask, yellowMask);
+        const double differingLut{mismatches(expectedLutBlue, expectedLutYellow, blueMask, yellowMask)};
+        std::cout << kernelSetName(set) << ": " << 100.0 * differing << "% of the mask pixels differ, " << 100.0 * differingOpencv << "% from OpenCV, " << 100.0 * differingLut
+                  << "% with the lookup table" << std::endl;
+        CHECK(differing <= tolerance);
+        CHECK(differingOpencv <= tolerance);
+        CHECK(differingLut <= tolerance);
+    }
+    return checkResult();
+}
@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Checks the overflow policies of the pipeline between the OD4 receiver and the delegates: a delegate that is held up
+// lets the ring fill, and the counters must report what add() did with the entries that did not fit. A long run with
+// a small ring checks that no notification is lost while the delegate thread goes to sleep.
+
+#include "cluon-complete.hpp"
+
+#include "check.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const size_t capacity = 4;
+
+// Delegate that records the entries and holds up the delegate thread at the first one until it is released
+class HeldDelegate
+{
+   public:
+    HeldDelegate()
+        : m_mutex()
+        , m_condition()
+        , m_held(false)
+        , m_released(false)
+        , m_entries()
+        , m_count(0)
+    {
+    }
+
+    void operator()(int &&entry)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_entries.push_back(entry);
+        if (!m_released)
+        {
+            m_held = true;
+            m_condition.notify_all();
+            m_condition.wait(lock, [this]() { return m_released; });
+        }
+        m_count.store(m_entries.size());
+    }
+
+    // Wait until the delegate thread is held up by the first entry
+    bool waitUntilHeld()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_condition.wait_for(lock, std::chrono::seconds(5), [this]() { return m_held; });
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_released = true;
+        m_condition.notify_all();
+    }
+
+    // Wait until count entries have been processed and return them
+    std::vector<int> entries(size_t count)
+    {
+        const auto deadline{std::chrono::steady_clock::now() + std::chrono::seconds(5)};
+        while ((m_count.load() < count) && (std::chrono::steady_clock::now() < deadline))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries;
+    }
+
+   private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_held;
+    bool m_released;
+    std::vector<int> m_entries;
+    std::atomic<size_t> m_count;
+};
+
+// Hold up the delegate at entry 0 and fill the ring with entries 1 to capacity
+void fill(cluon::NotifyingPipeline<int> &pipeline, HeldDelegate &delegate)
+{
+    pipeline.add(0);
+    pipeline.notifyAll();
+    CHECK(delegate.waitUntilHeld());
+    for (int i = 1; i <= static_cast<int>(capacity); i++)
+    {
+        // add() hands back an older entry in place of the one it takes
+        int entry{i};
+        pipeline.add(std::move(entry));
+    }
+}
+
+void testDropNewest()
+{
+    HeldDelegate delegate;
+    cluon::NotifyingPipeline<int> pipeline([&delegate](int &&entry) { delegate(std::move(entry)); }, capacity, cluon::PipelineOverflowPolicy::DROP_NEWEST);
+    fill(pipeline, delegate);
+    pipeline.add(5);
+    pipeline.add(6);
+    delegate.release();
+    pipeline.notifyAll();
+
+    CHECK(delegate.entries(5) == std::vector<int>({0, 1, 2, 3, 4}));
+    const cluon::PipelineStatistics statistics = pipeline.statistics();
+    CHECK(statistics.added == 5);
+    CHECK(statistics.dropped == 2);
+    CHECK(statistics.blocked == 0);
+    CHECK(statistics.peakSize == capacity);
+}
+
+void testDropOldest()
+{
+    HeldDelegate delegate;
+    cluon::NotifyingPipeline<int> pipeline([&delegate](int &&entry) { delegate(std::move(entry)); }, capacity, cluon::PipelineOverflowPolicy::DROP_OLDEST);
+    fill(pipeline, delegate);
+    pipeline.add(5);
+    pipeline.add(6);
+    delegate.release();
+    pipeline.notifyAll();
+
+    CHECK(delegate.entries(5) == std::vector<int>({0, 3, 4, 5, 6}));
+    const cluon::PipelineStatistics statistics = pipeline.statistics();
+    CHECK(statistics.added == 7);
+    CHECK(statistics.dropped == 2);
+    CHECK(statistics.blocked == 0);
+    CHECK(statistics.peakSize == capacity);
+}
+
+void testBlock()
+{
+    HeldDelegate delegate;
+    cluon::NotifyingPipeline<int> pipeline([&delegate](int &&entry) { delegate(std::move(entry)); }, capacity, cluon::PipelineOverflowPolicy::BLOCK);
+    fill(pipeline, delegate);
+    // add() returns once the delegate has made room
+    std::thread producer([&pipeline]() {
+        pipeline.add(5);
+        pipeline.notifyAll();
+    });
+    const auto deadline{std::chrono::steady_clock::now() + std::chrono::seconds(5)};
+    while ((pipeline.statistics().blocked == 0) && (std::chrono::steady_clock::now() < deadline))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(pipeline.statistics().blocked == 1);
+    delegate.release();
+    producer.join();
+
+    CHECK(delegate.entries(6) == std::vector<int>({0, 1, 2, 3, 4, 5}));
+    const cluon::PipelineStatistics statistics = pipeline.statistics();
+    CHECK(statistics.added == 6);
+    CHECK(statistics.dropped == 0);
+    CHECK(statistics.blocked == 1);
+    CHECK(statistics.peakSize == capacity);
+}
+
+// Every entry must arrive in order while the delegate thread keeps going to sleep and being woken up
+void testWakeUps()
+{
+    const uint64_t entries{200000};
+    std::atomic<uint64_t> processed{0};
+    std::atomic<bool> ordered{true};
+    cluon::NotifyingPipeline<uint64_t> pipeline(
+        [&processed, &ordered](uint64_t &&entry) {
+            if (entry != processed.load(std::memory_order_relaxed))
+            {
+                ordered.store(false);
+            }
+            processed.fetch_add(1, std::memory_order_release);
+        },
+        capacity,
+        cluon::PipelineOverflowPolicy::BLOCK);
+    for (uint64_t i = 0; i < entries; i++)
+    {
+        uint64_t entry{i};
+        pipeline.add(std::move(entry));
+        pipeline.notifyAll();
+    }
+    const auto deadline{std::chrono::steady_clock::now() + std::chrono::seconds(10)};
+    while ((processed.load(std::memory_order_acquire) < entries) && (std::chrono::steady_clock::now() < deadline))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(processed.load() == entries);
+    CHECK(ordered.load());
+    CHECK(pipeline.statistics().dropped == 0);
+}
+} // namespace
+
+int32_t main()
+{
+    testDropNewest();
+    testDropOldest();
+    testBlock();
+    testWakeUps();
+    return checkResult();
+}
@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Checks the typed data triggers of OD4Session: every delegate decodes into its own message, and fields that are
+// missing from a payload must come out with their defaults instead of the values of the previous message; delegates
+// can be set while other threads dispatch, and replaced delegates are released once no dispatch uses them anymore
+
+#include "cluon-complete.hpp"
+#include "opendlv-standard-message-set.hpp"
+
+#include "check.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+// Conference that no other test or microservice uses; the test only calls dispatch()
+const uint16_t cid = 251;
+const uint32_t senderStamp = 7;
+
+template <typename T> std::string encode(T &message)
+{
+    cluon::ToProtoVisitor encoder;
+    message.accept(encoder);
+    return encoder.encodedData();
+}
+
+template <typename T> std::string datagram(const std::string &payload)
+{
+    cluon::data::Envelope envelope;
+    envelope.dataType(static_cast<int32_t>(T::ID())).serializedData(payload).senderStamp(senderStamp);
+    return cluon::serializeEnvelope(std::move(envelope));
+}
+
+template <typename T> std::string datagram(T &message)
+{
+    return datagram<T>(encode(message));
+}
+
+// Payload with only the given double field
+std::string doubleField(uint32_t fieldId, double value)
+{
+    std::string bytes(1, static_cast<char>((fieldId << 3) | 1));
+    uint64_t bits{0};
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 8; i++)
+    {
+        bytes.push_back(static_cast<char>((bits >> (8 * i)) & 0xff));
+    }
+    return bytes;
+}
+
+// Payload with only the given unsigned VarInt field
+std::string varIntField(uint32_t fieldId, uint64_t value)
+{
+    std::string bytes(1, static_cast<char>(fieldId << 3));
+    while (value > 0x7f)
+    {
+        bytes.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<char>(value));
+    return bytes;
+}
+
+void testMissingFieldsGetDefaults()
+{
+    cluon::OD4Session od4{cid};
+    std::vector<std::string> positions;
+    std::vector<std::string> images;
+    uint32_t wrongMeta{0};
+    od4.dataTrigger<opendlv::proxy::GeodeticWgs84Reading>([&positions, &wrongMeta](const opendlv::proxy::GeodeticWgs84Reading &message, const cluon::EnvelopeMeta &meta) {
+        opendlv::proxy::GeodeticWgs84Reading copy{message};
+        positions.push_back(encode(copy));
+        wrongMeta += ((meta.dataType != opendlv::proxy::GeodeticWgs84Reading::ID()) || (meta.senderStamp != senderStamp)) ? 1 : 0;
+    });
+    od4.dataTrigger<opendlv::proxy::ImageReading>([&images, &wrongMeta](const opendlv::proxy::ImageReading &message, const cluon::EnvelopeMeta &meta) {
+        opendlv::proxy::ImageReading copy{message};
+        images.push_back(encode(copy));
+        wrongMeta += ((meta.dataType != opendlv::proxy::ImageReading::ID()) || (meta.senderStamp != senderStamp)) ? 1 : 0;
+    });
+
+    opendlv::proxy::GeodeticWgs84Reading position;
+    position.latitude(57.7).longitude(11.9);
+    opendlv::proxy::ImageReading image;
+    image.fourcc("h264").width(640).height(480).data("frame");
+    opendlv::proxy::GeodeticWgs84Reading onlyLatitude;
+    onlyLatitude.latitude(58.0);
+    opendlv::proxy::ImageReading onlyWidth;
+    onlyWidth.width(320);
+
+    // Both types alternate, so each delegate decodes after the other one has decoded a full message
+    const auto timepoint = std::chrono::system_clock::now();
+    od4.dispatch(datagram(position), timepoint);
+    od4.dispatch(datagram(image), timepoint);
+    od4.dispatch(datagram<opendlv::proxy::GeodeticWgs84Reading>(doubleField(1, 58.0)), timepoint);
+    od4.dispatch(datagram<opendlv::proxy::ImageReading>(varIntField(2, 320)), timepoint);
+    od4.dispatch(datagram(position), timepoint);
+    od4.dispatch(datagram<opendlv::proxy::ImageReading>(""), timepoint);
+
+    CHECK(wrongMeta == 0);
+    CHECK(positions == std::vector<std::string>({encode(position), encode(onlyLatitude), encode(position)}));
+    opendlv::proxy::ImageReading empty;
+    CHECK(images == std::vector<std::string>({encode(image), encode(onlyWidth), encode(empty)}));
+
+    // A new delegate for a type starts from the defaults as well
+    od4.dataTrigger<opendlv::proxy::GeodeticWgs84Reading>([&positions](const opendlv::proxy::GeodeticWgs84Reading &message, const cluon::EnvelopeMeta &) {
+        opendlv::proxy::GeodeticWgs84Reading copy{message};
+        positions.push_back(encode(copy));
+    });
+    od4.dispatch(datagram<opendlv::proxy::GeodeticWgs84Reading>(doubleField(3, 12.0)), timepoint);
+    opendlv::proxy::GeodeticWgs84Reading onlyLongitude;
+    onlyLongitude.longitude(12.0);
+    CHECK((positions.size() == 4) && (positions.back() == encode(onlyLongitude)));
+}
+
+// The table that still holds a replaced delegate must be released by the dispatch that used it, even if no
+// delegate is set afterwards
+void testReplacedDelegateIsReleasedAfterDispatch()
+{
+    cluon::OD4Session od4{cid};
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool entered{false};
+    bool released{false};
+    auto token = std::make_shared<int>(0);
+    std::weak_ptr<int> replaced{token};
+    od4.dataTrigger<opendlv::proxy::GroundSteeringRequest>([token, &mutex, &condition, &entered, &released](const opendlv::proxy::GroundSteeringRequest &, const cluon::EnvelopeMeta &) {
+        std::unique_lock<std::mutex> lock(mutex);
+        entered = true;
+        condition.notify_all();
+        condition.wait(lock, [&released]() { return released; });
+    });
+    token.reset();
+
+    opendlv::proxy::GroundSteeringRequest request;
+    request.groundSteering(0.1f);
+    const std::string data{datagram(request)};
+    std::thread dispatcher([&od4, &data]() { od4.dispatch(data, std::chrono::system_clock::now()); });
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&entered]() { return entered; });
+    }
+
+    // The running dispatch still reads the old table, so the old delegate must stay alive
+    od4.dataTrigger<opendlv::proxy::GroundSteeringRequest>([](const opendlv::proxy::GroundSteeringRequest &, const cluon::EnvelopeMeta &) {});
+    CHECK(!replaced.expired());
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        released = true;
+    }
+    condition.notify_all();
+    dispatcher.join();
+    CHECK(replaced.expired());
+}
+
+// Delegates are set and removed while several threads dispatch; the delegate of the dispatched type is replaced
+// all the time but always set, so every datagram must reach one of its versions
+void testRegistrationDuringDispatch()
+{
+    const int dispatchers{3};
+    const int datagramsPerDispatcher{20000};
+    cluon::OD4Session od4{cid};
+    std::atomic<int> received{0};
+    std::atomic<int> wrongValue{0};
+    auto countingDelegate = [&received, &wrongValue](const opendlv::proxy::GroundSteeringRequest &message, const cluon::EnvelopeMeta &) {
+        received.fetch_add(1);
+        wrongValue.fetch_add((message.groundSteering() > 0.24f && message.groundSteering() < 0.26f) ? 0 : 1);
+    };
+    od4.dataTrigger<opendlv::proxy::GroundSteeringRequest>(countingDelegate);
+
+    opendlv::proxy::GroundSteeringRequest request;
+    request.groundSteering(0.25f);
+    const std::string data{datagram(request)};
+    std::atomic<int> running{dispatchers};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < dispatchers; i++)
+    {
+        threads.emplace_back([&od4, &data, &running, datagramsPerDispatcher]() {
+            const auto timepoint = std::chrono::system_clock::now();
+            for (int j = 0; j < datagramsPerDispatcher; j++)
+            {
+                od4.dispatch(data, timepoint);
+            }
+            running.fetch_sub(1);
+        });
+    }
+
+    uint32_t registrations{0};
+    while (running.load() > 0)
+    {
+        od4.dataTrigger<opendlv::proxy::GroundSteeringRequest>(countingDelegate);
+        od4.dataTrigger<opendlv::proxy::ImageReading>([](const opendlv::proxy::ImageReading &, const cluon::EnvelopeMeta &) {});
+        od4.dataTrigger(opendlv::proxy::ImageReading::ID(), nullptr);
+        registrations++;
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    std::cout << registrations << " registrations during " << dispatchers * datagramsPerDispatcher << " dispatches" << std::endl;
+    CHECK(received.load() == dispatchers * datagramsPerDispatcher);
+    CHECK(wrongValue.load() == 0);
+}
+} // namespace
+
+int32_t main()
+{
+    testMissingFieldsGetDefaults();
+    testReplacedDelegateIsReleasedAfterDispatch();
+    testRegistrationDuringDispatch();
+    return checkResult();
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Checks --detector=projection against the connected components it replaces on clean masks of separate cones, for
+// every kernel set the CPU supports. Boxes must come out as the same blobs in the same order; cones that narrow to the
+// top lose the outermost columns of their bottom rows, which have fewer hits than a run needs, so their boxes may be
+// up to 2 pixels narrower on each side and their centroids up to a pixel apart.
+
+#include "blob-extractor.hpp"
+#include "check.hpp"
+#include "cpu-dispatch.hpp"
+#include "projection-detector.hpp"
+
+#include <opencv2/core/core.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+const int width = 640;
+const int height = 100;
+// Cells of the mask that hold at most one cone each; the margin keeps cones of neighbouring cells further apart
+// than the gaps the projection bridges
+const int cellWidth = 80;
+const int cellHeight = 50;
+const int margin = 4;
+
+// Cone seen from the front: from a top of 3 pixels, which the projection needs to count a row, it widens by at most
+// a pixel per row on each side; boxes keep their width
+void drawCone(cv::Mat &mask, int x, int y, int w, int h, bool box)
+{
+    for (int row = 0; row < h; row++)
+    {
+        const int rowWidth{box ? w : std::min(w, 3 + 2 * row)};
+        const int left{x + (w - rowWidth) / 2};
+        std::memset(mask.ptr<uint8_t>(y + row) + left, 255, static_cast<size_t>(rowWidth));
+    }
+}
+
+// Mask with a cone of random size and position in about half of the cells
+void randomCones(std::mt19937 &generator, cv::Mat &mask, bool boxes)
+{
+    for (int y = 0; y < height; y++)
+    {
+        std::memset(mask.ptr<uint8_t>(y), 0, width);
+    }
+    std::uniform_int_distribution<int> coin(0, 1);
+    for (int cellY = 0; cellY < height; cellY += cellHeight)
+    {
+        for (int cellX = 0; cellX < width; cellX += cellWidth)
+        {
+            if (coin(generator) == 0)
+            {
+                continue;
+            }
+            const int w{std::uniform_int_distribution<int>(3, cellWidth - 2 * margin)(generator)};
+            const int h{std::uniform_int_distribution<int>(3, cellHeight - 2 * margin)(generator)};
+            const int x{cellX + std::uniform_int_distribution<int>(margin, cellWidth - margin - w)(generator)};
+            const int y{cellY + std::uniform_int_distribution<int>(margin, cellHeight - margin - h)(generator)};
+            drawCone(mask, x, y, w, h, boxes);
+        }
+    }
+}
+
+// Whether the candidates are the blobs, with the left and right edges of the boxes up to columns apart and the
+// centroids up to distance apart
+bool sameBlobs(const std::vector<Blob> &expected, const std::vector<Blob> &actual, int columns, float distance)
+{
+    if (expected.size() != actual.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        const cv::Rect &a = expected[i].boundingBox;
+        const cv::Rect &b = actual[i].boundingBox;
+        if ((a.y != b.y) || (a.height != b.height) || (std::abs(a.x - b.x) > columns) || (std::abs(a.x + a.width - b.x - b.width) > columns))
+        {
+            return false;
+        }
+        if ((std::fabs(expected[i].centroid.x - actual[i].centroid.x) > distance) || (std::fabs(expected[i].centroid.y - actual[i].centroid.y) > distance))
+        {
+            return false;
+        }
+        if ((columns == 0) && (expected[i].area != actual[i].area))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+int32_t main()
+{
+    cv::Mat mask(height, width, CV_8UC1);
+    BlobExtractor extractor;
+    ProjectionDetector projection;
+    for (KernelSet set : {KERNELS_SCALAR, KERNELS_SSE41, KERNELS_AVX2})
+    {
+        if (!kernelSetSupported(set))
+        {
+            continue;
+        }
+        selectKernels(set);
+        std::cout << kernelSetName(set) << std::endl;
+
+        std::mt19937 generator{42};
+        const cv::Point offset(0, 240);
+        for (int i = 0; i < 200; i++)
+        {
+            randomCones(generator, mask, true);
+            CHECK(sameBlobs(extractor.extract(mask, offset), projection.detect(mask, offset), 0, 1e-3f));
+            randomCones(generator, mask, false);
+            CHECK(sameBlobs(extractor.extract(mask, offset), projection.detect(mask, offset), 2, 1.0f));
+        }
+
+        // A window of the mask, as the tracking searches
+        const cv::Rect window(37, 10, 301, 77);
+        CHECK(sameBlobs(extractor.extract(mask(window), window.tl()), projection.detect(mask(window), window.tl()), 2, 1.0f));
+    }
+    return checkResult();
+}
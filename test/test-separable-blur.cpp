@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Checks SeparableBlur against the cv::GaussianBlur(view, dst, cv::Size(7, 7), 1.0) call it replaced, for every kernel
+// set the CPU supports: on the region of interest of a frame, which reads the rows of the frame around it, on views at
+// the edges of the frame, where the border is reflected, and in place like the microservice used to blur.
+
+#include "check.hpp"
+#include "cpu-dispatch.hpp"
+#include "separable-blur.hpp"
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+// Noise on top of hard edges, so every tap of the kernel matters and the extremes 0 and 255 occur
+cv::Mat randomFrame(std::mt19937 &generator, int width, int height)
+{
+    cv::Mat frame(height, width, CV_8UC4);
+    std::uniform_int_distribution<int> noise(-60, 60);
+    std::uniform_int_distribution<int> extreme(0, 49);
+    for (int y = 0; y < height; y++)
+    {
+        uint8_t *row = frame.ptr<uint8_t>(y);
+        for (int x = 0; x < 4 * width; x++)
+        {
+            const int base{(((x / 4) / 9 + y / 7) % 2 == 0) ? 40 : 210};
+            const int chance{extreme(generator)};
+            row[x] = (chance == 0) ? 0 : ((chance == 1) ? 255 : cv::saturate_cast<uint8_t>(base + noise(generator)));
+        }
+    }
+    return frame;
+}
+
+bool sameImage(const cv::Mat &expected, const cv::Mat &actual)
+{
+    if ((expected.rows != actual.rows) || (expected.cols != actual.cols) || (expected.type() != actual.type()))
+    {
+        return false;
+    }
+    for (int y = 0; y < expected.rows; y++)
+    {
+        const uint8_t *e = expected.ptr<uint8_t>(y);
+        const uint8_t *a = actual.ptr<uint8_t>(y);
+        for (int x = 0; x < expected.cols * expected.channels(); x++)
+        {
+            if (e[x] != a[x])
+            {
+                std::cerr << "first difference at (" << x / expected.channels() << ", " << y << "), channel " << x % expected.channels() << ": "
+                          << static_cast<int>(e[x]) << " instead of " << static_cast<int>(a[x]) << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Blurs the view of the frame into a buffer and in place and compares both with cv::GaussianBlur
+void checkView(SeparableBlur &blur, const cv::Mat &frame, const cv::Rect &view)
+{
+    cv::Mat expected;
+    cv::GaussianBlur(frame(view), expected, cv::Size(SeparableBlur::KERNEL_SIZE, SeparableBlur::KERNEL_SIZE), 1.0);
+
+    cv::Mat blurred;
+    blur.apply(frame(view), blurred);
+    if (!CHECK(sameImage(expected, blurred)))
+    {
+        std::cerr << "view " << view.x << ", " << view.y << ", " << view.width << "x" << view.height << std::endl;
+    }
+
+    // In place the rows of the view are overwritten while the rows below it are still needed
+    cv::Mat copy = frame.clone();
+    cv::Mat inPlace = copy(view);
+    blur.apply(inPlace, inPlace);
+    if (!CHECK(sameImage(expected, inPlace)))
+    {
+        std::cerr << "view " << view.x << ", " << view.y << ", " << view.width << "x" << view.height << " in place" << std::endl;
+    }
+}
+} // namespace
+
+int32_t main()
+{
+    std::mt19937 generator{7};
+    const cv::Mat frame = randomFrame(generator, 640, 480);
+    const cv::Mat small = randomFrame(generator, 37, 9);
+    const std::vector<cv::Rect> views{
+        // The region of interest of the microservice and its ingest region with the blur margin
+        cv::Rect(0, 240, 640, 100),
+        cv::Rect(0, 237, 640, 106),
+        // The whole frame and views touching each of its edges and corners
+        cv::Rect(0, 0, 640, 480),
+        cv::Rect(0, 0, 640, 100),
+        cv::Rect(0, 380, 640, 100),
+        cv::Rect(0, 100, 50, 60),
+        cv::Rect(590, 100, 50, 60),
+        cv::Rect(636, 476, 4, 4),
+        cv::Rect(0, 0, 4, 4),
+        // Views one and two pixels from the edges, so the kernel reads a part of the border from the frame
+        cv::Rect(1, 2, 37, 20),
+        cv::Rect(601, 457, 37, 21),
+        // Widths whose rows end in the scalar tail of the vector kernels
+        cv::Rect(3, 200, 5, 5),
+        cv::Rect(100, 300, 333, 41),
+    };
+
+    for (KernelSet set : {KERNELS_SCALAR, KERNELS_SSE41, KERNELS_AVX2})
+    {
+        if (!kernelSetSupported(set))
+        {
+            continue;
+        }
+        selectKernels(set);
+        std::cout << kernelSetName(set) << std::endl;
+
+        // One instance for all views, as the microservice reuses its buffers
+        SeparableBlur blur;
+        for (const cv::Rect &view : views)
+        {
+            checkView(blur, frame, view);
+        }
+        checkView(blur, small, cv::Rect(0, 0, small.cols, small.rows));
+    }
+    return checkResult();
+}
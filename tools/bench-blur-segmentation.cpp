@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Microbenchmark comparing the separate blur and segmentation passes against the fused row-by-row pass, with the
+// OpenCV calls both replaced as the baseline
+
+#include "cluon-complete.hpp"
+#include "cpu-dispatch.hpp"
+#include "fused-segmentation.hpp"
+#include "hsv-threshold.hpp"
+#include "separable-blur.hpp"
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+// Same thresholds as the microservice
+const cv::Scalar blueLow = cv::Scalar(100, 50, 30);
+const cv::Scalar blueHigh = cv::Scalar(120, 255, 255);
+const cv::Scalar yellowLow = cv::Scalar(17, 60, 70);
+const cv::Scalar yellowHigh = cv::Scalar(40, 200, 200);
+
+// Number of pixels where two masks differ
+int mismatches(const cv::Mat &expected, const cv::Mat &actual)
+{
+    cv::Mat difference;
+    cv::bitwise_xor(expected, actual, difference);
+    return cv::countNonZero(difference);
+}
+
+template <typename F> double microsecondsPerCall(uint32_t iterations, F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        f();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+    const uint32_t ITERATIONS{(commandlineArguments.count("iterations") != 0) ? static_cast<uint32_t>(std::stoi(commandlineArguments["iterations"])) : 2000};
+    const int WIDTH{(commandlineArguments.count("width") != 0) ? std::stoi(commandlineArguments["width"]) : 640};
+    const int HEIGHT{(commandlineArguments.count("height") != 0) ? std::stoi(commandlineArguments["height"]) : 100};
+
+    const HsvRange blueRange = toHsvRange(blueLow, blueHigh);
+    const HsvRange yellowRange = toHsvRange(yellowLow, yellowHigh);
+
+    // Noisy blue, yellow and gray patches, with the rows above and below the region that the microservice copies
+    // for the blur
+    cv::Mat ingest(HEIGHT + 2 * SeparableBlur::RADIUS, WIDTH, CV_8UC4);
+    const uint8_t patches[3][3] = {{200, 80, 40}, {30, 200, 230}, {90, 90, 90}};
+    std::mt19937 generator{42};
+    std::uniform_int_distribution<int> noise(-40, 40);
+    for (int y = 0; y < ingest.rows; y++)
+    {
+        uint8_t *row = ingest.ptr<uint8_t>(y);
+        for (int x = 0; x < ingest.cols; x++)
+        {
+            const uint8_t *patch = patches[(x / 24 + y / 16) % 3];
+            for (int c = 0; c < 3; c++)
+            {
+                row[4 * x + c] = cv::saturate_cast<uint8_t>(patch[c] + noise(generator));
+            }
+            row[4 * x + 3] = 255;
+        }
+    }
+    const cv::Mat region = ingest(cv::Rect(0, SeparableBlur::RADIUS, WIDTH, HEIGHT));
+
+    // The OpenCV calls of the original microservice are the reference for the masks
+    cv::Mat opencvBlurred, hsv;
+    cv::Mat expectedBlue(region.size(), CV_8UC1), expectedYellow(region.size(), CV_8UC1);
+    const auto opencv = [&]() {
+        cv::GaussianBlur(region, opencvBlurred, cv::Size(SeparableBlur::KERNEL_SIZE, SeparableBlur::KERNEL_SIZE), 1.0);
+        cv::cvtColor(opencvBlurred, hsv, cv::COLOR_BGR2HSV);
+        cv::inRange(hsv, blueLow, blueHigh, expectedBlue);
+        cv::inRange(hsv, yellowLow, yellowHigh, expectedYellow);
+    };
+    opencv();
+
+    cv::Mat blurred(region.size(), CV_8UC4);
+    cv::Mat blueMask(region.size(), CV_8UC1), yellowMask(region.size(), CV_8UC1);
+    SeparableBlur blur;
+    FusedSegmenter segmenter;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << WIDTH << "x" << HEIGHT << ", " << ITERATIONS << " iterations, OpenCV " << microsecondsPerCall(ITERATIONS, opencv) << " us/frame" << std::endl;
+    for (KernelSet set : {KERNELS_SCALAR, KERNELS_SSE41, KERNELS_AVX2})
+    {
+        if (!kernelSetSupported(set))
+        {
+            continue;
+        }
+        selectKernels(set);
+        // The separate passes give the masks of OpenCV; the fused blur rounds after each pass, so a few pixels right
+        // at the thresholds flip
+        blur.apply(region, blurred);
+        hsvThreshold(blurred, blueRange, yellowRange, blueMask, yellowMask);
+        const double separateDiffering{100.0 * (mismatches(expectedBlue, blueMask) + mismatches(expectedYellow, yellowMask)) / (2.0 * region.total())};
+        segmenter.apply(region, blueRange, yellowRange, nullptr, blueMask, yellowMask);
+        const double fusedDiffering{100.0 * (mismatches(expectedBlue, blueMask) + mismatches(expectedYellow, yellowMask)) / (2.0 * region.total())};
+
+        const double separateTime{microsecondsPerCall(ITERATIONS, [&]() {
+            blur.apply(region, blurred);
+            hsvThreshold(blurred, blueRange, yellowRange, blueMask, yellowMask);
+        })};
+        const double fusedTime{microsecondsPerCall(ITERATIONS, [&]() { segmenter.apply(region, blueRange, yellowRange, nullptr, blueMask, yellowMask); })};
+        std::cout << kernelSetName(set) << ": separate " << separateTime << " us/frame, fused " << fusedTime << " us/frame (" << std::setprecision(2) << separateTime / fusedTime << "x); "
+                  << std::setprecision(3) << separateDiffering << "% and " << fusedDiffering << "% of the mask pixels differ from OpenCV" << std::setprecision(1) << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Microbenchmark comparing cv::cvtColor + 2x cv::inRange against the fused HSV threshold kernels
+
+#include "cluon-complete.hpp"
+#include "cpu-dispatch.hpp"
+#include "hsv-threshold.hpp"
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Same thresholds as the microservice
+const cv::Scalar blueLow = cv::Scalar(100, 50, 30);
+const cv::Scalar blueHigh = cv::Scalar(120, 255, 255);
+const cv::Scalar yellowLow = cv::Scalar(17, 60, 70);
+const cv::Scalar yellowHigh = cv::Scalar(40, 200, 200);
+
+// The path the microservice used before: one conversion and one threshold pass per color
+void reference(const cv::Mat &bgra, cv::Mat &hsv, cv::Mat &blueMask, cv::Mat &yellowMask)
+{
+    cv::cvtColor(bgra, hsv, cv::COLOR_BGR2HSV);
+    cv::inRange(hsv, blueLow, blueHigh, blueMask);
+    cv::inRange(hsv, yellowLow, yellowHigh, yellowMask);
+}
+
+void fused(HsvThresholdRow kernel, const cv::Mat &bgra, const HsvRange &blueRange, const HsvRange &yellowRange, cv::Mat &blueMask, cv::Mat &yellowMask)
+{
+    for (int y = 0; y < bgra.rows; y++)
+    {
+        kernel(bgra.ptr<uint8_t>(y), bgra.cols, blueRange, yellowRange, blueMask.ptr<uint8_t>(y), yellowMask.ptr<uint8_t>(y));
+    }
+}
+
+// Number of pixels where the masks of a kernel differ from the reference masks
+int mismatches(const cv::Mat &expected, const cv::Mat &actual)
+{
+    cv::Mat difference;
+    cv::bitwise_xor(expected, actual, difference);
+    return cv::countNonZero(difference);
+}
+
+template <typename F> double microsecondsPerCall(uint32_t iterations, F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        f();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+    const uint32_t ITERATIONS{(commandlineArguments.count("iterations") != 0) ? static_cast<uint32_t>(std::stoi(commandlineArguments["iterations"])) : 2000};
+    const int WIDTH{(commandlineArguments.count("width") != 0) ? std::stoi(commandlineArguments["width"]) : 640};
+    const int HEIGHT{(commandlineArguments.count("height") != 0) ? std::stoi(commandlineArguments["height"]) : 100};
+
+    const HsvRange blueRange = toHsvRange(blueLow, blueHigh);
+    const HsvRange yellowRange = toHsvRange(yellowLow, yellowHigh);
+
+    struct Variant
+    {
+        const char *name;
+        HsvThresholdRow kernel;
+    };
+    std::vector<Variant> variants;
+    for (KernelSet set : {KERNELS_SCALAR, KERNELS_SSE41, KERNELS_AVX2})
+    {
+        if (kernelSetSupported(set))
+        {
+            variants.push_back({kernelSetName(set), kernelsFor(set).hsvThresholdRow});
+        }
+    }
+
+    // Verify bit-identity on an image that contains every BGR color once
+    {
+        cv::Mat cube(4096, 4096, CV_8UC4);
+        for (int y = 0; y < cube.rows; y++)
+        {
+            uint8_t *row = cube.ptr<uint8_t>(y);
+            for (int x = 0; x < cube.cols; x++)
+            {
+                const uint32_t color{static_cast<uint32_t>(y) * 4096 + static_cast<uint32_t>(x)};
+                row[4 * x + 0] = static_cast<uint8_t>(color & 0xff);
+                row[4 * x + 1] = static_cast<uint8_t>((color >> 8) & 0xff);
+                row[4 * x + 2] = static_cast<uint8_t>((color >> 16) & 0xff);
+                row[4 * x + 3] = 255;
+            }
+        }
+        cv::Mat hsv, expectedBlue, expectedYellow;
+        reference(cube, hsv, expectedBlue, expectedYellow);
+        cv::Mat blueMask(cube.size(), CV_8UC1), yellowMask(cube.size(), CV_8UC1);
+        for (const Variant &variant : variants)
+        {
+            fused(variant.kernel, cube, blueRange, yellowRange, blueMask, yellowMask);
+            const int blueErrors{mismatches(expectedBlue, blueMask)};
+            const int yellowErrors{mismatches(expectedYellow, yellowMask)};
+            std::cout << "verify " << variant.name << ": " << blueErrors << " blue and " << yellowErrors << " yellow mismatches over all 2^24 colors" << std::endl;
+            if ((blueErrors != 0) || (yellowErrors != 0))
+            {
+                return 1;
+            }
+        }
+    }
+
+    // Time a region of interest sized frame of random pixels; the branch-free kernels do not depend on the content
+    cv::Mat frame(HEIGHT, WIDTH, CV_8UC4);
+    std::mt19937 generator{42};
+    for (int y = 0; y < frame.rows; y++)
+    {
+        uint8_t *row = frame.ptr<uint8_t>(y);
+        for (int x = 0; x < 4 * frame.cols; x++)
+        {
+            row[x] = static_cast<uint8_t>(generator());
+        }
+    }
+    cv::Mat hsv, blueMask, yellowMask;
+    const double referenceTime{microsecondsPerCall(ITERATIONS, [&]() { reference(frame, hsv, blueMask, yellowMask); })};
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << WIDTH << "x" << HEIGHT << ", " << ITERATIONS << " iterations" << std::endl;
+    std::cout << "cvtColor+2x inRange: " << referenceTime << " us/frame" << std::endl;
+    for (const Variant &variant : variants)
+    {
+        const double time{microsecondsPerCall(ITERATIONS, [&]() { fused(variant.kernel, frame, blueRange, yellowRange, blueMask, yellowMask); })};
+        std::cout << "fused " << variant.name << ": " << time << " us/frame (" << std::setprecision(2) << referenceTime / time << "x)" << std::setprecision(1) << std::endl;
+    }
+    return 0;
+}
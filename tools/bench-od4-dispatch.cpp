@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Microbenchmark of the cost to dispatch one received OD4 datagram to its data-triggered delegate
+
+#include "cluon-complete.hpp"
+#include "opendlv-standard-message-set.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Serialized Envelope with the OD4 header, as it arrives from the network
+std::string datagram(int32_t dataType, const std::string &payload)
+{
+    cluon::data::Envelope env;
+    env.dataType(dataType).serializedData(payload).senderStamp(1);
+    env.sent(cluon::time::now()).sampleTimeStamp(env.sent());
+    return cluon::serializeEnvelope(std::move(env));
+}
+
+template <typename F> double nanosecondsPerCall(uint32_t iterations, F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        f();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+    const uint32_t ITERATIONS{(commandlineArguments.count("iterations") != 0) ? static_cast<uint32_t>(std::stoi(commandlineArguments["iterations"])) : 1000000};
+    // The sessions must not receive other traffic while they are measured
+    const uint16_t CID{static_cast<uint16_t>((commandlineArguments.count("cid") != 0) ? std::stoi(commandlineArguments["cid"]) : 254)};
+    // Data types that nobody sends, used to fill the delegate table
+    const int32_t UNUSED_DATA_TYPE{100000};
+
+    opendlv::proxy::GroundSteeringRequest request;
+    request.groundSteering(0.25f);
+    cluon::ToProtoVisitor encoder;
+    request.accept(encoder);
+    const std::string PAYLOAD{encoder.encodedData()};
+    const std::string REGISTERED{datagram(static_cast<int32_t>(opendlv::proxy::GroundSteeringRequest::ID()), PAYLOAD)};
+    const std::string UNREGISTERED{datagram(UNUSED_DATA_TYPE - 1, PAYLOAD)};
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << ITERATIONS << " datagrams per run" << std::endl;
+    std::cout << "types; registered [ns/msg]; unregistered [ns/msg]; registered while registering [ns/msg]; registrations/s" << std::endl;
+    for (int32_t types : {1, 10, 100})
+    {
+        cluon::OD4Session od4{CID};
+        uint64_t received{0};
+        od4.dataTrigger<opendlv::proxy::GroundSteeringRequest>(
+            [&received](const opendlv::proxy::GroundSteeringRequest &, const cluon::EnvelopeMeta &) { received++; });
+        for (int32_t i = 1; i < types; i++)
+        {
+            od4.dataTrigger(UNUSED_DATA_TYPE + i, [](cluon::data::Envelope &&) {});
+        }
+
+        const auto timepoint = std::chrono::system_clock::now();
+        const double registered{nanosecondsPerCall(ITERATIONS, [&]() { od4.dispatch(REGISTERED, timepoint); })};
+        const double unregistered{nanosecondsPerCall(ITERATIONS, [&]() { od4.dispatch(UNREGISTERED, timepoint); })};
+
+        // Replace the table over and over while dispatching; dispatch must neither wait for it nor miss a datagram
+        std::atomic<bool> registering{true};
+        uint64_t registrations{0};
+        std::thread registrar([&od4, &registering, &registrations, UNUSED_DATA_TYPE]() {
+            while (registering.load())
+            {
+                od4.dataTrigger(UNUSED_DATA_TYPE, [](cluon::data::Envelope &&) {});
+                od4.dataTrigger(UNUSED_DATA_TYPE, nullptr);
+                registrations += 2;
+            }
+        });
+        const auto start = std::chrono::steady_clock::now();
+        const double contended{nanosecondsPerCall(ITERATIONS, [&]() { od4.dispatch(REGISTERED, timepoint); })};
+        const double seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+        registering.store(false);
+        registrar.join();
+
+        if (received != 2 * static_cast<uint64_t>(ITERATIONS))
+        {
+            std::cerr << argv[0] << ": " << received << " of " << 2 * static_cast<uint64_t>(ITERATIONS) << " datagrams reached their delegate." << std::endl;
+            return 1;
+        }
+        std::cout << types << "; " << registered << "; " << unregistered << "; " << contended << "; " << std::setprecision(0) << registrations / seconds
+                  << std::setprecision(1) << std::endl;
+    }
+
+    // Setting a delegate must not wait for a slow delegate that is running
+    {
+        cluon::OD4Session od4{CID};
+        od4.dataTrigger<opendlv::proxy::GroundSteeringRequest>([](const opendlv::proxy::GroundSteeringRequest &, const cluon::EnvelopeMeta &) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        });
+        std::atomic<bool> dispatching{true};
+        std::thread dispatcher([&od4, &dispatching, &REGISTERED]() {
+            while (dispatching.load())
+            {
+                od4.dispatch(REGISTERED, std::chrono::system_clock::now());
+            }
+        });
+        const uint32_t REGISTRATIONS{200};
+        double total{0};
+        double longest{0};
+        for (uint32_t i = 0; i < REGISTRATIONS; i++)
+        {
+            const double time{nanosecondsPerCall(1, [&]() { od4.dataTrigger(UNUSED_DATA_TYPE + static_cast<int32_t>(i % 2), [](cluon::data::Envelope &&) {}); }) / 1000};
+            total += time;
+            longest = std::max(longest, time);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        dispatching.store(false);
+        dispatcher.join();
+        std::cout << "setting a delegate while a 1 ms delegate runs: " << total / REGISTRATIONS << " us on average, " << longest << " us at most" << std::endl;
+    }
+    return 0;
+}
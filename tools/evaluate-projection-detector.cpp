@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Compares --detector=projection with --detector=blobs on synthetic masks of the region of interest with up to three
+// cones and random noise: how often getCones() would take a cone with the same center, and the time per mask
+
+#include "blob-extractor.hpp"
+#include "cluon-complete.hpp"
+#include "cpu-dispatch.hpp"
+#include "projection-detector.hpp"
+
+#include <opencv2/core/core.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Size of the region of interest and the bounding box areas getCones() takes as a cone
+const int width = 640;
+const int height = 100;
+const int minConeArea = 200;
+const int maxConeArea = 1500;
+
+struct Evaluation
+{
+    uint32_t same;
+    uint32_t within2;
+    uint32_t differ;
+    double blobsTime;
+    double projectionTime;
+};
+
+// The box getCones() takes: the last one of cone size
+const cv::Rect *chosenCone(const std::vector<Blob> &blobs)
+{
+    for (size_t i = blobs.size(); i > 0; i--)
+    {
+        const int area{blobs[i - 1].boundingBox.area()};
+        if ((area > minConeArea) && (area < maxConeArea))
+        {
+            return &blobs[i - 1].boundingBox;
+        }
+    }
+    return nullptr;
+}
+
+// Set noise in a thousand pixels and draw up to three cones that narrow towards the top
+void randomMask(std::mt19937 &generator, cv::Mat &mask, uint32_t noise)
+{
+    for (int y = 0; y < height; y++)
+    {
+        uint8_t *row = mask.ptr<uint8_t>(y);
+        for (int x = 0; x < width; x++)
+        {
+            row[x] = ((generator() % 1000) < noise) ? 255 : 0;
+        }
+    }
+    const uint32_t cones{static_cast<uint32_t>(generator() % 4)};
+    for (uint32_t i = 0; i < cones; i++)
+    {
+        const int w{12 + static_cast<int>(generator() % 14)};
+        const int h{18 + static_cast<int>(generator() % 20)};
+        const int left{static_cast<int>(generator() % static_cast<uint32_t>(width - w))};
+        const int top{static_cast<int>(generator() % static_cast<uint32_t>(height - h))};
+        for (int y = top; y < top + h; y++)
+        {
+            const int inset{(y - top) * w / (3 * h)};
+            uint8_t *row = mask.ptr<uint8_t>(y);
+            for (int x = left + inset; x < left + w - inset; x++)
+            {
+                row[x] = 255;
+            }
+        }
+    }
+}
+
+Evaluation evaluate(uint32_t masks, uint32_t noise, uint32_t seed)
+{
+    Evaluation evaluation{0, 0, 0, 0.0, 0.0};
+    std::mt19937 generator{seed};
+    cv::Mat mask(height, width, CV_8UC1);
+    BlobExtractor extractor;
+    ProjectionDetector projection;
+    for (uint32_t i = 0; i < masks; i++)
+    {
+        randomMask(generator, mask, noise);
+        const auto start = std::chrono::steady_clock::now();
+        const cv::Rect *fromBlobs = chosenCone(extractor.extract(mask));
+        const auto middle = std::chrono::steady_clock::now();
+        const cv::Rect *fromProjection = chosenCone(projection.detect(mask));
+        const auto end = std::chrono::steady_clock::now();
+        evaluation.blobsTime += std::chrono::duration<double, std::micro>(middle - start).count();
+        evaluation.projectionTime += std::chrono::duration<double, std::micro>(end - middle).count();
+
+        if ((fromBlobs == nullptr) || (fromProjection == nullptr))
+        {
+            ((fromBlobs == fromProjection) ? evaluation.same : evaluation.differ)++;
+            continue;
+        }
+        // The center getCones() computes from the box
+        const int dx{std::abs((fromBlobs->x + fromBlobs->width / 2) - (fromProjection->x + fromProjection->width / 2))};
+        const int dy{std::abs((fromBlobs->y + fromBlobs->height / 2) - (fromProjection->y + fromProjection->height / 2))};
+        if ((dx == 0) && (dy == 0))
+        {
+            evaluation.same++;
+        }
+        else if ((dx <= 2) && (dy <= 2))
+        {
+            evaluation.within2++;
+        }
+        else
+        {
+            evaluation.differ++;
+        }
+    }
+    evaluation.blobsTime /= masks;
+    evaluation.projectionTime /= masks;
+    return evaluation;
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+    const uint32_t MASKS{(commandlineArguments.count("masks") != 0) ? static_cast<uint32_t>(std::stoi(commandlineArguments["masks"])) : 2000};
+    const uint32_t SEED{(commandlineArguments.count("seed") != 0) ? static_cast<uint32_t>(std::stoi(commandlineArguments["seed"])) : 5};
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << MASKS << " masks of " << width << "x" << height << " with up to three cones" << std::endl;
+    for (KernelSet set : {KERNELS_SCALAR, KERNELS_SSE41, KERNELS_AVX2})
+    {
+        if (!kernelSetSupported(set))
+        {
+            continue;
+        }
+        selectKernels(set);
+        // Noise in a thousand pixels
+        for (uint32_t noise : {0u, 2u, 10u})
+        {
+            const Evaluation e = evaluate(MASKS, noise, SEED);
+            std::cout << kernelSetName(set) << ", " << std::setprecision(1) << noise / 10.0 << "% noise: same center " << 100.0 * e.same / MASKS << "%, within 2 px "
+                      << 100.0 * e.within2 / MASKS << "%, further " << 100.0 * e.differ / MASKS << "%; blobs " << e.blobsTime << " us/mask, projection " << e.projectionTime
+                      << " us/mask" << std::endl;
+        }
+    }
+    return 0;
+}
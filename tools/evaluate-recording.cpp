@@ -0,0 +1,362 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Replays recordings as fast as possible through the same cone detection and steering as the microservice
+// and scores the steering wheel angles against the recorded ground steering requests
+
+#include "cluon-complete.hpp"
+#include "opendlv-standard-message-set.hpp"
+#include "cone-detection.hpp"
+#include "cpu-dispatch.hpp"
+#include "h264-decoder.hpp"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <opencv2/core/core.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// An h264 frame of the recording
+struct RecordedFrame
+{
+    int64_t timestamp;
+    uint32_t width;
+    uint32_t height;
+    std::string data;
+};
+
+// A ground steering request of the recording
+struct RecordedSteering
+{
+    int64_t timestamp;
+    double groundSteering;
+};
+
+// Outcome of evaluating one recording
+struct RecordingResult
+{
+    std::string rec{};
+    uint64_t frames{0};
+    uint64_t decoded{0};
+    // Frames whose steering wheel angle met the performance requirement
+    double within{0.0};
+    double decodingSeconds{0.0};
+    double detectionSeconds{0.0};
+    // Pixels that were blurred and segmented
+    uint64_t segmented{0};
+    // Pixels of the regions of interest of the decoded frames
+    uint64_t regionPixels{0};
+    std::string error{};
+};
+
+// How the recordings are evaluated
+struct EvaluationOptions
+{
+    // Lookup table that replaces the HSV conversion, or nullptr
+    const ColorLut *lut;
+    // Search windows around the tracked cones and the whole region every trackRescan frames
+    bool tracking;
+    uint32_t trackRescan;
+    // Downsampling factor of the coarse-to-fine search, 1 for none
+    int coarseScale;
+    // Open bit-packed masks instead of blurring the frames
+    bool openMasks;
+    // Find the cones from the projections of the masks instead of their connected components
+    bool projection;
+    // Blur every row right before it is segmented
+    bool fusedBlur;
+    // Print every frame
+    bool verbose;
+};
+
+// Find the ground steering request that is closest in time to the timestamp
+double nearestSteering(const std::vector<RecordedSteering> &steering, int64_t timestamp)
+{
+    auto after = std::lower_bound(steering.begin(), steering.end(), timestamp, [](const RecordedSteering &s, int64_t t) { return s.timestamp < t; });
+    if (after == steering.end())
+    {
+        return steering.back().groundSteering;
+    }
+    if ((after != steering.begin()) && (timestamp - (after - 1)->timestamp <= after->timestamp - timestamp))
+    {
+        return (after - 1)->groundSteering;
+    }
+    return after->groundSteering;
+}
+
+double seconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::duration<double>>(duration).count();
+}
+
+double perSecond(uint64_t count, double duration)
+{
+    return (duration > 0.0) ? static_cast<double>(count) / duration : 0.0;
+}
+
+double percent(uint64_t part, uint64_t total)
+{
+    return (total == 0) ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(total);
+}
+
+// The recording itself, or all .rec files in it if it is a directory
+std::vector<std::string> listRecordings(const std::string &path)
+{
+    std::vector<std::string> recs;
+    struct stat status;
+    if ((0 == ::stat(path.c_str(), &status)) && S_ISDIR(status.st_mode))
+    {
+        const std::string suffix{".rec"};
+        if (DIR *dir = ::opendir(path.c_str()))
+        {
+            while (struct dirent *entry = ::readdir(dir))
+            {
+                const std::string name{entry->d_name};
+                if ((name.size() > suffix.size()) && (0 == name.compare(name.size() - suffix.size(), suffix.size(), suffix)))
+                {
+                    recs.push_back(path + "/" + name);
+                }
+            }
+            ::closedir(dir);
+        }
+        std::sort(recs.begin(), recs.end());
+    }
+    else
+    {
+        recs.push_back(path);
+    }
+    return recs;
+}
+
+// Evaluate one recording with its own decoder, buffers and steering state
+RecordingResult evaluate(const std::string &rec, const EvaluationOptions &options, std::mutex &outputMutex)
+{
+    RecordingResult result{rec, 0, 0, 0.0, 0.0, 0.0, 0, 0, ""};
+
+    // Read the frames and the ground steering requests into memory first, so that only decoding and detection are timed
+    std::vector<RecordedFrame> frames;
+    std::vector<RecordedSteering> steering;
+    {
+        cluon::Player player(rec, false, false);
+        while (player.hasMoreData())
+        {
+            auto next = player.getNextEnvelopeToBeReplayed();
+            if (!next.first)
+            {
+                continue;
+            }
+            cluon::data::Envelope env{std::move(next.second)};
+            const int64_t timestamp{cluon::time::toMicroseconds(env.sampleTimeStamp())};
+            if (env.dataType() == opendlv::proxy::ImageReading::ID())
+            {
+                opendlv::proxy::ImageReading reading = cluon::extractMessage<opendlv::proxy::ImageReading>(std::move(env));
+                if (reading.fourcc() == "h264")
+                {
+                    frames.push_back(RecordedFrame{timestamp, reading.width(), reading.height(), reading.data()});
+                }
+            }
+            else if (env.dataType() == opendlv::proxy::GroundSteeringRequest::ID())
+            {
+                opendlv::proxy::GroundSteeringRequest gsr = cluon::extractMessage<opendlv::proxy::GroundSteeringRequest>(std::move(env));
+                steering.push_back(RecordedSteering{timestamp, static_cast<double>(gsr.groundSteering())});
+            }
+        }
+    }
+    std::stable_sort(steering.begin(), steering.end(), [](const RecordedSteering &a, const RecordedSteering &b) { return a.timestamp < b.timestamp; });
+    result.frames = frames.size();
+    if (frames.empty() || steering.empty())
+    {
+        result.error = "needs h264 frames and ground steering requests";
+        return result;
+    }
+
+    // Prepare the region of interest exactly like the microservice does
+    const cv::Rect frame(0, 0, static_cast<int>(frames.front().width), static_cast<int>(frames.front().height));
+    const cv::Rect region = roi & frame;
+    const cv::Rect ingestRegion = cv::Rect(region.x, region.y - blurMargin, region.width, region.height + 2 * blurMargin) & frame;
+    FrameWorkspace workspace(region, ingestRegion);
+    const VisionSettings settings{frames.front().width, frames.front().height, region, ingestRegion, false, false, toHsvRange(blueLow, blueHigh), toHsvRange(yellowLow, yellowHigh), options.lut, false, nullptr, options.tracking, options.trackRescan, options.coarseScale, options.openMasks, options.projection, options.fusedBlur};
+    SteeringController controller;
+
+    H264Decoder decoder;
+    cv::Mat bgra;
+    std::chrono::steady_clock::duration decoding{0};
+    std::chrono::steady_clock::duration detection{0};
+    for (const RecordedFrame &recorded : frames)
+    {
+        const std::chrono::steady_clock::time_point start{std::chrono::steady_clock::now()};
+        if (!decoder.decode(reinterpret_cast<const uint8_t *>(recorded.data.data()), recorded.data.size(), bgra))
+        {
+            continue;
+        }
+        const std::chrono::steady_clock::time_point decoded{std::chrono::steady_clock::now()};
+        // Copy the region out of the frame like the microservice copies it out of the shared memory
+        bgra(ingestRegion).copyTo(workspace.ingest);
+        detectFrame(settings, workspace, controller);
+        detection += std::chrono::steady_clock::now() - decoded;
+        decoding += decoded - start;
+
+        const double groundSteering{nearestSteering(steering, recorded.timestamp)};
+        controller.calculatePerformance(groundSteering);
+        result.decoded++;
+        result.segmented += workspace.segmentedPixels;
+        result.regionPixels += static_cast<uint64_t>(region.area());
+        if (options.verbose)
+        {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            std::cout << rec << "; group_04; " << recorded.timestamp << "; " << controller.steeringWheelAngle << "; " << groundSteering << std::endl;
+        }
+    }
+    result.within = controller.variable;
+    result.decodingSeconds = seconds(decoding);
+    result.detectionSeconds = seconds(detection);
+    return result;
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    int32_t retCode{1};
+    auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+    if (0 == commandlineArguments.count("rec"))
+    {
+        std::cerr << argv[0] << " replays the h264 frames of recordings through the cone detection as fast as possible and scores the steering wheel angles." << std::endl;
+        std::cerr << "Usage:   " << argv[0] << " --rec=<recording or directory of recordings> [--jobs=<n>] [--classifier=hsv|lut [--lut-bits=6]] [--tracking [--track-rescan=5]] [--coarse=1|2|4] [--denoise=blur|open] [--blur=separate|fused] [--detector=blobs|projection] [--kernels=auto|scalar|sse4.1|avx2] [--verbose]" << std::endl;
+        std::cerr << "         --jobs:    number of recordings that are evaluated at the same time (default: one per core)" << std::endl;
+        std::cerr << "         --tracking: only search windows around the predicted cones, and everything every --track-rescan frames" << std::endl;
+        std::cerr << "         --coarse:   search the region downsampled by this factor first and at full resolution only around what was found" << std::endl;
+        std::cerr << "         --denoise:  blur the frames (blur, default) or open the segmented masks with a 3x3 square instead (open)" << std::endl;
+        std::cerr << "         --blur:     blur the whole region first (separate, default) or every row right before it is segmented (fused)" << std::endl;
+        std::cerr << "         --detector: find the cones as connected components (blobs, default) or from the hits per column and row (projection)" << std::endl;
+        std::cerr << "         --kernels:  instruction set of the segmentation and blur kernels (default auto: the best one the CPU supports)" << std::endl;
+        std::cerr << "         --verbose: print the steering wheel angle and the ground steering of every frame" << std::endl;
+        std::cerr << "Example: " << argv[0] << " --rec=recordings" << std::endl;
+    }
+    else
+    {
+        const std::vector<std::string> RECS{listRecordings(commandlineArguments["rec"])};
+        const bool VERBOSE{commandlineArguments.count("verbose") != 0};
+        const bool USE_LUT{(commandlineArguments.count("classifier") != 0) && (commandlineArguments["classifier"] == "lut")};
+        const int LUT_BITS{(commandlineArguments.count("lut-bits") != 0) ? std::stoi(commandlineArguments["lut-bits"]) : 6};
+        const unsigned CORES{std::max(1u, std::thread::hardware_concurrency())};
+        const size_t JOBS{(commandlineArguments.count("jobs") != 0) ? static_cast<size_t>(std::max(1, std::stoi(commandlineArguments["jobs"]))) : CORES};
+        const bool TRACKING{commandlineArguments.count("tracking") != 0};
+        const uint32_t TRACK_RESCAN{(commandlineArguments.count("track-rescan") != 0) ? static_cast<uint32_t>(std::max(1, std::stoi(commandlineArguments["track-rescan"]))) : 5};
+        const std::string KERNELS{(commandlineArguments.count("kernels") != 0) ? commandlineArguments["kernels"] : "auto"};
+        KernelSet kernelSet;
+        if (!parseKernelSet(KERNELS, kernelSet) || !kernelSetSupported(kernelSet))
+        {
+            std::cerr << argv[0] << ": --kernels=" << KERNELS << " is unknown or not supported by this CPU; the best it supports are " << kernelSetName(bestKernelSet()) << "." << std::endl;
+            return retCode;
+        }
+        selectKernels(kernelSet);
+        std::clog << argv[0] << ": Using the " << kernelSetName(visionKernels().set) << " vision kernels." << std::endl;
+
+        // The lookup table is only read, so all workers share it
+        std::unique_ptr<ColorLut> lut;
+        if (USE_LUT)
+        {
+            lut.reset(new ColorLut(toHsvRange(blueLow, blueHigh), toHsvRange(yellowLow, yellowHigh), LUT_BITS));
+        }
+        const int COARSE{(commandlineArguments.count("coarse") != 0) ? std::stoi(commandlineArguments["coarse"]) : 1};
+        if ((COARSE != 1) && (COARSE != 2) && (COARSE != 4))
+        {
+            std::cerr << argv[0] << ": --coarse must be 1, 2 or 4." << std::endl;
+            return retCode;
+        }
+        const bool OPEN_MASKS{(commandlineArguments.count("denoise") != 0) && (commandlineArguments["denoise"] == "open")};
+        const bool PROJECTION{(commandlineArguments.count("detector") != 0) && (commandlineArguments["detector"] == "projection")};
+        if (PROJECTION && (OPEN_MASKS || (COARSE > 1)))
+        {
+            std::cerr << argv[0] << ": --detector=projection cannot be combined with --denoise=open or --coarse." << std::endl;
+            return retCode;
+        }
+        const bool FUSED_BLUR{(commandlineArguments.count("blur") != 0) && (commandlineArguments["blur"] == "fused")};
+        if (FUSED_BLUR && OPEN_MASKS)
+        {
+            std::cerr << argv[0] << ": --blur=fused cannot be combined with --denoise=open." << std::endl;
+            return retCode;
+        }
+        const EvaluationOptions options{lut.get(), TRACKING && (COARSE == 1), TRACK_RESCAN, COARSE, OPEN_MASKS && (COARSE == 1), PROJECTION, FUSED_BLUR, VERBOSE};
+
+        // Every worker takes the next recording until all are done
+        std::vector<RecordingResult> results(RECS.size());
+        std::atomic<size_t> next{0};
+        std::mutex outputMutex;
+        const std::chrono::steady_clock::time_point start{std::chrono::steady_clock::now()};
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < std::min(JOBS, RECS.size()); i++)
+        {
+            workers.emplace_back([&]() {
+                for (size_t r = next++; r < RECS.size(); r = next++)
+                {
+                    try
+                    {
+                        results[r] = evaluate(RECS[r], options, outputMutex);
+                    }
+                    catch (const std::exception &e)
+                    {
+                        results[r] = RecordingResult{RECS[r], 0, 0, 0.0, 0.0, 0.0, 0, 0, e.what()};
+                    }
+                }
+            });
+        }
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+        const double wallSeconds{seconds(std::chrono::steady_clock::now() - start)};
+
+        // Print one row per recording and the totals
+        RecordingResult total{"total", 0, 0, 0.0, 0.0, 0.0, 0, 0, ""};
+        bool failed{false};
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "recording; frames; decoded; within requirement; score %; decoding fps; detection fps; segmented pixels %" << std::endl;
+        for (const RecordingResult &result : results)
+        {
+            if (!result.error.empty() || (result.decoded == 0))
+            {
+                std::cout << result.rec << "; " << result.frames << "; " << result.decoded << "; failed: " << (result.error.empty() ? "no frame decoded" : result.error) << std::endl;
+                failed = true;
+                continue;
+            }
+            std::cout << result.rec << "; " << result.frames << "; " << result.decoded << "; " << result.within << "; " << 100.0 * result.within / static_cast<double>(result.decoded) << "; "
+                      << perSecond(result.decoded, result.decodingSeconds) << "; " << perSecond(result.decoded, result.detectionSeconds) << "; " << percent(result.segmented, result.regionPixels) << std::endl;
+            total.frames += result.frames;
+            total.decoded += result.decoded;
+            total.within += result.within;
+            total.decodingSeconds += result.decodingSeconds;
+            total.detectionSeconds += result.detectionSeconds;
+            total.segmented += result.segmented;
+            total.regionPixels += result.regionPixels;
+        }
+        std::cout << total.rec << "; " << total.frames << "; " << total.decoded << "; " << total.within << "; " << 100.0 * total.within / static_cast<double>(std::max<uint64_t>(1, total.decoded)) << "; "
+                  << perSecond(total.decoded, total.decodingSeconds) << "; " << perSecond(total.decoded, total.detectionSeconds) << "; " << percent(total.segmented, total.regionPixels) << std::endl;
+        std::cout << RECS.size() << " recordings on " << workers.size() << " workers in " << wallSeconds << " s (" << perSecond(total.decoded, wallSeconds) << " frames per second overall)" << std::endl;
+        retCode = failed ? 1 : 0;
+    }
+    return retCode;
+}
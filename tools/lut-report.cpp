@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Reports how much the masks of the color lookup tables differ from the exact HSV masks on live frames
+
+#include "cluon-complete.hpp"
+#include "color-lut.hpp"
+#include "cone-detection.hpp"
+#include "hsv-threshold.hpp"
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Mismatch counters of one lookup table
+struct Statistics
+{
+    uint64_t blueMissed{0};
+    uint64_t blueExtra{0};
+    uint64_t yellowMissed{0};
+    uint64_t yellowExtra{0};
+};
+
+// Count the pixels that the table drops from or adds to the exact mask
+void compare(const cv::Mat &exact, const cv::Mat &approximated, uint64_t &missed, uint64_t &extra)
+{
+    for (int y = 0; y < exact.rows; y++)
+    {
+        const uint8_t *e = exact.ptr<uint8_t>(y);
+        const uint8_t *a = approximated.ptr<uint8_t>(y);
+        for (int x = 0; x < exact.cols; x++)
+        {
+            missed += (e[x] > a[x]) ? 1 : 0;
+            extra += (e[x] < a[x]) ? 1 : 0;
+        }
+    }
+}
+
+double percent(uint64_t part, uint64_t total)
+{
+    return (total == 0) ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(total);
+}
+
+void report(uint64_t frames, uint64_t pixels, uint64_t bluePixels, uint64_t yellowPixels, const std::vector<std::unique_ptr<ColorLut>> &luts, const std::vector<Statistics> &statistics)
+{
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << frames << " frames, " << pixels << " pixels, " << bluePixels << " blue and " << yellowPixels << " yellow pixels in the exact masks" << std::endl;
+    std::cout << "bits; table bytes; blue missed %; blue extra %; yellow missed %; yellow extra %; differing pixels %" << std::endl;
+    for (size_t i = 0; i < luts.size(); i++)
+    {
+        const Statistics &s = statistics[i];
+        std::cout << luts[i]->bitsPerChannel() << "; " << luts[i]->size() << "; " << percent(s.blueMissed, bluePixels) << "; " << percent(s.blueExtra, bluePixels) << "; "
+                  << percent(s.yellowMissed, yellowPixels) << "; " << percent(s.yellowExtra, yellowPixels) << "; "
+                  << percent(s.blueMissed + s.blueExtra + s.yellowMissed + s.yellowExtra, 2 * pixels) << std::endl;
+    }
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    int32_t retCode{1};
+    auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+    if ((0 == commandlineArguments.count("name")) || (0 == commandlineArguments.count("width")) || (0 == commandlineArguments.count("height")))
+    {
+        std::cerr << argv[0] << " compares the masks of color lookup tables with the exact HSV masks on the frames of a shared memory area." << std::endl;
+        std::cerr << "Usage:   " << argv[0] << " --name=<name of shared memory area> --width=<width> --height=<height> [--lut-bits=4,5,6,7] [--frames=<n>] [--report-every=100]" << std::endl;
+        std::cerr << "Example: " << argv[0] << " --name=img --width=640 --height=480 --frames=500" << std::endl;
+    }
+    else
+    {
+        const std::string NAME{commandlineArguments["name"]};
+        const uint32_t WIDTH{static_cast<uint32_t>(std::stoi(commandlineArguments["width"]))};
+        const uint32_t HEIGHT{static_cast<uint32_t>(std::stoi(commandlineArguments["height"]))};
+        const uint64_t FRAMES{(commandlineArguments.count("frames") != 0) ? static_cast<uint64_t>(std::stoll(commandlineArguments["frames"])) : 0};
+        const uint64_t REPORT_EVERY{(commandlineArguments.count("report-every") != 0) ? static_cast<uint64_t>(std::stoll(commandlineArguments["report-every"])) : 100};
+        const std::string BITS{(commandlineArguments.count("lut-bits") != 0) ? commandlineArguments["lut-bits"] : "4,5,6,7"};
+
+        const HsvRange blueRange = toHsvRange(blueLow, blueHigh);
+        const HsvRange yellowRange = toHsvRange(yellowLow, yellowHigh);
+        std::vector<std::unique_ptr<ColorLut>> luts;
+        for (const std::string &bits : stringtoolbox::split(BITS, ','))
+        {
+            luts.emplace_back(new ColorLut(blueRange, yellowRange, std::stoi(bits)));
+        }
+        std::vector<Statistics> statistics(luts.size());
+
+        std::unique_ptr<cluon::SharedMemory> sharedMemory{new cluon::SharedMemory{NAME}};
+        if (sharedMemory && sharedMemory->valid())
+        {
+            std::clog << argv[0] << ": Attached to shared memory '" << sharedMemory->name() << " (" << sharedMemory->size() << " bytes)." << std::endl;
+
+            // Prepare the region of interest exactly like the microservice does
+            const cv::Rect region = roi & cv::Rect(0, 0, static_cast<int>(WIDTH), static_cast<int>(HEIGHT));
+            cv::Mat img(region.height, region.width, CV_8UC4);
+            cv::Mat blueMask(img.size(), CV_8UC1), yellowMask(img.size(), CV_8UC1);
+            cv::Mat lutBlueMask(img.size(), CV_8UC1), lutYellowMask(img.size(), CV_8UC1);
+
+            uint64_t frames{0}, bluePixels{0}, yellowPixels{0};
+            while ((FRAMES == 0) || (frames < FRAMES))
+            {
+                sharedMemory->wait();
+                sharedMemory->lock();
+                {
+                    cv::Mat wrapped(HEIGHT, WIDTH, CV_8UC4, sharedMemory->data());
+                    cv::GaussianBlur(wrapped(region), img, cv::Size(7, 7), 1.0);
+                }
+                sharedMemory->unlock();
+
+                hsvThreshold(img, blueRange, yellowRange, blueMask, yellowMask);
+                bluePixels += static_cast<uint64_t>(cv::countNonZero(blueMask));
+                yellowPixels += static_cast<uint64_t>(cv::countNonZero(yellowMask));
+                for (size_t i = 0; i < luts.size(); i++)
+                {
+                    luts[i]->classify(img, lutBlueMask, lutYellowMask);
+                    compare(blueMask, lutBlueMask, statistics[i].blueMissed, statistics[i].blueExtra);
+                    compare(yellowMask, lutYellowMask, statistics[i].yellowMissed, statistics[i].yellowExtra);
+                }
+                frames++;
+                if ((REPORT_EVERY != 0) && (frames % REPORT_EVERY == 0))
+                {
+                    report(frames, frames * img.total(), bluePixels, yellowPixels, luts, statistics);
+                }
+            }
+            report(frames, frames * img.total(), bluePixels, yellowPixels, luts, statistics);
+            retCode = 0;
+        }
+    }
+    return retCode;
+}
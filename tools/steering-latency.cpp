@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2022  DIT638 Group 4
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Measures the latency from the camera to the receiver of the GroundSteeringRequests that the microservice sends with --send
+
+#include "cluon-complete.hpp"
+#include "latency-histogram.hpp"
+#include "opendlv-standard-message-set.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Print the percentiles of both latencies in milliseconds and how many datagrams each receive call returned
+void report(const LatencyHistogram &sampleToSent, const LatencyHistogram &sampleToReceived, const cluon::UDPReceiver::Statistics &receiver)
+{
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "latency [ms]; count; p50; p99; p99.9; max" << std::endl;
+    const LatencyHistogram *histograms[] = {&sampleToSent, &sampleToReceived};
+    const char *names[] = {"sample-to-sent", "sample-to-received"};
+    for (size_t i = 0; i < 2; i++)
+    {
+        const LatencyHistogram &h = *histograms[i];
+        std::cout << names[i] << "; " << h.count() << "; " << static_cast<double>(h.percentile(0.5)) / 1e6 << "; " << static_cast<double>(h.percentile(0.99)) / 1e6 << "; "
+                  << static_cast<double>(h.percentile(0.999)) / 1e6 << "; " << static_cast<double>(h.max()) / 1e6 << std::endl;
+    }
+    const double perCall{(receiver.receiveCalls > 0) ? static_cast<double>(receiver.packets) / static_cast<double>(receiver.receiveCalls) : 0.0};
+    std::cout << "received " << receiver.packets << " datagrams with " << receiver.receiveCalls << " calls (" << perCall << " per call) in " << receiver.batches << " batches, " << receiver.fullBatches
+              << " of them full" << std::endl;
+    std::cout << "receive queue: " << receiver.pipeline.added << " added, " << receiver.pipeline.dropped << " dropped, " << receiver.pipeline.blocked << " times full, at most " << receiver.pipeline.peakSize
+              << " waiting" << std::endl;
+}
+
+int32_t main(int32_t argc, char **argv)
+{
+    int32_t retCode{1};
+    auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+    if (0 == commandlineArguments.count("cid"))
+    {
+        std::cerr << argv[0] << " receives the GroundSteeringRequests of the microservice and measures how old their camera frames are when they are sent and received." << std::endl;
+        std::cerr << "Usage:   " << argv[0] << " --cid=<OD4 session> [--sender-stamp=1] [--report-every=10] [--receive-batch=1 [--receive-wait-us=0]] [--receive-queue=4096] [--overflow=block|drop-oldest|drop-newest]" << std::endl;
+        std::cerr << "         --receive-batch:   receive up to this many datagrams with one recvmmsg call (Linux)" << std::endl;
+        std::cerr << "         --receive-wait-us: wait this long for a partially filled batch to fill up" << std::endl;
+        std::cerr << "         --receive-queue:   number of received datagrams that may wait to be dispatched" << std::endl;
+        std::cerr << "         --overflow:        wait until a datagram was dispatched (block, default) or drop the oldest or newest" << std::endl;
+        std::cerr << "                            datagram when the receive queue is full" << std::endl;
+        std::cerr << "Example: " << argv[0] << " --cid=253 --sender-stamp=1" << std::endl;
+    }
+    else
+    {
+        const uint32_t SENDER_STAMP{(commandlineArguments.count("sender-stamp") != 0) ? static_cast<uint32_t>(std::stoul(commandlineArguments["sender-stamp"])) : 1};
+        const int REPORT_EVERY{(commandlineArguments.count("report-every") != 0) ? std::stoi(commandlineArguments["report-every"]) : 10};
+        const uint16_t RECEIVE_BATCH{(commandlineArguments.count("receive-batch") != 0) ? static_cast<uint16_t>(std::max(1, std::stoi(commandlineArguments["receive-batch"]))) : static_cast<uint16_t>(1)};
+        const int64_t RECEIVE_WAIT{(commandlineArguments.count("receive-wait-us") != 0) ? std::stoll(commandlineArguments["receive-wait-us"]) : 0};
+        const size_t RECEIVE_QUEUE{(commandlineArguments.count("receive-queue") != 0) ? static_cast<size_t>(std::max(1, std::stoi(commandlineArguments["receive-queue"]))) : 4096};
+        const std::string OVERFLOW_POLICY{(commandlineArguments.count("overflow") != 0) ? commandlineArguments["overflow"] : "block"};
+        cluon::PipelineOverflowPolicy overflowPolicy{cluon::PipelineOverflowPolicy::BLOCK};
+        if (OVERFLOW_POLICY == "drop-oldest")
+        {
+            overflowPolicy = cluon::PipelineOverflowPolicy::DROP_OLDEST;
+        }
+        else if (OVERFLOW_POLICY == "drop-newest")
+        {
+            overflowPolicy = cluon::PipelineOverflowPolicy::DROP_NEWEST;
+        }
+        else if (OVERFLOW_POLICY != "block")
+        {
+            std::cerr << argv[0] << ": --overflow must be block, drop-oldest or drop-newest." << std::endl;
+            return retCode;
+        }
+
+        // Both histograms are only recorded into by the receiving thread of the OD4 session
+        LatencyHistogram sampleToSent;
+        LatencyHistogram sampleToReceived;
+        cluon::OD4Session od4{static_cast<uint16_t>(std::stoi(commandlineArguments["cid"])), nullptr, RECEIVE_BATCH, std::chrono::microseconds(RECEIVE_WAIT), RECEIVE_QUEUE, overflowPolicy};
+        od4.dataTrigger<opendlv::proxy::GroundSteeringRequest>(
+            [&sampleToSent, &sampleToReceived, SENDER_STAMP](const opendlv::proxy::GroundSteeringRequest &, const cluon::EnvelopeMeta &meta)
+            {
+                if (meta.senderStamp != SENDER_STAMP)
+                {
+                    return;
+                }
+                // The microservice stamps every request with the sample time of its frame
+                const int64_t sample{cluon::time::toMicroseconds(meta.sampleTimeStamp)};
+                const int64_t sent{cluon::time::toMicroseconds(meta.sent)};
+                const int64_t received{cluon::time::toMicroseconds(meta.received)};
+                sampleToSent.record((sent > sample) ? static_cast<uint64_t>(sent - sample) * 1000 : 0);
+                sampleToReceived.record((received > sample) ? static_cast<uint64_t>(received - sample) * 1000 : 0);
+            });
+
+        std::clog << argv[0] << ": Waiting for GroundSteeringRequests with senderStamp " << SENDER_STAMP << "." << std::endl;
+        int seconds{0};
+        while (od4.isRunning())
+        {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            seconds++;
+            if ((REPORT_EVERY > 0) && (seconds % REPORT_EVERY == 0))
+            {
+                report(sampleToSent, sampleToReceived, od4.receiverStatistics());
+            }
+        }
+        report(sampleToSent, sampleToReceived, od4.receiverStatistics());
+        retCode = 0;
+    }
+    return retCode;
+}